@@ -50,6 +50,7 @@
 #include "omnetpp/cexpression.h"
 #include "omnetpp/chasher.h"
 #include "omnetpp/cfingerprint.h"
+#include "omnetpp/ceventprofiler.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cfsm.h"
 #include "omnetpp/cfutureeventset.h"
@@ -71,6 +72,7 @@
 #include "omnetpp/cmodelchange.h"
 #include "omnetpp/cmodule.h"
 #include "omnetpp/ceventheap.h"
+#include "omnetpp/ctimerwheeleventheap.h"
 #include "omnetpp/cmatchexpression.h"
 #include "omnetpp/cpatternmatcher.h"
 #include "omnetpp/cnedfunction.h"
@@ -85,11 +87,13 @@
 #include "omnetpp/cownedobject.h"
 #include "omnetpp/coutvector.h"
 #include "omnetpp/cpar.h"
+#include "omnetpp/cphiloxrng.h"
 #include "omnetpp/cparimpl.h"
 #include "omnetpp/cparsimcomm.h"
 #include "omnetpp/cproperties.h"
 #include "omnetpp/cproperty.h"
 #include "omnetpp/cpsquare.h"
+#include "omnetpp/cquantilesketch.h"
 #include "omnetpp/cqueue.h"
 #include "omnetpp/cpacket.h"
 #include "omnetpp/cpacketqueue.h"
@@ -100,6 +104,7 @@
 #include "omnetpp/cresultrecorder.h"
 #include "omnetpp/crng.h"
 #include "omnetpp/cscheduler.h"
+#include "omnetpp/crealtimeioscheduler.h"
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cstatistic.h"
@@ -41,6 +41,11 @@ class opp_string;
 class SIM_API cCommBuffer : public cObject
 {
   public:
+    /**
+     * Version of the compact wire layout; see packLayoutTag().
+     */
+    static const int COMPACT_LAYOUT_VERSION = 1;
+
     /**
      * Virtual destructor
      */
@@ -211,6 +216,23 @@ class SIM_API cCommBuffer : public cObject
     virtual void pack(const SimTime *d, int size) = 0;
     //@}
 
+    /** @name Pack and unpack raw memory blocks */
+    //@{
+    /**
+     * Packs a block of memory as raw bytes, without any conversion. This is
+     * used by the compact layout of classes generated by the message compiler,
+     * which packs runs of consecutive primitive fields with a single call.
+     * The default implementation delegates to pack(const char *, int);
+     * subclasses may redefine it to provide a faster path.
+     */
+    virtual void packBytes(const void *d, int size)  {pack((const char *)d, size);}
+
+    /**
+     * Unpacks a block of memory stored by packBytes().
+     */
+    virtual void unpackBytes(void *d, int size)  {unpack((char *)d, size);}
+    //@}
+
     /** @name Unpack basic types */
     //@{
     /**
@@ -375,6 +397,20 @@ class SIM_API cCommBuffer : public cObject
      */
     bool checkFlag() {bool flag; unpack(flag); return flag;}
 
+    /**
+     * Packs a tag that identifies the compact wire layout (see packBytes())
+     * of an object of the given class and size. Used by classes generated
+     * by the message compiler.
+     */
+    void packLayoutTag(size_t objectSize)  {pack((int)(COMPACT_LAYOUT_VERSION << 24 | (objectSize & 0xffffff)));}
+
+    /**
+     * Unpacks a tag stored by packLayoutTag(), and throws an exception if
+     * it does not match the given object size or the current layout version,
+     * e.g. because the partitions were compiled for different platforms.
+     */
+    void checkLayoutTag(size_t objectSize, const char *className);
+
     /**
      * Packs an object.
      */
@@ -1076,6 +1076,14 @@ class SIM_API cComponent : public cDefaultOwner //implies noncopyable
     //@}
 };
 
+inline bool cLog::runtimeLogPredicate(const cComponent *object, LogLevel logLevel, const char *category)
+{
+    // same as defaultComponentLogPredicate(), but without the function call
+    if (componentLogPredicate == &defaultComponentLogPredicate)
+        return logLevel >= envirLogLevel && logLevel >= cLog::logLevel && logLevel >= object->getLogLevel();
+    return componentLogPredicate(object, logLevel, category);
+}
+
 }  // namespace omnetpp
 
 
@@ -37,7 +37,10 @@ class SIM_API cDefaultOwner : public cNoncopyableOwnedObject
     friend class cChannelType;
 
   private:
-    enum {FL_PERFORMFINALGC = 2};  // whether to delete owned objects in the destructor
+    enum {
+        FL_PERFORMFINALGC = 2,       // whether to delete owned objects in the destructor
+        FL_LISTOPTIONAL   = 1 << 29  // whether the owner list tracking policy applies (see cOwnedObject::setOwnerListTracking())
+    };
 
   private:
     cOwnedObject **objs; // array of owned objects
@@ -52,6 +55,7 @@ class SIM_API cDefaultOwner : public cNoncopyableOwnedObject
   private:
     void construct();
     void doInsert(cOwnedObject *obj);
+    void doRemove(cOwnedObject *obj);
     virtual void ownedObjectDeleted(cOwnedObject *obj) override;
     virtual void yieldOwnership(cOwnedObject *obj, cObject *newOwner) override;
 
@@ -63,6 +67,11 @@ class SIM_API cDefaultOwner : public cNoncopyableOwnedObject
 #endif
 
   protected:
+    // internal: allows objects to be owned without being put on the list,
+    // according to the owner list tracking policy (see cOwnedObject::setOwnerListTracking()).
+    // Temporary lists whose contents are moved with takeAllObjectsFrom() must not set it.
+    void setListOptional(bool b)  {setFlag(FL_LISTOPTIONAL,b);}
+
     /** @name Redefined cObject member functions */
     //@{
 
@@ -157,7 +166,9 @@ class SIM_API cDefaultOwner : public cNoncopyableOwnedObject
     virtual void setPerformFinalGC(bool b)  {setFlag(FL_PERFORMFINALGC,b);}
 
     /**
-     * Returns the number of elements stored.
+     * Returns the number of elements stored. Objects that are owned but not
+     * kept on the list (see cOwnedObject::setOwnerListTracking()) are not
+     * counted.
      */
     int defaultListSize() const {return numObjs;}
 
@@ -75,10 +75,12 @@ using std::endl;
 class SIM_API cEnvir
 {
     friend class evbuf;
-  public:
-    // Internal flag for express mode.
+  private:
+    // Internal flag for express mode. It is private because changes must also
+    // update cLog::envirLogLevel; see setLoggingEnabled().
     bool loggingEnabled;
 
+  public:
     // Internal flag. When set to true, the simulation kernel MAY omit calling
     // the following cEnvir methods: messageScheduled(), messageCancelled(),
     // beginSend(), messageSendDirect(), messageSendHop(), messageSendHop(),
@@ -474,6 +476,13 @@ class SIM_API cEnvir
      */
     bool isLoggingEnabled() const { return loggingEnabled; }
 
+    /**
+     * Enables or disables logging. Besides setting the flag returned by
+     * isLoggingEnabled(), it also updates the cached state used by the log
+     * statements (see cLog::envirLogLevel).
+     */
+    void setLoggingEnabled(bool enabled);
+
     /**
      * Returns true if the simulation is running under a GUI in Express mode.
      * Visualization code (e.g. inside module refreshDisplay() methods) may
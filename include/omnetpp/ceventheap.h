@@ -39,7 +39,6 @@ class SIM_API cEventHeap : public cFutureEventSet
     cEvent **heap;            // heap array  (heap[0] always empty)
     int heapLength;           // number of elements on the heap
     int heapCapacity;         // allocated size of the heap[] array
-    eventnumber_t insertCount; // counts insertions; needed because heap's insert is not stable (does not keep order)
 
     // circular buffer for events scheduled for the current simtime (quite frequent); acts as FIFO
     cEvent **cb;              // size of the circular buffer
@@ -57,10 +56,15 @@ class SIM_API cEventHeap : public cFutureEventSet
     cEvent *cbget(int k)  {return cb[(cbhead+k) & (cbsize-1)];}
     void cbgrow();
 
-    void heapInsert(cEvent *event);
     void cbInsert(cEvent *event);
     void flushCb();
 
+  protected:
+    eventnumber_t insertCount; // counts insertions; needed because heap's insert is not stable (does not keep order)
+
+    // inserts the event into the heap, bypassing the circular buffer; the caller is responsible for take() and insertOrder
+    void heapInsert(cEvent *event);
+
   public:
     // internal:
     bool getUseCb() const {return useCb;}
@@ -0,0 +1,162 @@
+//=========================================================================
+//  CEVENTPROFILER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CEVENTPROFILER_H
+#define __OMNETPP_CEVENTPROFILER_H
+
+#include <ctime>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include <map>
+#include <iostream>
+#include "cobject.h"
+#include "clifecyclelistener.h"
+
+namespace omnetpp {
+
+class cEvent;
+class cSimulation;
+
+/**
+ * @brief Measures the time spent in processing events, and attributes it to
+ * modules, NED types, message classes and message kinds.
+ *
+ * The profiler is invoked by cSimulation::executeEvent() before and after
+ * each event. The time is measured with the CPU's time stamp counter where
+ * available (a few nanoseconds per read), and with a monotonic clock
+ * otherwise; counter ticks are converted to seconds by comparing them to
+ * the wall clock time of the event loop.
+ *
+ * The profiler is enabled with the <tt>profiling=true</tt> configuration
+ * option. At the end of the run, the results can be recorded as scalars
+ * (see recordScalars()), and printed with printReport().
+ *
+ * @see cSimulation::getEventProfiler()
+ * @ingroup SimSupport
+ */
+class SIM_API cEventProfiler : public cObject, public cISimulationLifecycleListener, noncopyable
+{
+  public:
+    /**
+     * Event count and the time (in counter ticks) spent processing them.
+     */
+    struct Stats {
+        int64_t numEvents = 0;
+        uint64_t ticks = 0;
+    };
+
+  protected:
+    struct ModuleStats : Stats {
+        std::string fullPath;
+        std::string nedTypeName;
+    };
+
+    bool recordAsScalars;
+
+    std::vector<ModuleStats> moduleStats;  // indexed by module ID
+    Stats nonMessageStats;  // events that are not messages (e.g. cEndSimulationEvent)
+    std::map<const std::type_info *, Stats> classStats;
+    std::map<short, Stats> kindStats;
+
+    // the event being processed
+    int currentModuleId;
+    short currentKind;
+    const std::type_info *currentClass = nullptr;
+    uint64_t currentStartTicks;
+
+    // for converting ticks to seconds
+    uint64_t calibrationTicks;
+    int64_t calibrationNanos;
+
+    // time of the event loop (excludes pauses in interactive user interfaces)
+    bool running = false;
+    int64_t runStartNanos;
+    clock_t runStartCpu;
+    int64_t totalNanos = 0;
+    double totalCpuSeconds = 0;
+
+  protected:
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+    virtual void startMeasurement();
+    virtual void stopMeasurement();
+    double toSeconds(uint64_t ticks) const;
+    void collectModuleNames(int moduleId);
+    std::map<std::string,Stats> getNedTypeStats() const;
+    std::map<std::string,Stats> getClassStats() const;
+    void printTable(std::ostream& out, const char *title, const std::vector<std::pair<std::string,Stats>>& rows, uint64_t totalTicks, int maxRows) const;
+
+  public:
+    /**
+     * Constructor. If recordAsScalars is true, the results will be
+     * recorded as scalars before the finish() methods are called.
+     */
+    explicit cEventProfiler(bool recordAsScalars=false);
+
+    /**
+     * Returns the current value of the tick counter used for the measurements.
+     */
+    static uint64_t readTicks();
+
+    /** @name Called by cSimulation::executeEvent(). */
+    //@{
+    /**
+     * Stores the attributes of the event, and starts timing it.
+     */
+    virtual void beginEvent(cEvent *event);
+
+    /**
+     * Stops timing the current event, and adds the time to the statistics.
+     */
+    virtual void endEvent();
+    //@}
+
+    /** @name Results. */
+    //@{
+    /**
+     * Returns the total number of profiled events.
+     */
+    int64_t getNumEvents() const;
+
+    /**
+     * Returns the total time spent in processing events, in seconds.
+     */
+    double getEventTime() const;
+
+    /**
+     * Returns the statistics of the given module, or nullptr if the module
+     * has not processed any events.
+     */
+    const Stats *getModuleStats(int moduleId) const;
+
+    /**
+     * Records the results as scalars: the number of events and the time
+     * spent in them for each module (<tt>profile:numEvents</tt>,
+     * <tt>profile:time</tt>), and the same per NED type, message class
+     * and message kind for the network module.
+     */
+    virtual void recordScalars();
+
+    /**
+     * Prints a summary, and the top maxRows entries of the breakdowns by
+     * module, NED type, message class and message kind.
+     */
+    virtual void printReport(std::ostream& out, int maxRows=20) const;
+    //@}
+};
+
+}  // namespace omnetpp
+
+#endif
@@ -17,6 +17,7 @@
 #define __CFINGERPRINT_H
 
 #include <string.h>
+#include <vector>
 #include "simkerneldefs.h"
 #include "cevent.h"
 #include "cmessage.h"
@@ -44,6 +45,14 @@ class SIM_API cFingerprintCalculator : public cObject, noncopyable
      */
     virtual void initialize(const char *expectedFingerprints, cConfiguration *cfg, int index=-1) = 0;
 
+    /**
+     * Replaces the expected fingerprints, keeping the value calculated so far.
+     * The new values must select the same hash function and ingredients as
+     * the ones passed to initialize(). Used for runs forked from another run
+     * (see cmdenv-fork-runs). The default implementation throws an error.
+     */
+    virtual void setExpectedFingerprints(const char *expectedFingerprints);
+
     /** @name Updating the fingerprint value */
     //@{
     virtual void addEvent(cEvent *event) = 0;
@@ -98,6 +107,7 @@ class SIM_API cOmnetpp4xFingerprintCalculator : public cFingerprintCalculator
     virtual cOmnetpp4xFingerprintCalculator *dup() const override { return new cOmnetpp4xFingerprintCalculator(); }
     virtual std::string str() const override { return hasher->str(); }
     virtual void initialize(const char *expectedFingerprints, cConfiguration *cfg, int index=-1) override;
+    virtual void setExpectedFingerprints(const char *expectedFingerprints) override;
 
     virtual void addEvent(cEvent *event) override;
     virtual void addScalarResult(const cComponent *component, const char *name, double value) override {}
@@ -128,11 +138,20 @@ class SIM_API cOmnetpp4xFingerprintCalculator : public cFingerprintCalculator
 /**
  * @brief This class calculates the "fingerprint" of a simulation.
  *
- * The fingerprint is a 32-bit hash value calculated from various data
- * of the simulation events and simulation results. The calculator
+ * The fingerprint is a 32-bit or 64-bit hash value calculated from various
+ * data of the simulation events and simulation results. The calculator
  * can be configured to consider only certain events, modules, and
  * results using filter expressions.
  *
+ * The hash function is chosen by the expected fingerprints: those with more
+ * than 8 hex digits (e.g. "0123-4567-89ab-cdef/tplx") are computed with
+ * cHasher::XXHASH64, the others with the original 32-bit function, so that
+ * existing expected fingerprints remain valid.
+ *
+ * The event ingredients are compiled into a list of functions once, in
+ * initialize(), so addEvent() does not need to interpret the ingredients
+ * string for every event.
+ *
  * The available ingredients are:
  *  - 'e' event number
  *  - 't' simulation time
@@ -195,9 +214,24 @@ class SIM_API cSingleFingerprintCalculator : public cFingerprintCalculator
         virtual const char *getAsString(const char *attribute) const;
     };
 
+    // data of the current event, shared by the steps of addEvent()
+    struct EventInfo {
+        cEvent *event;
+        cMessage *message;
+        cPacket *packet;
+        cModule *module;
+    };
+
+    // one step of the event ingredient pipeline compiled in parseIngredients()
+    struct EventStep {
+        void (*fn)(cSingleFingerprintCalculator *self, const EventInfo& info, FingerprintIngredient ingredient);
+        FingerprintIngredient ingredient;
+    };
+
   protected:
     std::string expectedFingerprints;
     std::string ingredients;
+    std::vector<EventStep> eventSteps;
     cMatchExpression *eventMatcher;
     cMatchExpression *moduleMatcher;
     cMatchExpression *resultMatcher;
@@ -214,6 +248,8 @@ class SIM_API cSingleFingerprintCalculator : public cFingerprintCalculator
     virtual void parseEventMatcher(const char *s);
     virtual void parseModuleMatcher(const char *s);
     virtual void parseResultMatcher(const char *s);
+    virtual EventStep compileEventIngredient(FingerprintIngredient ingredient);
+    // called for the ingredients not handled by this class, i.e. those added by subclasses
     virtual bool addEventIngredient(cEvent *event, FingerprintIngredient ingredient);
     virtual void addModuleVisuals(cModule *module, bool displayStrings, bool figures);
 
@@ -224,6 +260,7 @@ class SIM_API cSingleFingerprintCalculator : public cFingerprintCalculator
     virtual cSingleFingerprintCalculator *dup() const override { return new cSingleFingerprintCalculator(); }
     virtual std::string str() const override;
     virtual void initialize(const char *expectedFingerprints, cConfiguration *cfg, int index=-1) override;
+    virtual void setExpectedFingerprints(const char *expectedFingerprints) override;
 
     virtual void addEvent(cEvent *event) override;
     virtual void addScalarResult(const cComponent *component, const char *name, double value) override;
@@ -271,6 +308,7 @@ class SIM_API cMultiFingerprintCalculator : public cFingerprintCalculator
     virtual cMultiFingerprintCalculator *dup() const override { return new cMultiFingerprintCalculator(static_cast<cFingerprintCalculator *>(prototype->dup())); }
     virtual std::string str() const override;
     virtual void initialize(const char *expectedFingerprints, cConfiguration *cfg, int index=-1) override;
+    virtual void setExpectedFingerprints(const char *expectedFingerprints) override;
 
     virtual void addEvent(cEvent *event) override;
     virtual void addScalarResult(const cComponent *component, const char *name, double value) override;
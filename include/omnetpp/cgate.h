@@ -101,7 +101,7 @@ class SIM_API cGate : public cObject, noncopyable
         cModule *owner;
         Name *name;  // pooled (points into cModule::namePool)
         int vectorSize; // gate vector size, or -1 if scalar gate; actually allocated size is capacityFor(size)
-        union Gates { cGate *gate; cGate **gatev; };
+        union Gates { cGate *gate; cGate **gatev; }; // gatev[] elements are nullptr until materialized, see cModule::materializeGate()
         Gates input;
         Gates output;
 
@@ -120,7 +120,8 @@ class SIM_API cGate : public cObject, noncopyable
         void setOutputGate(cGate *g) {ASSERT(getType()!=INPUT && !isVector()); output.gate=g; g->desc=this; g->pos=(-(1<<2))|1;}
         void setInputGate(cGate *g, int index) {ASSERT(getType()!=OUTPUT && isVector()); input.gatev[index]=g; g->desc=this; g->pos=(index<<2);}
         void setOutputGate(cGate *g, int index) {ASSERT(getType()!=INPUT && isVector()); output.gatev[index]=g; g->desc=this; g->pos=(index<<2)|1;}
-        static int capacityFor(int size) {return size<8 ? (size+1)&~1 : size<32 ? (size+3)&~3 : size<256 ? (size+15)&~15 : (size+63)&~63;}
+        static int capacityFor(int size) {return size<8 ? (size+1)&~1 : size<32 ? (size+3)&~3 : size<256 ? (size+15)&~15 : size<1024 ? (size+63)&~63 : roundUpToPowerOfTwo(size);}
+        static int roundUpToPowerOfTwo(int size) {int c=1024; while (c<size) c<<=1; return c;}
     };
 
   protected:
@@ -33,32 +33,80 @@ namespace omnetpp {
  * on a 32-bit machine and on a 64-bit machine. Longs can be either 32-bit or
  * 64-bit, so we always convert them to 64 bits. We do not try to convert
  * endianness, it would be too costly.
+ *
+ * Two hash functions are available. ROTATE_XOR is the original 32-bit
+ * function (rotate left by one bit, then xor with the next 32-bit word),
+ * which existing fingerprints were computed with. XXHASH64 is xxHash64
+ * (with seed 0) of the bytes of the added values: 32-bit and smaller
+ * integers contribute 4 bytes, 64-bit values 8 bytes, strings their
+ * bytes including the terminating zero, all in the machine's byte order.
+ * It is a 64-bit hash that is much less prone to collisions.
  */
 class SIM_API cHasher : noncopyable
 {
+  public:
+    enum Algorithm { ROTATE_XOR, XXHASH64 };
+
   private:
+    Algorithm algorithm;
     uint32_t value;
 
-    void merge(uint32_t x) {
+    // XXHASH64 state: the accumulators, the total number of bytes added,
+    // and the bytes not yet consumed by a 32-byte stripe
+    uint64_t acc[4];
+    uint64_t totalLength;
+    unsigned char buffer[32];
+    unsigned int bufferLength;
+
+    void append(const void *data, size_t length) {
+        // buffer the bytes until a 32-byte stripe is complete
+        if (bufferLength + length < 32) {
+            memcpy(buffer + bufferLength, data, length);
+            bufferLength += length;
+            totalLength += length;
+        }
+        else
+            appendStripes(data, length);
+    }
+    void appendStripes(const void *data, size_t length);
+    void resetXxHash64();
+
+    void rotateXor(uint32_t x) {
         // rotate value left by one bit, and xor with new data
         uint32_t carry = (value & 0x80000000U) >> 31;
         value = ((value<<1)|carry) ^ x;
     }
 
+    void merge(uint32_t x) {
+        if (algorithm == XXHASH64)
+            append(&x, 4);
+        else
+            rotateXor(x);
+    }
+
     void merge2(uint64_t x) {
-        merge((uint32_t)x);
-        merge((uint32_t)(x>>32));
+        if (algorithm == XXHASH64)
+            append(&x, 8);
+        else {
+            rotateXor((uint32_t)x);
+            rotateXor((uint32_t)(x>>32));
+        }
     }
 
   public:
     /**
      * Constructor.
      */
-    cHasher() {ASSERT(sizeof(uint32_t)==4); ASSERT(sizeof(double)==8); value = 0;}
+    cHasher(Algorithm algorithm=ROTATE_XOR) : algorithm(algorithm) {ASSERT(sizeof(uint32_t)==4); ASSERT(sizeof(double)==8); reset();}
+
+    /**
+     * Returns the hash function used by this object.
+     */
+    Algorithm getAlgorithm() const {return algorithm;}
 
     /** @name Updating the hash */
     //@{
-    void reset() {value = 0;}
+    void reset() {value = 0; resetXxHash64();}
     void add(const char *p, size_t length);
     void add(char d)           {merge((uint32_t)d);}
     void add(short d)          {merge((uint32_t)d);}
@@ -78,26 +126,45 @@ class SIM_API cHasher : noncopyable
     /** @name Obtaining the result */
     //@{
     /**
-     * Returns the hash value.
+     * Returns the hash value. With XXHASH64, this is the lower 32 bits
+     * of getHash64().
      */
-    uint32_t getHash() const {return value;}
+    uint32_t getHash() const {return algorithm == XXHASH64 ? (uint32_t)getHash64() : value;}
+
+    /**
+     * Returns the 64-bit hash value. With ROTATE_XOR, this is the same as getHash().
+     */
+    uint64_t getHash64() const;
 
     /**
      * Converts the given string to a numeric hash value. The object is
      * not changed. Throws an error if the string does not contain a valid
-     * hash.
+     * 32-bit hash.
      */
     uint32_t parse(const char *hash) const;
 
+    /**
+     * Like parse(), but accepts 64-bit hashes as well.
+     */
+    uint64_t parse64(const char *hash) const;
+
     /**
      * Parses the given hash string, and compares it to the stored hash.
      */
     bool equals(const char *hash) const;
 
     /**
-     * Returns the textual representation (hex string) of the stored hash.
+     * Returns the textual representation (hex string) of the stored hash,
+     * with a hyphen after every 4 digits.
      */
     std::string str() const;
+
+    /**
+     * Returns the hash function a textual hash (as produced by str()) was
+     * computed with, based on its length: hashes with more than 8 hex digits
+     * are XXHASH64 hashes.
+     */
+    static Algorithm getAlgorithmOf(const char *hash);
     //@}
 };
 
@@ -79,6 +79,9 @@ class SIM_API cLCG32 : public cRNG
 
     /** Random double on the [0,1] interval */
     virtual double doubleRandIncl1() override;
+
+    /** Fills the array with n random doubles on the [0,1) interval */
+    virtual void fillDoubles(double *dest, int n) override;
 };
 
 }  // namespace omnetpp
@@ -160,6 +160,15 @@ class SIM_API cLog
      */
     static LogLevel logLevel;
 
+    /**
+     * The log level implied by the state of the active environment: LOGLEVEL_OFF
+     * while logging is disabled (e.g. in express mode), and LOGLEVEL_TRACE
+     * otherwise. It is kept up to date by cEnvir::setLoggingEnabled() and
+     * cSimulation::setActiveSimulation(), and lets the default runtime predicates
+     * reject log statements with a single comparison at the call site.
+     */
+    static LogLevel envirLogLevel;
+
     /**
      * This predicate determines if a log statement is executed for log statements
      * that occur outside module or channel member functions. This is a customization
@@ -185,11 +194,24 @@ class SIM_API cLog
      */
     static LogLevel resolveLogLevel(const char *name);
 
+    /**
+     * Updates envirLogLevel from the logging enablement of the active environment.
+     */
+    static void updateEnvirLogLevel();
+
+    // Note: with the default predicates, the checks that reject most log statements
+    // (express mode, global log level) are done inline, without a function call.
+    // For components, the default predicate is evaluated inline in full; it is
+    // defined in ccomponent.h, as it needs cComponent::getLogLevel(). The default
+    // predicates ignore the category; it is only passed on to custom predicates.
     static inline bool runtimeLogPredicate(const void *object, LogLevel logLevel, const char *category)
-    { return noncomponentLogPredicate(object, logLevel, category); }
+    {
+        if (noncomponentLogPredicate == &defaultNoncomponentLogPredicate && (logLevel < envirLogLevel || logLevel < cLog::logLevel))
+            return false;
+        return noncomponentLogPredicate(object, logLevel, category);
+    }
 
-    static inline bool runtimeLogPredicate(const cComponent *object, LogLevel logLevel, const char *category)
-    { return componentLogPredicate(object, logLevel, category); }
+    static inline bool runtimeLogPredicate(const cComponent *object, LogLevel logLevel, const char *category);
 
     static bool defaultNoncomponentLogPredicate(const void *object, LogLevel logLevel, const char *category);
     static bool defaultComponentLogPredicate(const cComponent *object, LogLevel logLevel, const char *category);
@@ -63,11 +63,18 @@ class SIM_API cModule : public cComponent //implies noncopyable
      *     ...
      * }
      * \endcode
+     *
+     * Gates of gate vectors are created on demand (see setGateSize()), and
+     * iterating over them creates the ones that do not exist yet. If the
+     * iterator is constructed with materialize=false, those gates are skipped
+     * instead. As gates that have not been created yet are always unconnected,
+     * this is sufficient for code that is only interested in connections.
      */
     class SIM_API GateIterator
     {
       private:
         const cModule *module;
+        bool materialize;
         int descIndex;
         bool isOutput;
         int index;
@@ -79,9 +86,11 @@ class SIM_API cModule : public cComponent //implies noncopyable
 
       public:
         /**
-         * Constructor. It takes the module on which to iterate.
+         * Constructor. It takes the module on which to iterate, and whether
+         * gates of gate vectors that have not been created yet should be
+         * created (true) or skipped (false).
          */
-        GateIterator(const cModule *m)  {init(m);}
+        GateIterator(const cModule *m, bool materialize=true) : materialize(materialize) {init(m);}
 
         /**
          * Reinitializes the iterator.
@@ -367,6 +376,14 @@ class SIM_API cModule : public cComponent //implies noncopyable
     // internal: helper for setGateSize()
     void adjustGateDesc(cGate *g, cGate::Desc *newvec);
 
+    // internal: creates the gate object for a gate vector element on first access;
+    // until then, the element is represented by a nullptr in the desc's gatev[] array
+    cGate *materializeGate(cGate::Desc *desc, bool isOutput, int index) const;
+
+    // internal: returns the first gate not connected on the given side (not-yet-materialized
+    // gates count as unconnected), or nullptr; used by checkInternalConnections()
+    cGate *findUnconnectedGate(bool inside, bool skipLooseGates) const;
+
     // internal: called as part of the destructor
     void clearGates();
 
@@ -473,6 +490,12 @@ class SIM_API cModule : public cComponent //implies noncopyable
      * a "$i" or "$o" suffix: it is not possible to set different vector size
      * for the "$i" or "$o" parts of an inout gate. Changing gate vector size
      * is guaranteed NOT to change any gate IDs.
+     *
+     * Gate objects for the new vector elements are not created here, only
+     * when they are first accessed (via gate(), GateIterator, etc.).
+     * Until then, an element only takes up a pointer-sized slot, which makes
+     * large, sparsely connected gate vectors cheap. Storage for the vector is
+     * grown geometrically, so expanding it one by one (gate++) is also cheap.
      */
     virtual void setGateSize(const char *gatename, int size);
 
@@ -695,6 +718,17 @@ class SIM_API cModule : public cComponent //implies noncopyable
         return const_cast<cModule *>(this)->gateHalf(gatename, type, index);
     }
 
+    /**
+     * Returns both halves of an inout gate ("gatename$i" and "gatename$o")
+     * with a single lookup. This is more efficient than two gateHalf() calls,
+     * which matters when connecting large gate vectors (e.g. from the NED
+     * network builder). The gate name must not contain the "$i" or "$o" suffix.
+     * Throws an error if the gate does not exist or is not an inout gate.
+     * The presence of the index parameter decides whether a vector or a scalar
+     * gate will be looked for.
+     */
+    virtual void gatePair(const char *gatename, int index, cGate *&inputGate, cGate *&outputGate);
+
     /**
      * Checks if a gate exists. When invoked without index, it returns whether
      * gate "gatename" or "gatename[]" exists (no matter if the gate vector size
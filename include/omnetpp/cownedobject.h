@@ -99,6 +99,19 @@ class cPacket;
  *      data members: your class (the enclosing object) should own them --
  *      call take() from the constructor and drop() from the destructor.
  *
+ * Objects owned by a module or channel (more precisely, by a cDefaultOwner)
+ * are normally also kept on the owner's object list, which makes it possible
+ * to inspect them, to report them as undisposed when the module is deleted,
+ * and to garbage collect them. Maintaining the list costs some time on every
+ * object creation, deletion and ownership change. For short-lived objects
+ * (packets, tags, control info) in production runs, this can be turned off
+ * globally with setOwnerListTracking(false) (or the <tt>owner-list-tracking</tt>
+ * configuration option), or for individual classes by calling
+ * setOwnerListExempt(true) in their constructors. Only the list maintenance
+ * is skipped: the owner pointer is always kept up to date, so ownership
+ * violations (sending a message that is still queued or scheduled, deleting
+ * an object owned by a container, etc.) are detected just the same.
+ *
  * @ingroup SimSupport
  */
 class SIM_API cOwnedObject : public cNamedObject
@@ -109,15 +122,22 @@ class SIM_API cOwnedObject : public cNamedObject
     friend class cMessage;  // because of refcounting business
     friend class cPacket;   // because of refcounting business
 
+  private:
+    enum {FL_OWNERLISTEXEMPT = 1 << 30};  // object is never put on the object list of a cDefaultOwner
+    enum : unsigned int {NOT_LISTED = ~0u};  // value of pos for objects not on the list of their cDefaultOwner
+
   private:
     cObject *owner;    // owner pointer
-    unsigned int pos;  // used only when owner is a cDefaultOwner
+    unsigned int pos;  // used only when owner is a cDefaultOwner; NOT_LISTED if not on its list
 
   private:
     // list in which objects are accumulated if there is no simple module in context
     // (see also setDefaultOwner() and cSimulation::setContextModule())
     static cDefaultOwner *defaultOwner;
 
+    // whether cDefaultOwners maintain the list of their objects
+    static bool ownerListTracking;
+
     // global variables for statistics
     static long totalObjectCount;
     static long liveObjectCount;
@@ -132,6 +152,29 @@ class SIM_API cOwnedObject : public cNamedObject
     // internal
     static void setDefaultOwner(cDefaultOwner *list);
 
+  protected:
+    /**
+     * Create object with given name, and decide whether it is exempt from
+     * being put on the object list of the module or channel that owns it
+     * (see the class documentation and setOwnerListExempt()). Classes of
+     * frequently created, short-lived objects that subclass cOwnedObject
+     * directly should use this constructor, as it decides the exemption
+     * before the object is inserted into the list of its initial owner.
+     */
+    cOwnedObject(const char *name, bool namepooling, bool ownerListExempt);
+
+    /**
+     * Exempts this object from being put on the object list of the module
+     * or channel that owns it (see the class documentation). Classes that
+     * cannot use the cOwnedObject(const char *, bool, bool) constructor
+     * (e.g. cPacket subclasses) may call this method from their constructors,
+     * so that the exemption applies to the whole class; the object is then
+     * removed from the list it was inserted into on creation, in constant time.
+     * The flag is preserved by copying and assignment. The ownership of the
+     * object is not affected.
+     */
+    void setOwnerListExempt(bool b);
+
   public:
     /** @name Constructors, destructor, assignment. */
     //@{
@@ -201,6 +244,34 @@ class SIM_API cOwnedObject : public cNamedObject
      * (see cSimulation::getContext()).
      */
     static cDefaultOwner *getDefaultOwner();
+
+    /**
+     * Returns true if this object is exempt from being put on the object
+     * list of its owner module or channel. See setOwnerListExempt().
+     */
+    bool isOwnerListExempt() const {return flags & FL_OWNERLISTEXEMPT;}
+
+    /**
+     * Globally enables or disables maintaining the object lists of modules
+     * and channels (cDefaultOwner). When disabled, objects given to a module
+     * or channel only get their owner pointer set, and are not put on the
+     * list. This makes object creation, deletion and ownership transfer
+     * cheaper, at the cost of the following: such objects are not visible
+     * in the object list of the owner (defaultListSize(), forEachChild(),
+     * and therefore in inspectors); they are not reported as undisposed
+     * objects, nor garbage collected when their owner is deleted. (Such
+     * objects must not outlive their owner, i.e. they must be deleted or
+     * given away before the module or channel is deleted.) Objects already
+     * on a list when the setting changes are not affected.
+     * Ownership checks remain in effect in both settings. Enabled by default.
+     */
+    static void setOwnerListTracking(bool enabled) {ownerListTracking = enabled;}
+
+    /**
+     * Returns true if the object lists of modules and channels are maintained.
+     * See setOwnerListTracking().
+     */
+    static bool getOwnerListTracking() {return ownerListTracking;}
     //@}
 
     /** @name Statistics. */
@@ -68,6 +68,9 @@ class SIM_API cPacket : public cMessage
     long origPacketId;    // if >=0: this is a transmission update; this field identifies the transmission it modifies
     simtime_t remainingDuration; // if transmission update: remaining duration (otherwise it must be equal to the duration)
 
+    static long sharedEncapsulationCount; // number of times an encapsulated packet was shared instead of duplicated
+    static long unsharingCopyCount;       // number of times a shared encapsulated packet had to be duplicated
+
   private:
     void copy(const cPacket& packet);
 
@@ -252,7 +255,10 @@ class SIM_API cPacket : public cMessage
      * both (all) copies share the same packet instance. Any change done
      * to the encapsulated packet would affect other packets as well.
      * Decapsulation (and even calling getEncapsulatedPacket()) will create an
-     * own (non-shared) copy of the packet.
+     * own (non-shared) copy of the packet. The copy is shallow: it shares
+     * the packet encapsulated in it, so sharing is preserved on the levels
+     * below. Use peekEncapsulatedPacket() for read-only access, which never
+     * copies.
      */
     virtual void encapsulate(cPacket *packet);
 
@@ -270,10 +276,22 @@ class SIM_API cPacket : public cMessage
      * is no encapsulated packet.
      *
      * IMPORTANT: see notes at encapsulate() about reference counting
-     * of encapsulated packets.
+     * of encapsulated packets. If the encapsulated packet is shared with
+     * other packets, this method makes a private copy of it, so that it
+     * can be modified; prefer peekEncapsulatedPacket() if the packet is
+     * only to be read.
      */
     virtual cPacket *getEncapsulatedPacket() const;
 
+    /**
+     * Returns a read-only pointer to the encapsulated packet, or nullptr if
+     * there is no encapsulated packet. Unlike getEncapsulatedPacket(), this
+     * method never copies: the returned packet may be shared with other
+     * packets, so it must not be modified, and its owner (and therefore
+     * getFullPath()) is unspecified.
+     */
+    const cPacket *peekEncapsulatedPacket() const {return encapsulatedPacket;}
+
     /**
      * Returns true if the packet contains an encapsulated packet, and false
      * otherwise. This method is potentially more efficient than
@@ -283,6 +301,30 @@ class SIM_API cPacket : public cMessage
     virtual bool hasEncapsulatedPacket() const;
     //@}
 
+    /** @name Statistics. */
+    //@{
+    /**
+     * Returns the number of times an encapsulated packet was shared instead
+     * of being duplicated, in dup() and in the assignment operator, since
+     * the last reset.
+     */
+    static long getSharedEncapsulationCount() {return sharedEncapsulationCount;}
+
+    /**
+     * Returns the number of times a shared encapsulated packet had to be
+     * duplicated, in decapsulate() or getEncapsulatedPacket(), since the
+     * last reset. The number of copies avoided by reference counting is
+     * getSharedEncapsulationCount() minus this value.
+     */
+    static long getUnsharingCopyCount() {return unsharingCopyCount;}
+
+    /**
+     * Resets the counters used by getSharedEncapsulationCount() and
+     * getUnsharingCopyCount().
+     */
+    static void resetSharingCounters() {sharedEncapsulationCount = unsharingCopyCount = 0;}
+    //@}
+
     /** @name Transmission state */
     //@{
     /**
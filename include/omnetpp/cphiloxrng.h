@@ -0,0 +1,132 @@
+//==========================================================================
+//  CPHILOXRNG.H - part of
+//                 OMNeT++/OMNEST
+//              Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CPHILOXRNG_H
+#define __OMNETPP_CPHILOXRNG_H
+
+#include <cstdint>
+#include "simkerneldefs.h"
+#include "globals.h"
+#include "crng.h"
+#include "cconfiguration.h"
+
+namespace omnetpp {
+
+
+/**
+ * @brief Counter-based random number generator, Philox4x32-10 by
+ * John K. Salmon et al. ("Parallel Random Numbers: As Easy as 1, 2, 3",
+ * SC'11).
+ *
+ * The generator computes the nth block of four 32-bit random numbers as
+ * a keyed bijection (ten rounds of multiply-and-xor) of the 128-bit
+ * counter value n. The state therefore consists of just the key and the
+ * counter, any stream can be positioned anywhere in constant time
+ * (see skip() and seek()), and distinct keys or counter ranges yield
+ * statistically independent streams. The period of each stream is 2^66.
+ *
+ * The stream of a global RNG is determined by the seed set and the RNG
+ * index (and the partition ID with parallel simulation). This class also
+ * supports keyed streams (see initializeStream()), which allows every
+ * module and channel to draw from its own streams (see the
+ * <tt>component-rng-streams</tt> configuration option); with that, the
+ * numbers a component draws do not depend on the parallel simulation
+ * partitioning or on what other components do.
+ *
+ * The 128-bit counter is laid out as follows: words 0-1 hold the 64-bit
+ * block number, word 2 the RNG index (with the top bit set for keyed
+ * streams), and word 3 the seed set.
+ */
+class SIM_API cPhiloxRNG : public cRNG
+{
+  protected:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t output[4];
+    int outputIndex;  // index of the next number in output[]; 4 if output[] is used up
+
+  protected:
+    static void generateBlock(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+    void setUp(uint64_t key, uint32_t streamId, uint32_t seedSet);
+    uint32_t next() {
+        if (outputIndex == 4) {
+            generateBlock(counter, key, output);
+            if (++counter[0] == 0)
+                ++counter[1];
+            outputIndex = 0;
+        }
+        return output[outputIndex++];
+    }
+
+  public:
+    cPhiloxRNG();
+    virtual ~cPhiloxRNG() {}
+
+    /** Sets up the RNG. */
+    virtual void initialize(int seedSet, int rngId, int numRngs,
+                            int parsimProcId, int parsimNumPartitions,
+                            cConfiguration *cfg) override;
+
+    /** Sets up the RNG as the keyed stream streamKey. */
+    virtual void initializeStream(int seedSet, uint64_t streamKey, int rngId, cConfiguration *cfg) override;
+
+    /** Tests correctness of the RNG */
+    virtual void selfTest() override;
+
+    /** Random integer in the range [0,intRandMax()] */
+    virtual unsigned long intRand() override;
+
+    /** Maximum value that can be returned by intRand() */
+    virtual unsigned long intRandMax() override;
+
+    /** Random integer in [0,n), n < intRandMax() */
+    virtual unsigned long intRand(unsigned long n) override;
+
+    /** Random double on the [0,1) interval */
+    virtual double doubleRand() override;
+
+    /** Random double on the (0,1) interval */
+    virtual double doubleRandNonz() override;
+
+    /** Random double on the [0,1] interval */
+    virtual double doubleRandIncl1() override;
+
+    /** Fills the array with n random doubles on the [0,1) interval */
+    virtual void fillDoubles(double *dest, int n) override;
+
+    /**
+     * Jumps ahead in the stream by n 32-bit numbers, as if n numbers were
+     * drawn (each intRand()/doubleRand() call draws one number). This takes
+     * constant time, and does not change the value of getNumbersDrawn().
+     */
+    void skip(uint64_t n);
+
+    /**
+     * Positions the stream so that the next number drawn is the one with
+     * the given index, counted from the beginning of the stream.
+     */
+    void seek(uint64_t position);
+
+    /**
+     * Returns the position of the stream, i.e. the index of the next
+     * number to be drawn, counted from the beginning of the stream.
+     */
+    uint64_t getPosition() const;
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -0,0 +1,278 @@
+//==========================================================================
+//  CQUANTILESKETCH.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CQUANTILESKETCH_H
+#define __OMNETPP_CQUANTILESKETCH_H
+
+#include <vector>
+#include "cabstracthistogram.h"
+
+namespace omnetpp {
+
+
+/**
+ * @brief A mergeable quantile sketch with relative-error guarantees,
+ * based on the DDSketch algorithm ("DDSketch: A Fast and Fully-Mergeable
+ * Quantile Sketch with Relative-Error Guarantees" by Charles Masson,
+ * Jee E. Rim and Homin K. Lee).
+ *
+ * Observations are counted in logarithmically sized bins: bin k holds
+ * the values in the interval [gamma^(k-1), gamma^k), where
+ * gamma = (1+alpha)/(1-alpha), and alpha is the relative accuracy.
+ * Negative values are stored symmetrically, and values very close to zero
+ * are counted in a separate zero bin. Any quantile returned by getQuantile()
+ * is within a relative error of alpha of the true quantile value, as long as
+ * the number of bins does not exceed the configured maximum. When it would,
+ * the bins holding the values of the smallest magnitude are collapsed, so
+ * the accuracy of the high quantiles (e.g. latency tails) is preserved.
+ *
+ * Since bin boundaries only depend on alpha, sketches with the same
+ * relative accuracy can be merged without loss of accuracy, e.g. across
+ * modules or (in the result analysis tools) across simulation runs.
+ * The sketch is recorded into the scalar file as a histogram.
+ *
+ * @ingroup Statistics
+ */
+class SIM_API cQuantileSketch : public cAbstractHistogram
+{
+  protected:
+    // a contiguous range of bins with indices [offset, offset+values.size())
+    struct Store {
+        int offset = 0;
+        std::vector<double> values;
+        bool isEmpty() const {return values.empty();}
+        int getMinIndex() const {return offset;}
+        int getMaxIndex() const {return offset + (int)values.size() - 1;}
+        void add(int index, double weight, int maxBins);
+        void merge(const Store& other, int maxBins);
+        void collapse(int maxBins);
+    };
+
+    double relativeAccuracy; // alpha
+    int maxBins;  // per sign
+    double gamma;
+    double logGamma;
+    double minIndexableValue;
+
+    Store positiveBins;
+    Store negativeBins;  // indexed by the absolute value
+    double zeroBinValue = 0;
+
+    int64_t numNegInfs = 0, numPosInfs = 0;
+    double negInfSumWeights = 0, posInfSumWeights = 0;
+
+    // lazily computed histogram representation (see getBinEdge(), getBinValue())
+    mutable bool binsValid = false;
+    mutable std::vector<double> binEdges;
+    mutable std::vector<double> binValues;
+
+  private:
+    void copy(const cQuantileSketch& other);
+
+  protected:
+    int getIndex(double absValue) const;
+    double getLowerBound(int index) const;
+    double getRepresentativeValue(int index) const;
+    void collectIntoBins(double value, double weight);
+    void updateBins() const;
+
+  public:
+    /** @name Constructors, destructor, assignment. */
+    //@{
+
+    /**
+     * Copy constructor.
+     */
+    cQuantileSketch(const cQuantileSketch& r);
+
+    /**
+     * Constructor. The relative accuracy must be in the (0,1) range.
+     * The maximum number of bins applies separately to positive and
+     * negative values.
+     */
+    explicit cQuantileSketch(const char *name=nullptr, double relativeAccuracy=0.01, int maxBins=2048, bool weighted=false);
+
+    /**
+     * Assignment operator. The name member is not copied; see cNamedObject::operator=() for details.
+     */
+    cQuantileSketch& operator=(const cQuantileSketch& res);
+    //@}
+
+    /** @name Redefined cObject member functions. */
+    //@{
+
+    /**
+     * Creates and returns an exact copy of this object.
+     * See cObject for more details.
+     */
+    virtual cQuantileSketch *dup() const override  {return new cQuantileSketch(*this);}
+
+    /**
+     * Serializes the object into an MPI send buffer.
+     * Used by the simulation kernel for parallel execution.
+     * See cObject for more details.
+     */
+    virtual void parsimPack(cCommBuffer *buffer) const override;
+
+    /**
+     * Deserializes the object from an MPI receive buffer
+     * Used by the simulation kernel for parallel execution.
+     * See cObject for more details.
+     */
+    virtual void parsimUnpack(cCommBuffer *buffer) override;
+    //@}
+
+    /** @name Configuration. */
+    //@{
+
+    /**
+     * Returns the relative accuracy (alpha) of the sketch.
+     */
+    double getRelativeAccuracy() const {return relativeAccuracy;}
+
+    /**
+     * Returns the maximum number of bins for positive (and separately,
+     * for negative) values.
+     */
+    int getMaxBins() const {return maxBins;}
+    //@}
+
+    /** @name Redefined member functions from cStatistic and cAbstractHistogram. */
+    //@{
+    /**
+     * Returns true, because the sketch does not have a precollection stage.
+     */
+    virtual bool binsAlreadySetUp() const override {return true;}
+
+    /**
+     * Does nothing, because the sketch does not have a precollection stage.
+     */
+    virtual void setUpBins() override {}
+
+    /**
+     * Collects one observation.
+     */
+    virtual void collect(double value) override;
+    using cStatistic::collect;
+
+    /**
+     * Collects one observation with a given weight. Only allowed if the
+     * object was created as weighted.
+     */
+    virtual void collectWeighted(double value, double weight) override;
+    using cStatistic::collectWeighted;
+
+    /**
+     * Returns the number of histogram bins. Bins are listed in increasing
+     * order of their values; there is a bin for every bin index between the
+     * smallest and largest one, plus a bin for the values around zero if
+     * there are such values or both negative and positive values occur.
+     */
+    virtual int getNumBins() const override;
+
+    /**
+     * Returns the kth histogram bin edge.
+     */
+    virtual double getBinEdge(int k) const override;
+
+    /**
+     * Returns the number of observations (or total weight) in the kth histogram bin.
+     */
+    virtual double getBinValue(int k) const override;
+
+    /**
+     * Returns the number of observations that were negative infinity.
+     */
+    virtual int64_t getNumUnderflows() const override {return numNegInfs;}
+
+    /**
+     * Returns the number of observations that were positive infinity.
+     */
+    virtual int64_t getNumOverflows() const override {return numPosInfs;}
+
+    /**
+     * Returns the total weight of the observations that were negative infinity.
+     */
+    virtual double getUnderflowSumWeights() const override {return negInfSumWeights;}
+
+    /**
+     * Returns the total weight of the observations that were positive infinity.
+     */
+    virtual double getOverflowSumWeights() const override {return posInfSumWeights;}
+
+    /**
+     * Returns the number of observations that were negative infinity.
+     */
+    virtual int64_t getNumNegInfs() const override {return numNegInfs;}
+
+    /**
+     * Returns the number of observations that were positive infinity.
+     */
+    virtual int64_t getNumPosInfs() const override {return numPosInfs;}
+
+    /**
+     * Returns the total weight of the observations that were negative infinity.
+     */
+    virtual double getNegInfSumWeights() const override {return negInfSumWeights;}
+
+    /**
+     * Returns the total weight of the observations that were positive infinity.
+     */
+    virtual double getPosInfSumWeights() const override {return posInfSumWeights;}
+
+    /**
+     * Merges another cQuantileSketch into this one. The two sketches
+     * must have the same relative accuracy.
+     */
+    virtual void merge(const cStatistic *other) override;
+
+    /**
+     * Clears the results collected so far.
+     */
+    virtual void clear() override;
+
+    /**
+     * Writes the contents of the object into a text file.
+     */
+    virtual void saveToFile(FILE *) const override;
+
+    /**
+     * Reads the object data from a file, in the format written out by saveToFile().
+     */
+    virtual void loadFromFile(FILE *) override;
+
+    /**
+     * Adds the "relativeAccuracy" attribute, which the analysis tools need
+     * to map the recorded bins back to sketch indices.
+     */
+    virtual void getAttributesToRecord(opp_string_map& attributes) override;
+    //@}
+
+    /** @name Quantiles. */
+    //@{
+
+    /**
+     * Returns the estimated q-quantile (0 <= q <= 1) of the observations,
+     * e.g. q=0.99 for the 99th percentile. For q=0 and q=1 it returns the
+     * exact minimum and maximum. Returns NaN if there were no observations.
+     */
+    virtual double getQuantile(double q) const;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -16,6 +16,7 @@
 #ifndef __OMNETPP_CQUEUE_H
 #define __OMNETPP_CQUEUE_H
 
+#include <vector>
 #include "cownedobject.h"
 
 namespace omnetpp {
@@ -30,6 +31,16 @@ namespace omnetpp {
  * cQueue may be set up to act as a priority queue. This requires the user to
  * supply a comparison function.
  *
+ * Objects are stored in an array used as a ring buffer, so insertion and
+ * removal at either end take amortized constant time and do not allocate
+ * memory. In priority queue mode, objects that do not belong at the back
+ * are put into a binary heap, so insert() and pop() take O(log n) time.
+ * The heap is merged into the array when an operation needs the positions
+ * of the objects (get(), back(), remove(), iteration, etc.). Elements of
+ * equal priority are kept in FIFO order. insertBefore() and insertAfter()
+ * may break the ordering; after them, the insertion position is searched
+ * linearly from the back until the queue is emptied.
+ *
  * Ownership of cOwnedObjects may be controlled by invoking setTakeOwnership()
  * prior to inserting objects. Objects that cannot track their ownership
  * (cObject but not cOwnedObject) are always treated as owned. Whether an
@@ -41,14 +52,6 @@ namespace omnetpp {
  */
 class SIM_API cQueue : public cOwnedObject
 {
-  private:
-    struct QElem
-    {
-        cObject *obj; // the contained object
-        QElem *prev;  // element towards the front of the queue
-        QElem *next;  // element towards the back of the queue
-    };
-
   public:
     /**
      * @brief Base class for object comparators, used by cQueue for
@@ -77,11 +80,23 @@ class SIM_API cQueue : public cOwnedObject
 
     /**
      * @brief Walks along a cQueue.
+     *
+     * The queue may be modified while iterating: the iterator looks up the
+     * position of its current object again after each change of the queue.
+     * If the current object itself is removed, the iterator stays on it
+     * (operator* still returns it), and moves on from its former position.
      */
     class SIM_API Iterator
     {
       private:
-        QElem *p;
+        const cQueue *q;
+        int pos;            // position of the current object when the queue's changeCount was the one below
+        cObject *current;   // nullptr if the iterator has reached either end
+        unsigned int changeCount;
+
+      private:
+        void setPosition(int pos);
+        void advance(int delta);
 
       public:
         /**
@@ -94,64 +109,82 @@ class SIM_API cQueue : public cOwnedObject
         /**
          * Reinitializes the iterator object.
          */
-        void init(const cQueue& q, bool reverse=false) {p = reverse ? q.backp : q.frontp;}
+        void init(const cQueue& q, bool reverse=false);
 
         /**
          * Returns the current object.
          */
-        cObject *operator*() const {return p ? p->obj : nullptr;}
+        cObject *operator*() const {return current;}
 
         /**
          * Returns true if the iterator has reached either end of the queue.
          */
-        bool end() const {return p == nullptr;}
+        bool end() const {return current == nullptr;}
 
         /**
          * Prefix increment operator (++it). Moves the iterator to the next object
          * in the queue. It has no effect if the iterator has reached either
          * end of the queue.
          */
-        Iterator& operator++() {if (!end()) p = p->next; return *this;}
+        Iterator& operator++() {if (!end()) advance(1); return *this;}
 
         /**
          * Postfix increment operator (it++). Moves the iterator to the next object
          * in the queue, and returns the iterator's previous state. It has
          * no effect if the iterator has reached either end of the queue.
          */
-        Iterator operator++(int) {Iterator tmp(*this); if (!end()) p = p->next; return tmp;}
+        Iterator operator++(int) {Iterator tmp(*this); if (!end()) advance(1); return tmp;}
 
         /**
          * Prefix decrement operator (--it). Moves the iterator to the previous object
          * in the queue. It has no effect if the iterator has reached either
          * end of the queue.
          */
-        Iterator& operator--() {if (!end()) p = p->prev; return *this;}
+        Iterator& operator--() {if (!end()) advance(-1); return *this;}
 
         /**
          * Postfix decrement operator (it--). Moves the iterator to the previous object
          * in the queue, and returns the iterator's previous state. It has
          * no effect if the iterator has reached either end of the queue.
          */
-        Iterator operator--(int) {Iterator tmp(*this); if (!end()) p = p->prev; return tmp;}
+        Iterator operator--(int) {Iterator tmp(*this); if (!end()) advance(-1); return tmp;}
     };
 
     friend class Iterator;
 
   private:
+    struct HeapEntry {
+        cObject *obj;
+        uint64_t insertCount;  // for keeping objects of equal priority in FIFO order
+    };
+
     bool takeOwnership = true;
-    QElem *frontp = nullptr, *backp = nullptr;  // front and back pointers
-    int len = 0;  // number of items in the queue
+    cObject **elems = nullptr;  // ring buffer of the contained objects, front first
+    int capacity = 0;  // size of the elems[] array; zero or a power of two
+    int head = 0;      // index of the front element in elems[]
+    int len = 0;       // number of items in elems[]
     Comparator *comparator = nullptr; // comparison functor; nullptr for FIFO
+    bool sorted = true;  // whether the contents is known to be ordered by the comparator (allows using the heap)
+    std::vector<HeapEntry> heap; // priority mode: objects inserted after all in elems[], not yet merged into it; binary heap
+    uint64_t insertCount = 0;    // counts insertions into the heap
+    unsigned int changeCount = 0; // incremented on every change; lets iterators detect that positions may have changed
 
   private:
     void copy(const cQueue& other);
+    bool heapLess(const HeapEntry& a, const HeapEntry& b) const;
+    bool heapTopFirst() const;
+    void pushHeap(cObject *obj);
+    cObject *popHeap();
+    void mergeHeap() const;
 
   protected:
     // internal functions
-    QElem *find_qelem(cObject *obj) const;
-    void insbefore_qelem(QElem *p, cObject *obj);
-    void insafter_qelem(QElem *p, cObject *obj);
-    cObject *remove_qelem(QElem *p);
+    cObject *elementAt(int pos) const {return elems[(head + pos) & (capacity - 1)];}
+    int findPosition(cObject *obj, int hint=0) const;
+    int findInsertPosition(cObject *obj) const;
+    void insertAt(int pos, cObject *obj);
+    cObject *removeAt(int pos);
+    void grow();
 
   public:
     /** @name Constructors, destructor, assignment. */
@@ -316,8 +349,8 @@ class SIM_API cQueue : public cOwnedObject
 
     /**
      * Returns the ith element in the queue, or nullptr if i is out of range.
-     * get(0) returns the front element. This method performs linear
-     * search.
+     * get(0) returns the front element. This method takes constant time,
+     * except when objects need to be merged from the heap in priority mode.
      */
     virtual cObject *get(int i) const;
 
@@ -0,0 +1,200 @@
+//==========================================================================
+//  CREALTIMEIOSCHEDULER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CREALTIMEIOSCHEDULER_H
+#define __OMNETPP_CREALTIMEIOSCHEDULER_H
+
+#include <functional>
+#include <map>
+#include <set>
+#include <mutex>
+#include "cscheduler.h"
+#include "cstddev.h"
+
+namespace omnetpp {
+
+class cMessage;
+class cModule;
+
+/**
+ * @brief Real-time scheduler that waits for the next event and for external
+ * I/O at the same time, with absolute deadlines.
+ *
+ * On Linux, waiting is done with epoll_wait() on a timerfd that is armed
+ * with the absolute (monotonic clock) time of the next event, so the
+ * waiting is neither cut into fixed slices nor subject to the accumulating
+ * error of relative sleeps. On other POSIX systems, poll() is used.
+ * Windows is not supported.
+ *
+ * Modules (typically the interface modules of hardware-in-the-loop or
+ * emulation setups) can register event sources with the scheduler:
+ *
+ * - File descriptors (sockets, pipes, character devices, etc.) with
+ *   addFileDescriptor(). The handler is called from the simulation thread
+ *   when the descriptor becomes readable; it is expected to read the
+ *   data and insert an event into the FES, e.g. with scheduleExternalEvent().
+ * - Callbacks with addCallback(). Other threads can trigger a callback with
+ *   notify(); the callback is then invoked from the simulation thread.
+ *
+ * When the FES is empty but event sources are registered, the scheduler
+ * waits for external events instead of ending the simulation.
+ *
+ * The scheduler measures the lateness of each event, i.e. how much later
+ * than its target wall clock time it was handed to the simulation.
+ * Statistics are available via getLatenessStatistics(), and can be recorded
+ * as scalars of the network module with the
+ * <tt>realtimescheduler-record-lateness</tt> configuration option.
+ *
+ * Scaling (<tt>realtimescheduler-scaling</tt>) works like with
+ * cRealTimeScheduler.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cRealTimeIoScheduler : public cRealTimeScheduler
+{
+  public:
+    /**
+     * Handler for file descriptor event sources; it receives the file
+     * descriptor that became readable.
+     */
+    typedef std::function<void(int fd)> FileDescriptorHandler;
+
+    /**
+     * Handler for callback event sources.
+     */
+    typedef std::function<void()> Callback;
+
+  protected:
+    // configuration
+    bool recordLateness = false;
+
+    // state
+    int64_t baseTimeNs = 0;   // wall clock time belonging to simtime 0, in nanoseconds
+    std::map<int,FileDescriptorHandler> fileDescriptors;
+    std::map<int,Callback> callbacks;
+    int lastCallbackId = 0;
+    std::mutex pendingCallbacksMutex;
+    std::set<int> pendingCallbacks;  // protected by pendingCallbacksMutex
+    int wakeupFd = -1;        // eventfd (Linux) or read end of a pipe
+    int wakeupWriteFd = -1;   // write end of the pipe; same as wakeupFd on Linux
+#ifdef __linux__
+    int epollFd = -1;
+    int timerFd = -1;
+#endif
+
+    // statistics
+    cStdDev latenessStats;    // in seconds
+
+  protected:
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+    virtual void startRun() override;
+    virtual void endRun() override;
+    int64_t toNsecs(simtime_t t) const;
+    virtual int waitUntilNs(int64_t targetTimeNs);
+    virtual bool waitForSources(int64_t deadlineNs);
+    virtual bool dispatchReadyFileDescriptor(int fd);
+    virtual bool runPendingCallbacks();
+    void drainWakeupFd();
+    virtual void recordLatenessScalars();
+
+  public:
+    /**
+     * Constructor.
+     */
+    cRealTimeIoScheduler();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cRealTimeIoScheduler();
+
+    /**
+     * Returns a description that includes the lateness statistics.
+     */
+    virtual std::string str() const override;
+
+    /**
+     * Recalculates "base time" from current wall clock time.
+     */
+    virtual void executionResumed() override;
+
+    /**
+     * Waits until the wall clock time of the first event arrives, while
+     * serving the registered event sources. Returns nullptr if the wait was
+     * interrupted by the user.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /** @name Event sources. */
+    //@{
+    /**
+     * Registers a file descriptor. The handler will be called from the
+     * simulation thread whenever the file descriptor is readable. The
+     * handler must consume the available data, otherwise it will be called
+     * again immediately.
+     */
+    virtual void addFileDescriptor(int fd, FileDescriptorHandler handler);
+
+    /**
+     * Unregisters a file descriptor. Unknown file descriptors are ignored.
+     */
+    virtual void removeFileDescriptor(int fd);
+
+    /**
+     * Registers a callback, and returns an identifier that can be passed
+     * to notify() and removeCallback().
+     */
+    virtual int addCallback(Callback callback);
+
+    /**
+     * Unregisters a callback. Unknown identifiers are ignored.
+     */
+    virtual void removeCallback(int id);
+
+    /**
+     * Requests that the given callback be invoked from the simulation thread.
+     * This method is thread-safe, and wakes up the scheduler if it is waiting.
+     */
+    virtual void notify(int id);
+
+    /**
+     * Returns the simulation time that corresponds to the current wall
+     * clock time, but not earlier than the current simulation time.
+     */
+    virtual simtime_t getCurrentRealTimeAsSimTime() const;
+
+    /**
+     * Convenience method for event source handlers: schedules the message
+     * to be delivered to the given module at getCurrentRealTimeAsSimTime().
+     */
+    virtual void scheduleExternalEvent(cMessage *msg, cModule *targetModule);
+    //@}
+
+    /** @name Statistics. */
+    //@{
+    /**
+     * Returns the lateness (in seconds) of events, i.e. the difference
+     * between the wall clock time an event was handed over to the simulation,
+     * and its target wall clock time.
+     */
+    const cStdDev& getLatenessStatistics() const {return latenessStats;}
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -17,7 +17,9 @@
 #define __OMNETPP_CRNG_H
 
 #include "simkerneldefs.h"
+#include <cstdint>
 #include "cobject.h"
+#include "cexception.h"
 
 namespace omnetpp {
 
@@ -63,6 +65,19 @@ class SIM_API cRNG : public cObject
                             int parsimProcId, int parsimNumPartitions,
                             cConfiguration *cfg) = 0;
 
+    /**
+     * Called by the simulation framework to set up the RNG as an independent
+     * stream identified by streamKey, instead of as a global RNG. This is used
+     * for giving each component its own streams (see the component-rng-streams
+     * configuration option), with streamKey derived from the component's full
+     * path. Only RNG classes that can produce a large number of independent
+     * streams cheaply (e.g. counter-based ones like cPhiloxRNG) need to
+     * support it; the default implementation throws an error.
+     */
+    virtual void initializeStream(int seedSet, uint64_t streamKey, int rngId, cConfiguration *cfg) {
+        throw cRuntimeError("RNG class %s does not support per-component streams", getClassName());
+    }
+
     /**
      * Coarse test for the correctness of the RNG algorithm. It should detect
      * platform-dependent bugs (e.g. caused by different word size or compiler
@@ -111,6 +126,15 @@ class SIM_API cRNG : public cObject
      * Random double on the (0,1] interval
      */
     double doubleRandNonzIncl1() {return 1-doubleRand();}
+
+    /**
+     * Fills the array with n random doubles on the [0,1) interval. The numbers
+     * are the same as the ones n successive doubleRand() calls would return,
+     * so the two can be mixed freely without affecting the random number
+     * sequence. The default implementation calls doubleRand() in a loop;
+     * subclasses may override it with a faster bulk implementation.
+     */
+    virtual void fillDoubles(double *dest, int n) {for (int i = 0; i < n; i++) dest[i] = doubleRand();}
 };
 
 }  // namespace omnetpp
@@ -37,6 +37,7 @@ class cScheduler;
 class cParsimPartition;
 class cNedFileLoader;
 class cFingerprintCalculator;
+class cEventProfiler;
 class cModuleType;
 class cEnvir;
 class cDefaultOwner;
@@ -96,6 +97,7 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     bool trapOnNextEvent;  // when set, next handleMessage or activity() will execute debugger interrupt
 
     cFingerprintCalculator *fingerprint; // used for fingerprint calculation
+    cEventProfiler *profiler; // measures the time spent in events (optional)
 
   private:
     // internal
@@ -271,6 +273,14 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      */
     static int loadNedSourceFolder(const char *folderName, const char *exclusionPath="");
 
+    /**
+     * Enables caching of parsed NED files in the given folder. Subsequent
+     * loadNedSourceFolder() calls store the parsed and validated form of the
+     * NED files there, and reuse it (instead of parsing the file again) as
+     * long as the file content is unchanged. Pass nullptr or "" to disable.
+     */
+    static void setNedAstCacheFolder(const char *folder);
+
     /**
      * Load a single NED file. If the expected package is given (non-nullptr),
      * it should match the package declaration inside the NED file.
@@ -581,6 +591,18 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      * Installs a new fingerprint object, used for fingerprint calculation.
      */
     void setFingerprintCalculator(cFingerprintCalculator *fingerprint);
+
+    /**
+     * Returns the object that measures the time spent in processing events.
+     * It returns nullptr if profiling is not enabled for this simulation run.
+     */
+    cEventProfiler *getEventProfiler() {return profiler;}
+
+    /**
+     * Installs a new event profiler, or removes the existing one if the
+     * argument is nullptr. The old profiler object is deleted.
+     */
+    void setEventProfiler(cEventProfiler *profiler);
     //@}
 };
 
@@ -39,8 +39,6 @@ class SIM_API cStatistic : public cRandom
   protected:
     // internal: utility function for implementing loadFromFile() functions
     void freadvarsf (FILE *f,  const char *fmt, ...) _OPP_GNU_ATTRIBUTE((format(scanf, 3, 4)));
-    // internal: for collecting the attributes to record into the scalar file
-    virtual void getAttributesToRecord(opp_string_map& attributes) {}
 
   public:
     /** @name Constructors, destructor, assignment. */
@@ -257,6 +255,15 @@ class SIM_API cStatistic : public cRandom
      * object, to force it set up histogram bins before recording.
      */
     virtual void recordAs(const char *name, const char *unit=nullptr);
+
+    /**
+     * Adds the attributes that should be recorded together with the
+     * statistic into the given map, e.g. parameters that are needed to
+     * interpret the recorded data. Called by recordAs() and by result
+     * recorders before passing the statistic to cEnvir::recordStatistic().
+     * This default implementation does nothing.
+     */
+    virtual void getAttributesToRecord(opp_string_map& attributes) {}
     //@}
 };
 
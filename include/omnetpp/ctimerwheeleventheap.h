@@ -0,0 +1,159 @@
+//==========================================================================
+//  CTIMERWHEELEVENTHEAP.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTIMERWHEELEVENTHEAP_H
+#define __OMNETPP_CTIMERWHEELEVENTHEAP_H
+
+#include <vector>
+#include "ceventheap.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Future event set that keeps future events in a hierarchical timer
+ * wheel, and only moves them into the binary heap of cEventHeap when their
+ * turn is near.
+ *
+ * The time axis is divided into ticks (by default the largest power-of-two
+ * multiple of the simulation time resolution that does not exceed 1us), and
+ * the wheel has 4 levels of 256 buckets; a bucket on level L covers 256^L ticks.
+ * Events further away than 2^32 ticks, and events due in the current tick
+ * are inserted into the heap directly. When the heap contains no event that
+ * is earlier than the earliest nonempty bucket of the wheel, the bucket is
+ * cascaded down to the lower levels, and finally the events of a single tick
+ * are moved into the heap.
+ *
+ * Inserting an event into the wheel and removing it from there are O(1)
+ * operations, which makes this class suitable for models that frequently
+ * cancel and reschedule timers (e.g. retransmission timeouts) that rarely
+ * expire. The order of events is the same as with cEventHeap: the heap
+ * orders events by arrival time, scheduling priority and insertion order,
+ * and the wheel preserves the insertion order of the events it stores.
+ *
+ * The class can be selected with the <tt>futureeventset-class</tt>
+ * configuration option.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cTimerWheelEventHeap : public cEventHeap
+{
+  public:
+    enum {
+        NUM_LEVELS = 4,
+        LEVEL_BITS = 8,
+        SLOTS_PER_LEVEL = 1 << LEVEL_BITS
+    };
+
+  private:
+    typedef std::vector<cEvent *> Bucket;
+
+    int tickShift = -1;       // tick = raw simtime >> tickShift; -1 means not yet determined
+    int64_t cursor = 0;       // all events in the wheel are in this tick or later
+    int wheelLength = 0;      // number of events in the wheel
+    Bucket buckets[NUM_LEVELS][SLOTS_PER_LEVEL];
+    uint64_t nonempty[NUM_LEVELS][SLOTS_PER_LEVEL/64]; // bitmap of nonempty buckets
+
+  private:
+    void copy(const cTimerWheelEventHeap& other);
+    int64_t getTick(const cEvent *event) const {return event->getArrivalTime().raw() >> tickShift;}
+    int findNonemptyBucket(int level, int from) const;
+    bool wheelInsert(cEvent *event, int64_t tick);
+    void wheelRemove(cEvent *event);
+    void cascade(int level, int slot);
+    void advance();
+    void flushWheel();
+
+  public:
+    /** @name Constructors, destructor, assignment */
+    //@{
+
+    /**
+     * Copy constructor.
+     */
+    cTimerWheelEventHeap(const cTimerWheelEventHeap& other);
+
+    /**
+     * Constructor.
+     */
+    cTimerWheelEventHeap(const char *name=nullptr, int initialCapacity=128);
+
+    /**
+     * Destructor.
+     */
+    virtual ~cTimerWheelEventHeap();
+
+    /**
+     * Assignment operator. The name member is not copied;
+     * see cOwnedObject's operator=() for more details.
+     */
+    cTimerWheelEventHeap& operator=(const cTimerWheelEventHeap& other);
+    //@}
+
+    /** @name Redefined cObject member functions. */
+    //@{
+
+    /**
+     * Creates and returns an exact copy of this object.
+     * See cObject for more details.
+     */
+    virtual cTimerWheelEventHeap *dup() const override  {return new cTimerWheelEventHeap(*this);}
+    //@}
+
+    /** @name Configuration. */
+    //@{
+    /**
+     * Sets the length of a tick (the smallest bucket of the wheel) as
+     * 2^shift simulation time resolution units. The default is chosen
+     * on the first insertion, based on the simulation time resolution.
+     * Can only be called while the FES is empty.
+     */
+    void setTickShift(int shift);
+
+    /**
+     * Returns the length of a tick as the power of two of the simulation
+     * time resolution units, or -1 if it has not been determined yet.
+     */
+    int getTickShift() const {return tickShift;}
+    //@}
+
+    /** @name Redefined cEventHeap functions. */
+    //@{
+    virtual void insert(cEvent *event) override;
+    virtual cEvent *peekFirst() const override;
+    virtual cEvent *removeFirst() override;
+    virtual cEvent *remove(cEvent *event) override;
+    virtual bool isEmpty() const override {return wheelLength == 0 && cEventHeap::isEmpty();}
+    virtual void clear() override;
+    virtual int getLength() const override {return cEventHeap::getLength() + wheelLength;}
+    virtual cEvent *get(int k) override;
+
+    /**
+     * Moves all events from the wheel into the heap, and sorts the heap.
+     */
+    virtual void sort() override;
+    //@}
+
+    /**
+     * Returns the number of events currently stored in the wheel (as opposed
+     * to the heap).
+     */
+    int getWheelLength() const {return wheelLength;}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
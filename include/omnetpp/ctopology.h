@@ -18,6 +18,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include "cownedobject.h"
 #include "csimulation.h"
 #include "cmodule.h"
@@ -75,12 +76,13 @@ class SIM_API cTopology : public cOwnedObject
         // variables used by the shortest-path algorithms
         double dist;
         Link *outPath;
+        int index;  // position in nodes[] when the all-pairs shortest paths were calculated
 
       public:
         /**
          * Constructor
          */
-        Node(int moduleId=-1) {this->moduleId=moduleId; weight=0; enabled=true; dist=INFINITY; outPath=nullptr;}
+        Node(int moduleId=-1) {this->moduleId=moduleId; weight=0; enabled=true; dist=INFINITY; outPath=nullptr; index=-1;}
         virtual ~Node() {}
 
         /** @name Node attributes: weight, enabled state, correspondence to modules. */
@@ -336,6 +338,36 @@ class SIM_API cTopology : public cOwnedObject
   protected:
     std::vector<Node*> nodes;
     Node *target;
+    unsigned int structureVersion;  // incremented on adding/removing nodes and links
+
+    // state of the all-pairs shortest paths: a snapshot of the graph in
+    // compressed sparse row (CSR) form, and the results. Edges are numbered
+    // by source node, in the order of the source node's outLinks[].
+    struct AllPairsShortestPaths {
+        bool valid = false;
+        bool weighted = false;
+        unsigned int structureVersion = 0;
+        std::vector<Link*> edgeLinks;      // per edge: the link
+        std::vector<int> edgeSrc;          // per edge: source node index
+        std::vector<int> edgeDest;         // per edge: destination node index
+        std::vector<double> edgeCost;      // per edge: weight (1 if unweighted), INFINITY if disabled
+        std::vector<int> outStart;         // per node: first out edge; edges of node i are outStart[i]..outStart[i+1]-1
+        std::vector<int> inStart;          // per node: first element in inEdges[] for the node
+        std::vector<int> inEdges;          // edges grouped by destination node
+        std::vector<double> nodeWeight;    // per node: weight at the time of the calculation
+        std::vector<char> nodeEnabled;     // per node: enabled state at the time of the calculation
+        std::vector<double> transitCost;   // per node: cost of routing through the node, INFINITY if disabled
+        // next-hop table, row per destination: index into the outLinks[] of the source node,
+        // or all ones if none. Only the narrowest one that fits the largest out-degree is used.
+        std::vector<uint8_t> nextHop8;
+        std::vector<uint16_t> nextHop16;
+        std::vector<uint32_t> nextHop32;
+        bool distancesStored = false;
+        std::vector<double> distance;      // row per destination: distance of the source node, if distancesStored
+    };
+    AllPairsShortestPaths allPairs;
+    int maxAllPairsThreads = 0;  // 0: number of hardware threads
+    bool storeAllPairsDistances = false;
 
     // note: the purpose of the (unsigned int) cast is that nodes with moduleId==-1 are inserted at the end of the vector
     static bool lessByModuleId(Node *a, Node *b) { return (unsigned int)a->moduleId < (unsigned int)b->moduleId; }
@@ -344,6 +376,21 @@ class SIM_API cTopology : public cOwnedObject
     void unlinkFromSourceNode(Link *link);
     void unlinkFromDestNode(Link *link);
 
+    // all-pairs shortest paths
+    struct AllPairsScratch;
+    struct AllPairsChange {int edge; bool increased;};
+    double getAllPairsLinkCost(Link *link) const;
+    void buildAllPairsSnapshot(bool weighted);
+    void calculateAllPairsShortestPaths(bool weighted);
+    void forEachDestination(const std::function<void(int,AllPairsScratch&)>& f, bool allowThreads=true);
+    template<typename F> void forEachDestinationRow(const F& f, bool allowThreads=true);
+    template<typename T> void calculatePathsTo(int dest, T *nextHop, double *distance, AllPairsScratch& scratch);
+    template<typename T, typename D> void updatePathsTo(int dest, T *nextHop, D& distance, const std::vector<AllPairsChange>& changes, AllPairsScratch& scratch);
+    template<typename T, typename D> void relaxPathsTo(int dest, T *nextHop, D& distance, AllPairsScratch& scratch);
+    template<typename T> double getPathDistance(int src, int dest, const T *nextHop) const;
+    int getAllPairsNextHop(int src, int dest) const;
+    int checkAllPairsNode(Node *node, const char *method) const;
+
   public:
     /** @name Constructors, destructor, assignment */
     //@{
@@ -573,6 +620,119 @@ class SIM_API cTopology : public cOwnedObject
     virtual Node *getTargetNode() const {return target;}
     //@}
 
+    /** @name All-pairs shortest paths.
+     *
+     * These methods compute shortest paths between all pairs of nodes in one
+     * go, and store the results in next-hop tables (the index of the outgoing
+     * link to take, per source and destination node) that can be queried
+     * with getNextHop() and getDistance(). This is much more efficient than
+     * calling calculateWeightedSingleShortestPathsTo() for each destination,
+     * and then saving the results. The results are not stored in the nodes,
+     * i.e. Node::getPath() and getTargetNode() are not affected.
+     *
+     * The entries of the next-hop table take 1, 2 or 4 bytes, depending on
+     * the largest number of outgoing links of a node. Distances are not
+     * stored by default: getDistance() and updateAllPairsShortestPaths()
+     * add up the link costs along the paths in the next-hop tables as
+     * needed. setStoreAllPairsDistances(true) stores them as well (8 bytes
+     * per pair), which makes both of these faster.
+     *
+     * The calculation runs on a snapshot of the graph, and is performed on
+     * multiple threads (in parallel for different destinations) if the
+     * graph is large enough (at least 128 nodes) and the simulation library
+     * was built with thread support (THREADED defined). The number of threads
+     * can be limited with setMaxAllPairsThreads().
+     *
+     * When link weights change or links are enabled/disabled, the results
+     * can be brought up to date with updateAllPairsShortestPaths(), which only
+     * recomputes the parts of the shortest-path trees that are affected by
+     * the changes. Changes of node weights or enabled states, and adding or
+     * removing nodes or links require a full recalculation;
+     * updateAllPairsShortestPaths() detects them and recalculates everything.
+     */
+    //@{
+
+    /**
+     * Calculates the shortest paths between all pairs of nodes, where the
+     * length of a path is the number of links in it. Disabled nodes and
+     * links are not used.
+     */
+    virtual void calculateUnweightedAllPairsShortestPaths();
+
+    /**
+     * Calculates the shortest paths between all pairs of nodes, using the
+     * weights of links and nodes, in the same way as
+     * calculateWeightedSingleShortestPathsTo(): the weight of a node is the
+     * cost of routing through it. Weights must not be negative. Disabled
+     * nodes and links are not used.
+     */
+    virtual void calculateWeightedAllPairsShortestPaths();
+
+    /**
+     * Updates the results of the last calculate...AllPairsShortestPaths()
+     * call after link weights have changed, or links have been enabled or
+     * disabled. Other changes of the graph cause a full recalculation.
+     * Updates after a few link changes are done on the calling thread,
+     * as they are cheaper than starting threads.
+     */
+    virtual void updateAllPairsShortestPaths();
+
+    /**
+     * Sets the maximum number of threads the all-pairs shortest path
+     * calculations may use. 0 (the default) means the number of hardware
+     * threads, and 1 means no threads are started.
+     */
+    virtual void setMaxAllPairsThreads(int n);
+
+    /**
+     * Returns the maximum number of threads the all-pairs shortest path
+     * calculations may use; see setMaxAllPairsThreads().
+     */
+    virtual int getMaxAllPairsThreads() const {return maxAllPairsThreads;}
+
+    /**
+     * Sets whether the all-pairs shortest path calculations also store the
+     * distances of all pairs, not only the next hops. The default is false.
+     * Takes effect at the next calculate...AllPairsShortestPaths() call.
+     */
+    virtual void setStoreAllPairsDistances(bool b) {storeAllPairsDistances = b;}
+
+    /**
+     * Returns true if the all-pairs shortest path calculations store the
+     * distances of all pairs; see setStoreAllPairsDistances().
+     */
+    virtual bool getStoreAllPairsDistances() const {return storeAllPairsDistances;}
+
+    /**
+     * Returns true if all-pairs shortest paths have been calculated, and the
+     * nodes and links of the graph have not changed since then.
+     */
+    virtual bool hasAllPairsShortestPaths() const;
+
+    /**
+     * Returns the length of the shortest path from the source node to the
+     * destination node, or INFINITY if the destination is unreachable.
+     * Requires calculate...AllPairsShortestPaths() to have been called.
+     * Unless distances are stored (see setStoreAllPairsDistances()), this
+     * walks the path, so it takes time proportional to its number of hops.
+     */
+    virtual double getDistance(Node *srcNode, Node *destNode) const;
+
+    /**
+     * Returns the outgoing link of the source node on a shortest path
+     * towards the destination node, or nullptr if the destination is
+     * unreachable or it is the same as the source node. Requires
+     * calculate...AllPairsShortestPaths() to have been called.
+     */
+    virtual LinkOut *getNextHop(Node *srcNode, Node *destNode) const;
+
+    /**
+     * Like getNextHop(), but returns the index of the link among the
+     * outgoing links of the source node (see Node::getLinkOut()), or -1.
+     */
+    virtual int getNextHopIndex(Node *srcNode, Node *destNode) const;
+    //@}
+
   protected:
     /**
      * Node factory.
@@ -400,6 +400,40 @@ SIM_API int poisson(cRNG *rng, double lambda);
 
 //@}
 
+/**
+ * @ingroup RandomNumbers
+ * @defgroup RandomNumbersBulk Bulk Random Variate Generation
+ * @brief Functions that fill an array with random variates.
+ *
+ * These functions produce exactly the same numbers as calling the
+ * corresponding single-variate function n times, so they can be used
+ * interchangeably without affecting the simulation results (or the
+ * fingerprint). They are faster because the underlying uniform numbers
+ * are drawn in bulk via cRNG::fillDoubles(), and the transformation
+ * loops are free of virtual calls.
+ */
+//@{
+
+/**
+ * @brief Fills the array with n variates from the uniform distribution
+ * in the range [a,b). See uniform(cRNG*,double,double).
+ */
+SIM_API void uniform(cRNG *rng, double a, double b, double *dest, int n);
+
+/**
+ * @brief Fills the array with n variates from the exponential distribution
+ * with the given mean. See exponential(cRNG*,double).
+ */
+SIM_API void exponential(cRNG *rng, double mean, double *dest, int n);
+
+/**
+ * @brief Fills the array with n variates from the normal distribution with
+ * the given mean and standard deviation. See normal(cRNG*,double,double).
+ */
+SIM_API void normal(cRNG *rng, double mean, double stddev, double *dest, int n);
+
+//@}
+
 }  // namespace omnetpp
 
 
@@ -100,6 +100,7 @@ public:
     double rand( const double& n );         // real number in [0,n]
     double randExc();                       // real number in [0,1)
     double randExc( const double& n );      // real number in [0,n)
+    void fillExc( double *dest, int n );    // n real numbers in [0,1), same as n randExc() calls
     double randDblExc();                    // real number in (0,1)
     double randDblExc( const double& n );   // real number in (0,n)
     uint32 randInt();                       // integer in [0,2^32-1]
@@ -195,6 +196,28 @@ inline MTRand::uint32 MTRand::randInt()
     return ( s1 ^ (s1 >> 18) );
 }
 
+inline void MTRand::fillExc( double *dest, int n )
+{
+    // Same as calling randExc() n times, but the tempering loop runs over
+    // whole runs of the state vector, which allows the compiler to vectorize it
+    while( n > 0 ) {
+        if( left == 0 ) reload();
+        int count = n < left ? n : left;
+        const uint32 *p = pNext;
+        for( int i = 0; i < count; ++i ) {
+            uint32 s1 = p[i];
+            s1 ^= (s1 >> 11);
+            s1 ^= (s1 <<  7) & 0x9d2c5680UL;
+            s1 ^= (s1 << 15) & 0xefc60000UL;
+            dest[i] = double( s1 ^ (s1 >> 18) ) * (1.0/4294967296.0);
+        }
+        pNext += count;
+        left -= count;
+        dest += count;
+        n -= count;
+    }
+}
+
 inline MTRand::uint32 MTRand::randInt( const uint32& n )
 {
     // Find which bits are used in n
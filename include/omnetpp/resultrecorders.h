@@ -275,6 +275,12 @@ class SIM_API KSplitRecorder : public StatisticsRecorder
         virtual void init(cComponent *component, const char *statisticName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs) override;
 };
 
+class SIM_API QuantilesRecorder : public StatisticsRecorder
+{
+    public:
+        virtual void init(cComponent *component, const char *statisticName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs) override;
+};
+
 }  // namespace omnetpp
 
 #endif
@@ -21,6 +21,14 @@
 #include <cstring>
 #include <csignal>
 #include <algorithm>
+#include <cerrno>
+#include <set>
+#include <memory>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
 #include "common/opp_ctype.h"
 #include "common/commonutil.h"
@@ -35,6 +43,7 @@
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/ccomponenttype.h"
 #include "omnetpp/cmessage.h"
+#include "omnetpp/cpacket.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cproperties.h"
@@ -75,6 +84,10 @@ Register_PerRunConfigOptionU(CFGID_CMDENV_STATUS_FREQUENCY, "cmdenv-status-frequ
 Register_PerRunConfigOption(CFGID_CMDENV_PERFORMANCE_DISPLAY, "cmdenv-performance-display", CFG_BOOL, "true", "When `cmdenv-express-mode=true`: print detailed performance information. Turning it on results in a 3-line entry printed on each update, containing ev/sec, simsec/sec, ev/simsec, number of messages created/still present/currently scheduled in FES.")
 Register_PerRunConfigOption(CFGID_CMDENV_LOG_PREFIX, "cmdenv-log-prefix", CFG_STRING, "[%l]\t", "Specifies the format string that determines the prefix of each log line. The format string may contain format directives in the syntax `%x` (a `%` followed by a single format character).  For example `%l` stands for log level, and `%J` for source component. See the manual for the list of available format characters.");
 Register_PerRunConfigOption(CFGID_CMDENV_FAKE_GUI, "cmdenv-fake-gui", CFG_BOOL, "false", "Causes Cmdenv to lie to simulations that is a GUI (isGui()=true), and to periodically invoke refreshDisplay() during simulation execution.");
+Register_GlobalConfigOption(CFGID_CMDENV_FORK_RUNS, "cmdenv-fork-runs", CFG_BOOL, "false", "When enabled, runs that only differ in their random number seeds (typically repetitions) share the network setup and the warm-up: Cmdenv sets up the network and simulates until the fork point (see `cmdenv-fork-at`) only once, then continues each run of the group in a child process created with `fork()`, with the RNGs re-seeded and the result files reopened according to that run. The first run of each group is a plain continuation, so it is identical to a normal run; the other runs inherit the state reached at the fork point. Each run checks its own `fingerprint` against the value calculated from the start of the shared simulation, so the fingerprint of a forked run equals that of the same run simulated from the start if no random numbers are drawn until the fork point (including initialization). Runs are grouped by comparing their configuration entries other than `seed-set`, time limits, fingerprint values and file names. Not available on Windows, and cannot be combined with parallel simulation or eventlog recording.")
+Register_PerRunConfigOptionU(CFGID_CMDENV_FORK_AT, "cmdenv-fork-at", "s", nullptr, "When `cmdenv-fork-runs=true`: the simulation time at which runs of a group are forked from the shared simulation. Results must not have been recorded until this point. The default is the end of the warm-up period (`warmup-period`).")
+Register_PerRunConfigOption(CFGID_CMDENV_BINARY_LOG, "cmdenv-binary-log", CFG_BOOL, "false", "When `cmdenv-express-mode=false`: write log lines and event banners into a binary log file (see `cmdenv-binary-log-file`) instead of the standard output. Log entries are recorded in raw form, with the log prefix left unformatted, which is much faster than printing them as text. Use `opp_logtool` to format, filter or grep the file offline.");
+Register_PerRunConfigOption(CFGID_CMDENV_BINARY_LOG_FILE, "cmdenv-binary-log-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.blog", "When `cmdenv-binary-log=true`: name of the binary log file.");
 Register_PerObjectConfigOption(CFGID_CMDENV_LOGLEVEL, "cmdenv-log-level", KIND_MODULE, CFG_STRING, "TRACE", "Specifies the per-component level of detail recorded by log statements, output below the specified level is omitted. Available values are (case insensitive): `off`, `fatal`, `error`, `warn`, `info`, `detail`, `debug` or `trace`. Note that the level of detail is also controlled by the globally specified runtime log level and the `COMPILETIME_LOGLEVEL` macro that is used to completely remove log statements from the executable.")
 
 //
@@ -124,6 +137,9 @@ CmdenvOptions::CmdenvOptions()
     statusFrequencyMs = 2000;
     printPerformanceData = false;
     fakeGUI = false;
+    forkRuns = false;
+    forkAt = -1;
+    binaryLog = false;
 }
 
 Cmdenv::Cmdenv() : opt((CmdenvOptions *&)EnvirBase::opt)
@@ -139,6 +155,7 @@ Cmdenv::Cmdenv() : opt((CmdenvOptions *&)EnvirBase::opt)
 
 Cmdenv::~Cmdenv()
 {
+    delete binaryLogWriter;
 }
 
 void Cmdenv::readOptions()
@@ -152,6 +169,7 @@ void Cmdenv::readOptions()
     opt->configName = cfg->getAsString(CFGID_CMDENV_CONFIG_NAME);
     opt->runFilter = cfg->getAsString(CFGID_CMDENV_RUNS_TO_EXECUTE);
     opt->extraStack = (size_t)cfg->getAsDouble(CFGID_CMDENV_EXTRA_STACK);
+    opt->forkRuns = cfg->getAsBool(CFGID_CMDENV_FORK_RUNS);
 }
 
 void Cmdenv::readPerRunOptions()
@@ -171,6 +189,9 @@ void Cmdenv::readPerRunOptions()
     opt->outputFile = cfg->getAsFilename(CFGID_CMDENV_OUTPUT_FILE).c_str();
     opt->redirectOutput = cfg->getAsBool(CFGID_CMDENV_REDIRECT_OUTPUT);
     opt->fakeGUI = cfg->getAsBool(CFGID_CMDENV_FAKE_GUI);
+    opt->forkAt = cfg->getAsDouble(CFGID_CMDENV_FORK_AT, -1);
+    opt->binaryLog = cfg->getAsBool(CFGID_CMDENV_BINARY_LOG);
+    opt->binaryLogFile = cfg->getAsFilename(CFGID_CMDENV_BINARY_LOG_FILE).c_str();
     delete fakeGUI;
     fakeGUI = nullptr;
     if (opt->fakeGUI) {
@@ -196,8 +217,14 @@ void Cmdenv::doRun()
             opt->runFilter = args->optionValue('r');
 
         std::vector<int> runNumbers;
+        std::vector<std::vector<int>> runGroups;  // runs that share the network setup and warm-up
         try {
             runNumbers = resolveRunFilter(opt->configName.c_str(), opt->runFilter.c_str());
+            if (opt->forkRuns)
+                runGroups = groupRunsForForking(runNumbers);
+            else
+                for (int runNumber : runNumbers)
+                    runGroups.push_back(std::vector<int>(1, runNumber));
         }
         catch (std::exception& e) {
             displayException(e);
@@ -208,11 +235,14 @@ void Cmdenv::doRun()
         numRuns = (int)runNumbers.size();
         runsTried = 0;
         int numErrors = 0;
-        for (int runNumber : runNumbers) {
+        for (const std::vector<int>& runGroup : runGroups) {
+            int runNumber = runGroup[0];
             runsTried++;
             bool finishedOK = false;
             bool networkSetupDone = false;
             bool endRunRequired = false;
+            bool isForkedChild = false;
+            int numFailedForkedRuns = 0;
             try {
                 if (opt->verbose)
                     out << "\nPreparing for running configuration " << opt->configName << ", run #" << runNumber << "..." << endl;
@@ -241,6 +271,8 @@ void Cmdenv::doRun()
                     out << "Assigned runID=" << runId << endl;
                 }
 
+                startBinaryLog();
+
                 // find network
                 if (opt->networkName.empty())
                     throw cRuntimeError("No network specified (missing or empty network= configuration option)");
@@ -260,7 +292,7 @@ void Cmdenv::doRun()
                 if (opt->verbose)
                     out << "Initializing..." << endl;
 
-                loggingEnabled = !opt->expressMode;
+                setLoggingEnabled(!opt->expressMode);
 
                 prepareForRun();
 
@@ -271,22 +303,35 @@ void Cmdenv::doRun()
                 // simulate() should only throw exception if error occurred and
                 // finish() should not be called.
                 notifyLifecycleListeners(LF_ON_SIMULATION_START);
-                simulate();
-                loggingEnabled = true;
 
-                if (opt->verbose)
-                    out << "\nCalling finish() at end of Run #" << runNumber << "..." << endl;
-                getSimulation()->callFinish();
-                cLogProxy::flushLastLine();
+                // with several runs in the group, simulate until the fork point, then
+                // let child processes carry on; the parent only waits for them
+                if (runGroup.size() > 1) {
+                    runNumber = forkRunGroup(runGroup, numFailedForkedRuns);
+                    isForkedChild = runNumber != -1;
+                    if (isForkedChild)
+                        switchToForkedRun(runNumber, runGroup[0]);
+                }
 
-                checkFingerprint();
+                if (runGroup.size() == 1 || isForkedChild) {
+                    simulate();
+                    setLoggingEnabled(true);
 
-                notifyLifecycleListeners(LF_ON_SIMULATION_SUCCESS);
+                    if (opt->verbose)
+                        out << "\nCalling finish() at end of Run #" << runNumber << "..." << endl;
+                    getSimulation()->callFinish();
+                    cLogProxy::flushLastLine();
+
+                    checkFingerprint();
+                    printProfilingReport();
+
+                    notifyLifecycleListeners(LF_ON_SIMULATION_SUCCESS);
+                }
 
                 finishedOK = true;
             }
             catch (std::exception& e) {
-                loggingEnabled = true;
+                setLoggingEnabled(true);
                 stoppedWithException(e);
                 notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
                 displayException(e);
@@ -316,17 +361,34 @@ void Cmdenv::doRun()
                 }
             }
 
+            // close the binary log
+            try {
+                stopBinaryLog();
+            }
+            catch (std::exception& e) {
+                finishedOK = false;
+                displayException(e);
+            }
+
             // stop redirecting into file
             stopOutputRedirection();
 
+            // a forked run is over: report the outcome to the parent via the exit code
+            if (isForkedChild) {
+                out.flush();
+                fflush(nullptr);
+                _exit(finishedOK ? 0 : 1);
+            }
+
             if (!finishedOK)
                 numErrors++;
+            numErrors += numFailedForkedRuns;
 
             // skip further runs if signal was caught
             if (sigintReceived)
                 break;
 
-            if (!finishedOK && opt->stopBatchOnError)
+            if ((!finishedOK || numFailedForkedRuns > 0) && opt->stopBatchOnError)
                 break;
         }
 
@@ -438,7 +500,7 @@ void Cmdenv::simulate()
     catch (cTerminationException& e) {
         if (opt->expressMode)
             doStatusUpdate(speedometer);
-        loggingEnabled = true;
+        setLoggingEnabled(true);
         stopClock();
         deinstallSignalHandler();
 
@@ -449,7 +511,7 @@ void Cmdenv::simulate()
     catch (std::exception& e) {
         if (opt->expressMode)
             doStatusUpdate(speedometer);
-        loggingEnabled = true;
+        setLoggingEnabled(true);
         stopClock();
         deinstallSignalHandler();
         throw;
@@ -457,7 +519,180 @@ void Cmdenv::simulate()
     // note: C++ lacks "finally": lines below need to be manually kept in sync with catch{...} blocks above!
     if (opt->expressMode)
         doStatusUpdate(speedometer);
-    loggingEnabled = true;
+    setLoggingEnabled(true);
+    stopClock();
+    deinstallSignalHandler();
+}
+
+std::vector<std::vector<int>> Cmdenv::groupRunsForForking(const std::vector<int>& runNumbers)
+{
+    // entries that may differ among the runs of a group, as they are re-read
+    // after the fork (see switchToForkedRun())
+    static const std::set<std::string> perRunEntries = {
+        "seed-set", "fingerprint", "cpu-time-limit", "real-time-limit", "result-dir",
+        "output-vector-file", "output-scalar-file", "snapshot-file", "cmdenv-output-file"
+    };
+
+    std::vector<std::vector<int>> groups;
+    std::map<std::string,int> groupIndexByConfig;
+    for (int runNumber : runNumbers) {
+        cfg->activateConfig(opt->configName.c_str(), runNumber);
+        std::string key;
+        std::vector<const char *> keyValuePairs = cfg->getKeyValuePairs(cConfigurationEx::FILT_ALL);
+        for (size_t i = 0; i+1 < keyValuePairs.size(); i += 2) {
+            if (perRunEntries.find(keyValuePairs[i]) == perRunEntries.end())
+                key += std::string(keyValuePairs[i]) + "=" + keyValuePairs[i+1] + "\n";
+            else if (strcmp(keyValuePairs[i], "fingerprint") == 0)
+                key += "fingerprint\n";  // the fingerprint is only calculated if the first run of the group has one
+        }
+
+        auto it = groupIndexByConfig.find(key);
+        if (it != groupIndexByConfig.end())
+            groups[it->second].push_back(runNumber);
+        else {
+            groupIndexByConfig[key] = groups.size();
+            groups.push_back(std::vector<int>(1, runNumber));
+        }
+    }
+    return groups;
+}
+
+int Cmdenv::forkRunGroup(const std::vector<int>& group, int& numFailed)
+{
+#ifdef _WIN32
+    throw cRuntimeError("cmdenv-fork-runs=true is not supported on this platform");
+#else
+    if (opt->parsim)
+        throw cRuntimeError("cmdenv-fork-runs=true cannot be used with parallel simulation");
+    if (recordEventlog)
+        throw cRuntimeError("cmdenv-fork-runs=true cannot be used with eventlog recording");
+
+    simtime_t forkTime = opt->forkAt >= SIMTIME_ZERO ? opt->forkAt : opt->warmupPeriod;
+    if (opt->simtimeLimit >= SIMTIME_ZERO && forkTime > opt->simtimeLimit)
+        forkTime = opt->simtimeLimit;
+
+    if (opt->verbose)
+        out << "Simulating until t=" << forkTime << "s, then forking " << group.size() << " runs..." << endl;
+    simulateUntil(forkTime);
+
+    // child processes must not inherit unwritten output
+    cLogProxy::flushLastLine();
+    if (binaryLogWriter)
+        binaryLogWriter->flush();
+    out.flush();
+    fflush(nullptr);
+
+    // run the group one child at a time, so that their output does not get mixed
+    installSignalHandler();
+    for (int runNumber : group) {
+        if (runNumber != group[0])
+            runsTried++;
+
+        pid_t pid = fork();
+        if (pid == -1)
+            throw cRuntimeError("Cannot fork process for run #%d: %s", runNumber, strerror(errno));
+        if (pid == 0) {
+            deinstallSignalHandler();
+            return runNumber;
+        }
+
+        int status;
+        while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+            ;
+        if (WIFSIGNALED(status))
+            out << "Run #" << runNumber << " terminated by signal " << WTERMSIG(status) << endl;
+        bool finishedOK = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!finishedOK)
+            numFailed++;
+
+        if (sigintReceived || (!finishedOK && opt->stopBatchOnError))
+            break;
+    }
+    deinstallSignalHandler();
+    return -1;
+#endif
+}
+
+void Cmdenv::switchToForkedRun(int runNumber, int firstRunNumber)
+{
+    // the first run of the group continues exactly as if it had not been forked
+    if (runNumber == firstRunNumber)
+        return;
+
+    cfg->activateConfig(opt->configName.c_str(), runNumber);
+
+    const char *iterVars = cfg->getVariable(CFGVAR_ITERATIONVARS);
+    const char *runId = cfg->getVariable(CFGVAR_RUNID);
+    const char *repetition = cfg->getVariable(CFGVAR_REPETITION);
+
+    stopOutputRedirection();
+    if (!opt->verbose)
+        out << opt->configName << " run " << runNumber << ": " << iterVars << ", $repetition=" << repetition << endl; // print before redirection, like for non-forked runs
+
+    if (opt->redirectOutput) {
+        opt->outputFile = cfg->getAsFilename(CFGID_CMDENV_OUTPUT_FILE).c_str();
+        processFileName(opt->outputFile);
+        startOutputRedirection(opt->outputFile.c_str());
+    }
+
+    // the log up to the fork point stays in the binary log of the first run
+    if (binaryLogWriter) {
+        stopBinaryLog();
+        opt->binaryLogFile = cfg->getAsFilename(CFGID_CMDENV_BINARY_LOG_FILE).c_str();
+        startBinaryLog();
+    }
+
+    if (opt->verbose) {
+        out << "\nContinuing as run #" << runNumber << " (forked from run #" << firstRunNumber << " at t=" << simTime() << "s)" << endl;
+        if (iterVars && strlen(iterVars) > 0)
+            out << "Scenario: " << iterVars << ", $repetition=" << repetition << endl;
+        out << "Assigned runID=" << runId << endl;
+    }
+
+    switchToActiveRun();
+}
+
+void Cmdenv::simulateUntil(simtime_t forkTime)
+{
+    installSignalHandler();
+
+    startClock();
+    sigintReceived = false;
+
+    cSimulation *simulation = getSimulation();
+
+    try {
+        while (true) {
+            simtime_t nextTime = simulation->guessNextSimtime();
+            if (nextTime < SIMTIME_ZERO || nextTime >= forkTime)
+                break;
+
+            cEvent *event = simulation->takeNextEvent();
+            if (!event)
+                throw cTerminationException("Scheduler interrupted while waiting");
+
+            if (fakeGUI)
+                fakeGUI->beforeEvent(event);
+
+            // execute event
+            simulation->executeEvent(event);
+
+            if (fakeGUI)
+                fakeGUI->afterEvent();
+
+            cLogProxy::flushLastLine();
+
+            checkTimeLimits();
+
+            if (sigintReceived)
+                throw cTerminationException("SIGINT or SIGTERM received, exiting");
+        }
+    }
+    catch (std::exception& e) {
+        stopClock();
+        deinstallSignalHandler();
+        throw;
+    }
     stopClock();
     deinstallSignalHandler();
 }
@@ -501,7 +736,11 @@ void Cmdenv::doStatusUpdate(Speedometer& speedometer)
 
         out << "     Messages:  created: " << cMessage::getTotalMessageCount()
             << "   present: " << cMessage::getLiveMessageCount()
-            << "   in FES: " << getSimulation()->getFES()->getLength() << endl;
+            << "   in FES: " << getSimulation()->getFES()->getLength();
+        if (cPacket::getSharedEncapsulationCount() > 0)
+            out << "   encap shared: " << cPacket::getSharedEncapsulationCount()
+                << "   unshared: " << cPacket::getUnsharingCopyCount();
+        out << endl;
     }
     else {
         out << "** Event #" << getSimulation()->getEventNumber() << "   t=" << getSimulation()->getSimTime()
@@ -550,7 +789,7 @@ void Cmdenv::displayException(std::exception& ex)
 void Cmdenv::componentInitBegin(cComponent *component, int stage)
 {
     // TODO: make this an EV_INFO in the component?
-    if (!opt->expressMode && opt->printEventBanners && component->getLogLevel() != LOGLEVEL_OFF)
+    if (!opt->expressMode && opt->printEventBanners && !binaryLogWriter && component->getLogLevel() != LOGLEVEL_OFF)
         out << "Initializing " << (component->isModule() ? "module" : "channel") << " " << component->getFullPath() << ", stage " << stage << endl;
 }
 
@@ -558,6 +797,13 @@ void Cmdenv::simulationEvent(cEvent *event)
 {
     EnvirBase::simulationEvent(event);
 
+    if (binaryLogWriter && isLoggingEnabled()) {
+        cModule *module = event->isMessage() ? static_cast<cMessage *>(event)->getArrivalModule() : nullptr;
+        int moduleId = module ? getBinaryLogComponentId(module) : -1;
+        binaryLogWriter->writeEvent(getSimulation()->getEventNumber(), simTime().raw(), moduleId, event->getName(), event->getClassName());
+        return;
+    }
+
     // print event banner if necessary
     if (!opt->expressMode && opt->printEventBanners)
         if (!event->isMessage() || static_cast<cMessage *>(event)->getArrivalModule()->getLogLevel() != LOGLEVEL_OFF)
@@ -628,6 +874,15 @@ void Cmdenv::log(cLogEntry *entry)
 {
     EnvirBase::log(entry);
 
+    if (binaryLogWriter) {
+        const cObject *sourceObject = entry->sourceComponent ? nullptr : entry->sourceObject;
+        binaryLogWriter->writeEntry(entry->logLevel, entry->category,
+                getBinaryLogComponentId(getSimulation()->getContext()), getBinaryLogComponentId(entry->sourceComponent),
+                sourceObject ? sourceObject->getClassName() : nullptr, sourceObject ? sourceObject->getFullPath().c_str() : nullptr,
+                entry->sourceFile, entry->sourceLine, entry->sourceFunction, entry->text, entry->textLength);
+        return;
+    }
+
     if (!logFormatter.isBlank())
         out << logFormatter.formatPrefix(entry);
 
@@ -636,6 +891,41 @@ void Cmdenv::log(cLogEntry *entry)
         out.flush();
 }
 
+void Cmdenv::startBinaryLog()
+{
+    if (!opt->binaryLog || opt->expressMode)
+        return;
+    processFileName(opt->binaryLogFile);
+    mkPath(directoryOf(opt->binaryLogFile.c_str()).c_str());
+    if (opt->verbose)
+        out << "Writing binary log to \"" << opt->binaryLogFile << "\"..." << endl;
+    binaryLogWriter = new BinaryLogWriter();
+    binaryLogWriter->open(opt->binaryLogFile.c_str(), SimTime::getScaleExp(), opt->configName.c_str(), cfg->getVariable(CFGVAR_RUNID));
+}
+
+void Cmdenv::stopBinaryLog()
+{
+    if (binaryLogWriter) {
+        cLogProxy::flushLastLine();
+        std::unique_ptr<BinaryLogWriter> writer(binaryLogWriter);
+        binaryLogWriter = nullptr;
+        writer->close();
+    }
+}
+
+int Cmdenv::getBinaryLogComponentId(const cComponent *component)
+{
+    if (!component)
+        return -1;
+    int id = component->getId();
+    if (!binaryLogWriter->isComponentWritten(id)) {
+        cComponentType *type = component->getComponentType();
+        binaryLogWriter->writeComponent(id, component->getFullName(), component->getFullPath().c_str(), component->getClassName(),
+                type ? type->getName() : nullptr, type ? type->getFullName() : nullptr);
+    }
+    return id;
+}
+
 std::string Cmdenv::gets(const char *prompt, const char *defaultReply)
 {
     if (!opt->interactive)
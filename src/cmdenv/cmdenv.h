@@ -19,9 +19,11 @@
 #define __OMNETPP_CMDENV_CMDENV_H
 
 #include <map>
+#include <vector>
 #include "envir/envirbase.h"
 #include "envir/speedometer.h"
 #include "omnetpp/csimulation.h"
+#include "common/binarylogfile.h"
 #include "fakegui.h"
 
 namespace omnetpp {
@@ -47,6 +49,10 @@ struct CMDENV_API CmdenvOptions : public EnvirOptions
     long statusFrequencyMs; // if express mode
     bool printPerformanceData; // if express mode
     bool fakeGUI; // all modes
+    bool forkRuns;
+    simtime_t forkAt; // if forkRuns; negative means warmup-period
+    bool binaryLog; // if normal mode
+    std::string binaryLogFile;
 };
 
 /**
@@ -67,6 +73,7 @@ class CMDENV_API Cmdenv : public EnvirBase
      // logging
      bool logging = true;
      FILE *logStream;
+     common::BinaryLogWriter *binaryLogWriter = nullptr; // when cmdenv-binary-log=true
 
      FakeGUI *fakeGUI = nullptr;
 
@@ -114,8 +121,17 @@ class CMDENV_API Cmdenv : public EnvirBase
 
      void help();
      void simulate();
+     void simulateUntil(simtime_t forkTime);
+
+     std::vector<std::vector<int>> groupRunsForForking(const std::vector<int>& runNumbers);
+     int forkRunGroup(const std::vector<int>& group, int& numErrors);
+     void switchToForkedRun(int runNumber, int firstRunNumber);
      const char *progressPercentage();
 
+     void startBinaryLog();
+     void stopBinaryLog();
+     int getBinaryLogComponentId(const cComponent *component);
+
      void installSignalHandler();
      void deinstallSignalHandler();
      static void signalHandler(int signum);
@@ -0,0 +1,343 @@
+//==========================================================================
+//  BINARYLOGFILE.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <cerrno>
+#include "commonutil.h"
+#include "exception.h"
+#include "binarylogfile.h"
+
+namespace omnetpp {
+namespace common {
+
+const char BinaryLogFile::MAGIC[8] = {'O', 'P', 'P', 'B', 'L', 'O', 'G', '\n'};
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    cleanup(); // not close() because it throws
+}
+
+void BinaryLogWriter::cleanup()
+{
+    if (f) {
+        fclose(f);
+        f = nullptr;
+    }
+    buffer.clear();
+    literalIds.clear();
+    stringIds.clear();
+    componentsWritten.clear();
+}
+
+void BinaryLogWriter::open(const char *filename, int simtimeScaleExp, const char *configName, const char *runId)
+{
+    if (f)
+        throw opp_runtime_error("Binary log file '%s' already open", fname.c_str());
+    fname = filename;
+    f = fopen(filename, "wb");
+    if (!f)
+        throw opp_runtime_error("Cannot open binary log file '%s' for write: %s", filename, strerror(errno));
+
+    buffer.reserve(bufferSizeLimit + 4096);
+    buffer.insert(buffer.end(), BinaryLogFile::MAGIC, BinaryLogFile::MAGIC + sizeof(BinaryLogFile::MAGIC));
+    writeVarint(BinaryLogFile::VERSION);
+    writeSignedVarint(simtimeScaleExp);
+    writeString(configName);
+    writeString(runId);
+}
+
+void BinaryLogWriter::close()
+{
+    if (f) {
+        writeBuffer();
+        bool ok = fclose(f) == 0;
+        f = nullptr;
+        cleanup();
+        if (!ok)
+            throw opp_runtime_error("Cannot write binary log file '%s'", fname.c_str());
+    }
+}
+
+void BinaryLogWriter::flush()
+{
+    if (f) {
+        writeBuffer();
+        fflush(f);
+    }
+}
+
+void BinaryLogWriter::writeBuffer()
+{
+    if (!buffer.empty()) {
+        size_t n = fwrite(buffer.data(), 1, buffer.size(), f);
+        buffer.clear();
+        if (n == 0 || ferror(f)) {
+            cleanup();
+            throw opp_runtime_error("Cannot write binary log file '%s'", fname.c_str());
+        }
+    }
+}
+
+void BinaryLogWriter::writeVarint(uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((char)value);
+}
+
+void BinaryLogWriter::writeString(const char *s)
+{
+    writeBytes(s ? s : "", s ? strlen(s) : 0);
+}
+
+int BinaryLogWriter::internString(const char *s)
+{
+    if (!s)
+        return 0;
+    auto it = stringIds.find(s);
+    if (it != stringIds.end())
+        return it->second;
+    int id = stringIds.size() + 1;
+    stringIds[s] = id;
+    buffer.push_back(BinaryLogFile::REC_STRING);
+    writeVarint(id);
+    writeString(s);
+    return id;
+}
+
+int BinaryLogWriter::internLiteral(const char *s)
+{
+    if (!s)
+        return 0;
+    auto it = literalIds.find(s);
+    if (it != literalIds.end())
+        return it->second;
+    int id = internString(s);
+    literalIds[s] = id;
+    return id;
+}
+
+void BinaryLogWriter::writeComponent(int componentId, const char *fullName, const char *fullPath, const char *className, const char *nedTypeName, const char *nedTypeQualifiedName)
+{
+    // strings must be interned before the record starts
+    int ids[] = { internString(fullName), internString(fullPath), internString(className), internLiteral(nedTypeName), internLiteral(nedTypeQualifiedName) };
+    buffer.push_back(BinaryLogFile::REC_COMPONENT);
+    writeVarint(componentId + 1);
+    for (int id : ids)
+        writeVarint(id);
+    if (componentId >= (int)componentsWritten.size())
+        componentsWritten.resize(componentId + 1);
+    componentsWritten[componentId] = true;
+}
+
+void BinaryLogWriter::writeEvent(int64_t eventNumber, int64_t rawSimtime, int moduleId, const char *name, const char *className)
+{
+    int classNameId = internLiteral(className);
+    buffer.push_back(BinaryLogFile::REC_EVENT);
+    writeVarint(eventNumber);
+    writeSignedVarint(rawSimtime);
+    writeVarint(moduleId + 1);
+    writeString(name);
+    writeVarint(classNameId);
+    if (buffer.size() > bufferSizeLimit)
+        writeBuffer();
+}
+
+void BinaryLogWriter::writeEntry(int logLevel, const char *category, int contextComponentId, int sourceComponentId, const char *sourceClassName, const char *sourceFullPath,
+                                 const char *sourceFile, int sourceLine, const char *sourceFunction, const char *text, int textLength)
+{
+    int categoryId = internString(category);
+    int sourceClassNameId = internLiteral(sourceClassName);
+    int fileId = internLiteral(sourceFile);
+    int functionId = internLiteral(sourceFunction);
+    buffer.push_back(BinaryLogFile::REC_ENTRY);
+    buffer.push_back((char)logLevel);
+    writeVarint(categoryId);
+    writeVarint(contextComponentId + 1);
+    writeVarint(sourceComponentId + 1);
+    writeVarint(sourceClassNameId);
+    writeString(sourceFullPath);
+    writeVarint(fileId);
+    writeVarint(sourceLine);
+    writeVarint(functionId);
+    writeBytes(text, textLength);
+    if (buffer.size() > bufferSizeLimit)
+        writeBuffer();
+}
+
+//----
+
+BinaryLogReader::BinaryLogReader(const char *filename) : fname(filename)
+{
+    f = fopen(filename, "rb");
+    if (!f)
+        throw opp_runtime_error("Cannot open binary log file '%s': %s", filename, strerror(errno));
+    strings.push_back(nullptr);  // ID 0: none
+
+    char magic[sizeof(BinaryLogFile::MAGIC)];
+    for (char& c : magic)
+        c = (char)readByte();
+    if (memcmp(magic, BinaryLogFile::MAGIC, sizeof(magic)) != 0)
+        throw opp_runtime_error("'%s' is not a binary log file", filename);
+    int version = (int)readVarint();
+    if (version != BinaryLogFile::VERSION)
+        throw opp_runtime_error("Unsupported binary log file version %d in '%s'", version, filename);
+    simtimeScaleExp = (int)readSignedVarint();
+    readString(configName);
+    readString(runId);
+}
+
+BinaryLogReader::~BinaryLogReader()
+{
+    if (f)
+        fclose(f);
+    for (std::string *s : strings)
+        delete s;
+    for (Component *c : components)
+        delete c;
+}
+
+int BinaryLogReader::getNumComponents() const
+{
+    int count = 0;
+    for (Component *c : components)
+        if (c)
+            count++;
+    return count;
+}
+
+bool BinaryLogReader::fill(size_t n)
+{
+    if (buffer.size() - bufferPos >= n)
+        return true;
+    buffer.erase(buffer.begin(), buffer.begin() + bufferPos);
+    bufferPos = 0;
+    size_t oldSize = buffer.size();
+    size_t chunkSize = std::max(n, (size_t)256*1024);
+    buffer.resize(oldSize + chunkSize);
+    size_t numRead = fread(buffer.data() + oldSize, 1, chunkSize, f);
+    buffer.resize(oldSize + numRead);
+    return buffer.size() >= n;
+}
+
+int BinaryLogReader::readByte()
+{
+    if (!fill(1))
+        throw opp_runtime_error("Unexpected end of binary log file '%s'", fname.c_str());
+    return (unsigned char)buffer[bufferPos++];
+}
+
+uint64_t BinaryLogReader::readVarint()
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int b = readByte();
+        value |= (uint64_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+            return value;
+    }
+    throw opp_runtime_error("Corrupt binary log file '%s'", fname.c_str());
+}
+
+void BinaryLogReader::readString(std::string& result)
+{
+    size_t length = readVarint();
+    if (!fill(length))
+        throw opp_runtime_error("Unexpected end of binary log file '%s'", fname.c_str());
+    result.assign(buffer.data() + bufferPos, length);
+    bufferPos += length;
+}
+
+const std::string *BinaryLogReader::readStringRef()
+{
+    size_t id = readVarint();
+    if (id >= strings.size())
+        throw opp_runtime_error("Corrupt binary log file '%s': undefined string ID %d", fname.c_str(), (int)id);
+    return strings[id];
+}
+
+void BinaryLogReader::readStringRecord()
+{
+    size_t id = readVarint();
+    if (id != strings.size())
+        throw opp_runtime_error("Corrupt binary log file '%s': unexpected string ID %d", fname.c_str(), (int)id);
+    std::string *s = new std::string();
+    readString(*s);
+    strings.push_back(s);
+}
+
+void BinaryLogReader::readComponentRecord()
+{
+    int id = readId();
+    if (id < 0)
+        throw opp_runtime_error("Corrupt binary log file '%s'", fname.c_str());
+    Component *component = new Component;
+    component->fullName = readStringRef();
+    component->fullPath = readStringRef();
+    component->className = readStringRef();
+    component->nedTypeName = readStringRef();
+    component->nedTypeQualifiedName = readStringRef();
+    if (id >= (int)components.size())
+        components.resize(id + 1);
+    delete components[id];
+    components[id] = component;
+}
+
+BinaryLogReader::RecordKind BinaryLogReader::next()
+{
+    while (true) {
+        if (!fill(1))
+            return END;
+        int type = readByte();
+        switch (type) {
+            case BinaryLogFile::REC_STRING:
+                readStringRecord();
+                break;
+
+            case BinaryLogFile::REC_COMPONENT:
+                readComponentRecord();
+                break;
+
+            case BinaryLogFile::REC_EVENT:
+                event.eventNumber = readVarint();
+                event.rawSimtime = readSignedVarint();
+                event.moduleId = readId();
+                readString(event.name);
+                event.className = readStringRef();
+                return EVENT;
+
+            case BinaryLogFile::REC_ENTRY:
+                entry.logLevel = readByte();
+                entry.category = readStringRef();
+                entry.contextComponentId = readId();
+                entry.sourceComponentId = readId();
+                entry.sourceClassName = readStringRef();
+                readString(entry.sourceFullPath);
+                entry.sourceFile = readStringRef();
+                entry.sourceLine = (int)readVarint();
+                entry.sourceFunction = readStringRef();
+                readString(entry.text);
+                return ENTRY;
+
+            default:
+                throw opp_runtime_error("Corrupt binary log file '%s': unknown record type %d", fname.c_str(), type);
+        }
+    }
+}
+
+}  // namespace common
+}  // namespace omnetpp
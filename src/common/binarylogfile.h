@@ -0,0 +1,196 @@
+//==========================================================================
+//  BINARYLOGFILE.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BINARYLOGFILE_H
+#define __OMNETPP_COMMON_BINARYLOGFILE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "commondefs.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Binary log files store log entries and event banners in raw form, to be
+ * formatted offline by opp_logtool. The file starts with a header (magic,
+ * version, simtime scale exponent, config name, run ID), followed by records.
+ * Each record starts with a type byte. Integers are stored as LEB128 varints
+ * (signed ones zigzag-encoded), strings as a length followed by the bytes.
+ *
+ * Strings that repeat (log categories, source file and function names,
+ * class and NED type names) are interned: a STRING record assigns them an
+ * ID on first use, and other records refer to the ID. Components are
+ * described by a COMPONENT record before their first use. ID 0 stands for
+ * "none" in both cases.
+ */
+class COMMON_API BinaryLogFile
+{
+  public:
+    enum RecordType {
+        REC_STRING = 1,     // id, text
+        REC_COMPONENT = 2,  // id+1, fullName, fullPath, className, nedTypeName, nedTypeQualifiedName (string ids)
+        REC_EVENT = 3,      // eventNumber, raw simtime, moduleId+1, name (inline), className (string id)
+        REC_ENTRY = 4       // logLevel, category, contextComponentId+1, sourceComponentId+1, sourceClassName, sourceFullPath (inline), file, line, function (string ids), text (inline)
+    };
+
+    static const char MAGIC[8];
+    static const int VERSION = 1;
+};
+
+/**
+ * Writes binary log files. Records are collected in a memory buffer that is
+ * written out in large chunks. Errors are reported with opp_runtime_error.
+ */
+class COMMON_API BinaryLogWriter
+{
+  protected:
+    std::string fname;
+    FILE *f = nullptr;
+    std::vector<char> buffer;
+    size_t bufferSizeLimit = 256*1024;
+
+    std::unordered_map<const char *,int> literalIds;  // for string literals like __FILE__, __FUNCTION__
+    std::unordered_map<std::string,int> stringIds;
+    std::vector<bool> componentsWritten;  // indexed by component ID
+
+  protected:
+    void writeVarint(uint64_t value);
+    void writeSignedVarint(int64_t value) {writeVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));}
+    void writeBytes(const char *data, size_t length) {writeVarint(length); buffer.insert(buffer.end(), data, data+length);}
+    void writeString(const char *s);
+    void writeBuffer();
+    void cleanup();  // MUST NOT THROW
+
+  public:
+    BinaryLogWriter() {}
+    ~BinaryLogWriter();
+
+    void open(const char *filename, int simtimeScaleExp, const char *configName, const char *runId); // overwrites existing file
+    void close();
+    void flush();
+    bool isOpen() const {return f != nullptr;}
+    const char *getFileName() const {return fname.c_str();}
+
+    /**
+     * Returns the ID of the given string (0 for nullptr), writing a STRING
+     * record if it occurs for the first time.
+     */
+    int internString(const char *s);
+
+    /**
+     * Same as internString(), but strings are looked up by their address.
+     * Only for string literals like __FILE__ and __FUNCTION__.
+     */
+    int internLiteral(const char *s);
+
+    bool isComponentWritten(int componentId) const {return componentId >= 0 && componentId < (int)componentsWritten.size() && componentsWritten[componentId];}
+    void writeComponent(int componentId, const char *fullName, const char *fullPath, const char *className, const char *nedTypeName, const char *nedTypeQualifiedName);
+    void writeEvent(int64_t eventNumber, int64_t rawSimtime, int moduleId, const char *name, const char *className);
+    void writeEntry(int logLevel, const char *category, int contextComponentId, int sourceComponentId, const char *sourceClassName, const char *sourceFullPath,
+                    const char *sourceFile, int sourceLine, const char *sourceFunction, const char *text, int textLength);
+};
+
+/**
+ * Reads binary log files written by BinaryLogWriter. STRING and COMPONENT
+ * records are processed internally; next() returns events and log entries.
+ */
+class COMMON_API BinaryLogReader
+{
+  public:
+    enum RecordKind { END, EVENT, ENTRY };
+
+    struct Component {
+        const std::string *fullName;
+        const std::string *fullPath;
+        const std::string *className;
+        const std::string *nedTypeName;
+        const std::string *nedTypeQualifiedName;
+    };
+
+    struct Event {
+        int64_t eventNumber = 0;
+        int64_t rawSimtime = 0;
+        int moduleId = -1;
+        std::string name;
+        const std::string *className = nullptr;
+    };
+
+    struct Entry {
+        int logLevel;
+        const std::string *category;
+        int contextComponentId;
+        int sourceComponentId;
+        const std::string *sourceClassName;
+        std::string sourceFullPath;
+        const std::string *sourceFile;
+        int sourceLine;
+        const std::string *sourceFunction;
+        std::string text;
+    };
+
+  protected:
+    std::string fname;
+    FILE *f = nullptr;
+    std::vector<char> buffer;
+    size_t bufferPos = 0;
+    bool eof = false;
+
+    int simtimeScaleExp = -12;
+    std::string configName;
+    std::string runId;
+
+    std::vector<std::string *> strings;  // indexed by string ID
+    std::vector<Component *> components;  // indexed by component ID
+    Event event;  // the current (last) event
+    Entry entry;  // the last entry
+
+  protected:
+    bool fill(size_t n);
+    int readByte();
+    uint64_t readVarint();
+    int64_t readSignedVarint() {uint64_t v = readVarint(); return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);}
+    int readId() {return (int)readVarint() - 1;}
+    void readString(std::string& result);
+    const std::string *readStringRef();
+    void readStringRecord();
+    void readComponentRecord();
+
+  public:
+    BinaryLogReader(const char *filename);
+    ~BinaryLogReader();
+
+    int getSimtimeScaleExp() const {return simtimeScaleExp;}
+    const std::string& getConfigName() const {return configName;}
+    const std::string& getRunId() const {return runId;}
+    int getNumStrings() const {return strings.size();}
+    int getNumComponents() const;
+
+    /**
+     * Reads the next event or log entry. Log entries belong to the event
+     * last returned (or precede the first event, e.g. during initialization).
+     */
+    RecordKind next();
+    const Event& getEvent() const {return event;}
+    const Entry& getEntry() const {return entry;}
+    const Component *getComponent(int id) const {return id >= 0 && id < (int)components.size() ? components[id] : nullptr;}
+};
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
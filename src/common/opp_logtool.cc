@@ -0,0 +1,506 @@
+//=========================================================================
+//  OPP_LOGTOOL.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <regex>
+#include <algorithm>
+#include "common/ver.h"
+#include "common/exception.h"
+#include "common/stringutil.h"
+#include "common/patternmatcher.h"
+#include "common/formattedprinter.h"
+#include "common/binarylogfile.h"
+
+using namespace std;
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace common {
+
+static const char *LOGLEVEL_NAMES[] = { "TRACE", "DEBUG", "DETAIL", "INFO", "WARN", "ERROR", "FATAL", "OFF" };  // must agree with the LogLevel enum
+
+static const char *getLogLevelName(int logLevel)
+{
+    return logLevel >= 0 && logLevel < 8 ? LOGLEVEL_NAMES[logLevel] : "?";
+}
+
+static int resolveLogLevel(const char *name)
+{
+    for (int i = 0; i < 8; i++)
+        if (strcasecmp(name, LOGLEVEL_NAMES[i]) == 0)
+            return i;
+    throw opp_runtime_error("Unknown log level name '%s'", name);
+}
+
+/**
+ * Formats log prefixes from binary log records. Accepts the same format
+ * strings as the cmdenv-log-prefix option; directives whose data is not
+ * recorded in the file (e.g. %g, %p, %w, %H) produce empty output.
+ */
+class LogPrefixFormatter
+{
+  private:
+    enum { CONSTANT_TEXT, PADDING, ADAPTIVE_TAB = '|', TRIM = '<', INDENT = '>' };
+    struct FormatPart {
+        int directive;
+        int padding;
+        std::string text;
+        bool conditional;
+    };
+    std::vector<FormatPart> formatParts;
+    std::vector<int> adaptiveTabColumns;
+
+    const BinaryLogReader& reader;
+    std::string configName;
+    std::string runNumber;
+
+  public:
+    LogPrefixFormatter(const char *format, const BinaryLogReader& reader);
+    bool isBlank() const {return formatParts.empty();}
+    std::string formatPrefix(const BinaryLogReader::Entry& entry);
+
+  private:
+    void addPart(int directive, const char *textBegin, const char *textEnd, bool conditional);
+    bool printComponent(std::ostream& out, int componentId, char what);
+    std::string formatSimtime(int64_t t);
+};
+
+LogPrefixFormatter::LogPrefixFormatter(const char *format, const BinaryLogReader& reader) : reader(reader)
+{
+    const char *current = format;
+    const char *previous = current;
+    bool conditional = false;
+    while (true) {
+        char ch = *current;
+        if (ch == '\0') {
+            if (previous != current)
+                addPart(CONSTANT_TEXT, previous, current, conditional);
+            break;
+        }
+        else if (ch == '%') {
+            if (previous != current) {
+                addPart(CONSTANT_TEXT, previous, current, conditional);
+                conditional = false;
+            }
+            previous = current;
+            current++;
+            ch = *current;
+            if (ch == '%')
+                addPart(CONSTANT_TEXT, previous, current, conditional);
+            else if (ch == '?') {
+                conditional = true;
+                previous = current + 1;
+                current++;
+                continue;
+            }
+            else if ('0' <= ch && ch <= '9') {
+                char *tail;
+                int padding = strtol(current, &tail, 10);
+                addPart(PADDING, nullptr, nullptr, conditional);
+                formatParts.back().padding = padding;
+                current = tail - 1;
+            }
+            else if (ch == '|') {
+                addPart(ADAPTIVE_TAB, nullptr, nullptr, conditional);
+                adaptiveTabColumns.push_back(0);
+            }
+            else if (ch != '\0' && strchr("<>lcetgvanmosqNMOSQGRXYZpbdzuxyfiwWHIEUCKJL", ch))
+                addPart(ch, nullptr, nullptr, conditional);
+            else
+                throw opp_runtime_error("Unknown log format character '%c'", ch);
+            conditional = false;
+            previous = current + 1;
+        }
+        current++;
+    }
+
+    // run number is the part of the run ID after the config name
+    configName = reader.getConfigName();
+    const std::string& runId = reader.getRunId();
+    if (opp_stringbeginswith(runId.c_str(), (configName + "-").c_str())) {
+        std::string rest = runId.substr(configName.size() + 1);
+        runNumber = rest.substr(0, rest.find('-'));
+    }
+}
+
+void LogPrefixFormatter::addPart(int directive, const char *textBegin, const char *textEnd, bool conditional)
+{
+    FormatPart part;
+    part.directive = directive;
+    part.padding = 0;
+    part.conditional = conditional;
+    if (textBegin && textEnd)
+        part.text = std::string(textBegin, textEnd - textBegin);
+    formatParts.push_back(part);
+}
+
+std::string LogPrefixFormatter::formatSimtime(int64_t t)
+{
+    char buf[64];
+    char *endp;
+    return opp_ttoa(buf, t, reader.getSimtimeScaleExp(), endp);
+}
+
+bool LogPrefixFormatter::printComponent(std::ostream& out, int componentId, char what)
+{
+    const BinaryLogReader::Component *component = reader.getComponent(componentId);
+    if (!component)
+        return false;
+    switch (what) {
+        case 'N': out << *component->fullName; break;
+        case 'M': out << *component->fullPath; break;
+        case 'O': out << *component->className; break;
+        case 'S': if (component->nedTypeName) out << *component->nedTypeName; break;
+        case 'Q': if (component->nedTypeQualifiedName) out << *component->nedTypeQualifiedName; break;
+        case 'C': out << "(" << (component->nedTypeName ? *component->nedTypeName : *component->className) << ")" << *component->fullPath; break;
+    }
+    return true;
+}
+
+std::string LogPrefixFormatter::formatPrefix(const BinaryLogReader::Entry& entry)
+{
+    const BinaryLogReader::Event& event = reader.getEvent();
+    bool lastPartEmpty = true;
+    std::stringstream stream;
+    int adaptiveTabIndex = 0;
+    for (auto& part : formatParts) {
+        if (part.directive == CONSTANT_TEXT && (!part.conditional || !lastPartEmpty))
+            stream << part.text;
+        lastPartEmpty = false;
+        switch (part.directive) {
+            case CONSTANT_TEXT:
+                break;
+
+            case PADDING: {
+                int count = part.padding - stream.str().size();
+                if (count > 0)
+                    stream << std::string(count, ' ');
+                break;
+            }
+
+            case ADAPTIVE_TAB: {
+                int col = stream.str().size();
+                int& tabCol = adaptiveTabColumns[adaptiveTabIndex++];
+                if (tabCol <= col)
+                    tabCol = col;
+                else
+                    stream << std::string(tabCol - col, ' ');
+                break;
+            }
+
+            case TRIM: {
+                while (true) {
+                    stream.seekg(stream.tellp()-(std::fpos<int>)1L, stream.beg);
+                    if (stream.peek() != ' ')
+                        break;
+                    stream.seekp(-1, stream.cur);
+                }
+                break;
+            }
+
+            case 'l': stream << getLogLevelName(entry.logLevel); break;
+            case 'c': if (entry.category) stream << *entry.category; else lastPartEmpty = true; break;
+            case 'e': stream << event.eventNumber; break;
+            case 't': stream << formatSimtime(event.rawSimtime); break;
+            case 'v': if (event.className) stream << event.name; else lastPartEmpty = true; break;
+            case 'a': if (event.className) stream << *event.className; else lastPartEmpty = true; break;
+            case 'E': if (event.className) stream << "(" << *event.className << ")" << event.name; else lastPartEmpty = true; break;
+
+            case 'n': lastPartEmpty = !printComponent(stream, event.moduleId, 'N'); break;
+            case 'm': lastPartEmpty = !printComponent(stream, event.moduleId, 'M'); break;
+            case 'o': lastPartEmpty = !printComponent(stream, event.moduleId, 'O'); break;
+            case 's': lastPartEmpty = !printComponent(stream, event.moduleId, 'S'); break;
+            case 'q': lastPartEmpty = !printComponent(stream, event.moduleId, 'Q'); break;
+            case 'U': lastPartEmpty = !printComponent(stream, event.moduleId, 'C'); break;
+
+            case 'N': case 'M': case 'O': case 'S': case 'Q': case 'C':
+                lastPartEmpty = !printComponent(stream, entry.contextComponentId, part.directive);
+                break;
+
+            case 'K':
+                if (entry.contextComponentId == event.moduleId)
+                    lastPartEmpty = true;
+                else
+                    lastPartEmpty = !printComponent(stream, entry.contextComponentId, 'C');
+                break;
+
+            case 'x': lastPartEmpty = !printComponent(stream, entry.sourceComponentId, 'S'); break;
+            case 'y': lastPartEmpty = !printComponent(stream, entry.sourceComponentId, 'Q'); break;
+
+            case 'L':
+                if (entry.sourceComponentId == entry.contextComponentId) {
+                    lastPartEmpty = true;
+                    break;
+                }
+                // no break
+            case 'J':
+                if (entry.sourceComponentId != -1)
+                    printComponent(stream, entry.sourceComponentId, 'C');
+                else if (entry.sourceClassName)
+                    stream << "(" << *entry.sourceClassName << ")" << entry.sourceFullPath;
+                else
+                    lastPartEmpty = true;
+                break;
+
+            case 'd': if (entry.sourceClassName) stream << entry.sourceFullPath; else lastPartEmpty = true; break;
+            case 'z': if (entry.sourceClassName) stream << *entry.sourceClassName; else lastPartEmpty = true; break;
+            case 'f': if (entry.sourceFile) stream << *entry.sourceFile; break;
+            case 'i': stream << entry.sourceLine; break;
+            case 'u': if (entry.sourceFunction) stream << *entry.sourceFunction; break;
+            case 'G': stream << configName; break;
+            case 'R': stream << runNumber; break;
+
+            default:  // not recorded in the file
+                lastPartEmpty = true;
+                break;
+        }
+    }
+    return stream.str().substr(0, stream.tellp());
+}
+
+//----
+
+class LogTool
+{
+  private:
+    void printHelpPage(const std::string& page);
+    void printCommand(int argc, char **argv);
+    void infoCommand(int argc, char **argv);
+
+  public:
+    int main(int argc, char **argv);
+};
+
+void LogTool::printHelpPage(const std::string& page)
+{
+    FormattedPrinter help(cout);
+    if (page == "options") {
+        help.line("opp_logtool -- part of " OMNETPP_PRODUCT ", (C) 2006-2018 OpenSim Ltd.");
+        help.line("Version: " OMNETPP_VERSION_STR ", build: " OMNETPP_BUILDID ", edition: " OMNETPP_EDITION);
+        help.line();
+        help.para("Usage: opp_logtool <command> [<options>] <file>");
+        help.para("For processing binary log files written by Cmdenv (see the cmdenv-binary-log configuration option).");
+        help.line("Commands:");
+        help.option("p, print", "Format the log as text, optionally filtered");
+        help.option("i, info", "Print summary information about the file");
+        help.option("h, help", "Print help text");
+        help.line();
+        help.para("The default command is 'print'. To get help on a command, use opp_logtool help <command>.");
+    }
+    else if (page == "h" || page == "help") {
+        help.para("Usage: opp_logtool help <command>");
+        help.para("Print help text on the given command.");
+    }
+    else if (page == "p" || page == "print") {
+        help.para("Usage: opp_logtool print [<options>] <file>");
+        help.para("Format the log entries as text, in the same way as Cmdenv would print them.");
+        help.line("Options:");
+        help.option("-p, --prefix <format>", "Log prefix format, see the cmdenv-log-prefix configuration option (default: \"[%l]\\t\"). "
+                "Directives whose data is not stored in the file (%g, %p, %b, %w, %W, %H, %I, %X, %Y, %Z, %>) print nothing.");
+        help.option("-l, --level <level>", "Only print entries of the given log level or above (trace, debug, detail, info, warn, error, fatal)");
+        help.option("-c, --category <category>", "Only print entries of the given category. May be specified multiple times.");
+        help.option("-m, --module <pattern>", "Only print entries whose context component's full path matches the pattern (e.g. \"**.host[*]\")");
+        help.option("-g, --grep <regex>", "Only print entries whose text matches the regular expression");
+        help.option("-f, --from-event <num>", "Only print entries starting from the given event number");
+        help.option("-t, --to-event <num>", "Only print entries up to the given event number");
+        help.option("-b, --event-banners", "Print event banners, like Cmdenv with cmdenv-event-banners=true");
+        help.option("-o, --output <file>", "Write output into the given file instead of the standard output");
+    }
+    else if (page == "i" || page == "info") {
+        help.para("Usage: opp_logtool info <file>");
+        help.para("Print the run ID, and the number of events, log entries, strings and components in the file.");
+    }
+    else
+        throw opp_runtime_error("Unknown help topic '%s'", page.c_str());
+}
+
+void LogTool::printCommand(int argc, char **argv)
+{
+    std::string prefixFormat = "[%l]\t";
+    int minLogLevel = 0;
+    std::vector<std::string> categories;
+    std::string modulePattern;
+    std::string grepRegex;
+    bool grep = false;
+    int64_t fromEvent = -1, toEvent = -1;
+    bool eventBanners = false;
+    std::string inputFileName, outputFileName;
+
+    for (int i = 0; i < argc; i++) {
+        std::string opt = argv[i];
+        bool hasArg = i+1 < argc;
+        if ((opt == "-p" || opt == "--prefix") && hasArg)
+            prefixFormat = argv[++i];
+        else if ((opt == "-l" || opt == "--level") && hasArg)
+            minLogLevel = resolveLogLevel(argv[++i]);
+        else if ((opt == "-c" || opt == "--category") && hasArg)
+            categories.push_back(argv[++i]);
+        else if ((opt == "-m" || opt == "--module") && hasArg)
+            modulePattern = argv[++i];
+        else if ((opt == "-g" || opt == "--grep") && hasArg) {
+            grepRegex = argv[++i];
+            grep = true;
+        }
+        else if ((opt == "-f" || opt == "--from-event") && hasArg)
+            fromEvent = opp_atoll(argv[++i]);
+        else if ((opt == "-t" || opt == "--to-event") && hasArg)
+            toEvent = opp_atoll(argv[++i]);
+        else if (opt == "-b" || opt == "--event-banners")
+            eventBanners = true;
+        else if ((opt == "-o" || opt == "--output") && hasArg)
+            outputFileName = argv[++i];
+        else if (opt[0] == '-')
+            throw opp_runtime_error("Unknown option or missing argument: '%s'", opt.c_str());
+        else if (inputFileName.empty())
+            inputFileName = opt;
+        else
+            throw opp_runtime_error("Only one input file is accepted");
+    }
+    if (inputFileName.empty())
+        throw opp_runtime_error("No input file specified");
+
+    BinaryLogReader reader(inputFileName.c_str());
+    LogPrefixFormatter formatter(prefixFormat.c_str(), reader);
+    PatternMatcher moduleMatcher(modulePattern.c_str(), true, true, true);
+    std::regex regex;
+    if (grep)
+        regex = std::regex(grepRegex);
+
+    std::ofstream outputFile;
+    if (!outputFileName.empty()) {
+        outputFile.open(outputFileName);
+        if (!outputFile)
+            throw opp_runtime_error("Cannot open output file '%s'", outputFileName.c_str());
+    }
+    std::ostream& out = outputFileName.empty() ? cout : outputFile;
+
+    // as in Cmdenv, only entries written within events are subject to event filtering
+    auto isEventInRange = [&](int64_t eventNumber) {
+        return (fromEvent == -1 || eventNumber >= fromEvent) && (toEvent == -1 || eventNumber <= toEvent);
+    };
+
+    bool inEvent = false;
+    while (true) {
+        BinaryLogReader::RecordKind kind = reader.next();
+        if (kind == BinaryLogReader::END)
+            break;
+        if (kind == BinaryLogReader::EVENT) {
+            const BinaryLogReader::Event& event = reader.getEvent();
+            inEvent = true;
+            if (toEvent != -1 && event.eventNumber > toEvent)
+                break;
+            if (eventBanners && isEventInRange(event.eventNumber)) {
+                char buf[64];
+                char *endp;
+                out << "** Event #" << event.eventNumber << "  t=" << opp_ttoa(buf, event.rawSimtime, reader.getSimtimeScaleExp(), endp) << "   ";
+                const BinaryLogReader::Component *module = reader.getComponent(event.moduleId);
+                if (module)
+                    out << *module->fullPath << " (" << (module->nedTypeName ? *module->nedTypeName : *module->className) << ", id=" << event.moduleId << ")";
+                out << "\n";
+            }
+        }
+        else {
+            const BinaryLogReader::Entry& entry = reader.getEntry();
+            if (inEvent && !isEventInRange(reader.getEvent().eventNumber))
+                continue;
+            if (entry.logLevel < minLogLevel)
+                continue;
+            if (!categories.empty()) {
+                std::string category = entry.category ? *entry.category : "";
+                if (std::find(categories.begin(), categories.end(), category) == categories.end())
+                    continue;
+            }
+            if (!modulePattern.empty()) {
+                const BinaryLogReader::Component *component = reader.getComponent(entry.contextComponentId);
+                if (!component || !moduleMatcher.matches(component->fullPath->c_str()))
+                    continue;
+            }
+            if (grep && !std::regex_search(entry.text, regex))
+                continue;
+            if (!formatter.isBlank())
+                out << formatter.formatPrefix(entry);
+            out << entry.text;
+        }
+    }
+    out.flush();
+}
+
+void LogTool::infoCommand(int argc, char **argv)
+{
+    if (argc != 1)
+        throw opp_runtime_error("Exactly one input file expected");
+    BinaryLogReader reader(argv[0]);
+    int64_t numEvents = 0, numEntries = 0;
+    int64_t numEntriesPerLevel[8] = {0};
+    while (true) {
+        BinaryLogReader::RecordKind kind = reader.next();
+        if (kind == BinaryLogReader::END)
+            break;
+        else if (kind == BinaryLogReader::EVENT)
+            numEvents++;
+        else {
+            numEntries++;
+            int level = reader.getEntry().logLevel;
+            if (level >= 0 && level < 8)
+                numEntriesPerLevel[level]++;
+        }
+    }
+    cout << "run " << reader.getRunId() << "\n";
+    cout << "events: " << numEvents << "\n";
+    cout << "log entries: " << numEntries << "\n";
+    for (int i = 0; i < 8; i++)
+        if (numEntriesPerLevel[i] > 0)
+            cout << "  " << getLogLevelName(i) << ": " << numEntriesPerLevel[i] << "\n";
+    cout << "components: " << reader.getNumComponents() << "\n";
+    cout << "strings: " << reader.getNumStrings() - 1 << "\n";
+}
+
+int LogTool::main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printHelpPage("options");
+        return 0;
+    }
+
+    try {
+        std::string command = argv[1];
+        if (argc >= 3 && command[0] != '-' && (std::string(argv[2]) == "-h" || std::string(argv[2]) == "--help"))  // "opp_logtool print -h"
+            printHelpPage(command);
+        else if (command == "p" || command == "print")
+            printCommand(argc-2, argv+2);
+        else if (command == "i" || command == "info")
+            infoCommand(argc-2, argv+2);
+        else if (command == "h" || command == "help" || command == "-h" || command == "--help")
+            printHelpPage(argc >= 3 ? argv[2] : "options");
+        else  // use default command
+            printCommand(argc-1, argv+1);
+    }
+    catch (std::exception& e) {
+        cerr << "opp_logtool: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace common
+}  // namespace omnetpp
+
+int main(int argc, char **argv)
+{
+    omnetpp::common::LogTool logTool;
+    return logTool.main(argc, argv);
+}
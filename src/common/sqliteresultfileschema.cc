@@ -159,6 +159,22 @@ const char SQL_CREATE_TABLES[] =
         "PRAGMA page_size = 16384; "
 ;
 
+// Alternative layout for vectorData: rows are stored in the primary key order,
+// i.e. grouped by vector, so reading a vector needs no separate index. WITHOUT ROWID
+// tables have no implicit rowid, so it is an explicit column that preserves the
+// recording order for queries that refer to it.
+const char SQL_CREATE_CLUSTERED_VECTORDATA_TABLE[] =
+        "CREATE TABLE IF NOT EXISTS vectorData "
+        "( "
+            "vectorId      INTEGER NOT NULL REFERENCES vector(vectorId) ON DELETE CASCADE, "
+            "eventNumber   INTEGER NOT NULL, "
+            "simtimeRaw    INTEGER NOT NULL, "
+            "value         REAL, " // cannot be NOT NULL because of NaN values
+            "rowid         INTEGER NOT NULL, "
+            "PRIMARY KEY (vectorId, eventNumber, rowid) "
+        ") WITHOUT ROWID; "
+;
+
 }  // namespace common
 }  // namespace omnetpp
 
@@ -18,6 +18,7 @@ namespace omnetpp {
 namespace common {
 
 extern const char SQL_CREATE_TABLES[];
+extern const char SQL_CREATE_CLUSTERED_VECTORDATA_TABLE[];
 
 }  // namespace common
 }  // namespace omnetpp
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include "commonutil.h"
+#include "stringutil.h"
 #include "sqlitevectorfilewriter.h"
 #include "sqliteresultfileschema.h"
 
@@ -29,6 +30,9 @@ namespace common {
  *  - index adds about 30-70% to the file size
  *  - raw recording performance: about half of text based recorder
  *  - with adding the index up front, total time is worse than with adding index after
+ *  - multi-row INSERT statements save most of the per-sample statement execution overhead
+ *  - the clustered (WITHOUT ROWID) layout needs no index, but inserts into a b-tree
+ *    ordered by vector, which is slower than appending when there are many vectors
  */
 
 SqliteVectorFileWriter::SqliteVectorFileWriter()
@@ -40,8 +44,19 @@ SqliteVectorFileWriter::SqliteVectorFileWriter()
     add_vector_stmt = nullptr;
     add_vector_attr_stmt = nullptr;
     add_vector_data_stmt = nullptr;
+    add_vector_data_batch_stmt = nullptr;
     update_vector_stmt = nullptr;
 
+    pageSize = 16384;
+    journalMode = "TRUNCATE";
+    synchronousMode = "OFF";
+    insertBatchSize = 100;
+    clusteredTable = false;
+
+    isClustered = false;
+    batchRows = 1;
+    nextRowId = 1;
+
     bufferedSamplesLimit = 0;
     bufferedSamples = 0;
 }
@@ -79,7 +94,24 @@ void SqliteVectorFileWriter::open(const char *filename)
 
     checkOK(sqlite3_busy_timeout(db, 10000));    // max time [ms] for waiting to unlock database
 
+    // page size can only be set before the first table is created
+    executeSql(opp_stringf("PRAGMA page_size = %d;", pageSize).c_str());
+    if (clusteredTable)
+        executeSql(SQL_CREATE_CLUSTERED_VECTORDATA_TABLE);
     checkOK(sqlite3_exec(db, SQL_CREATE_TABLES, nullptr, 0, nullptr));
+    executeSql(("PRAGMA journal_mode = " + journalMode + ";").c_str());
+    executeSql(("PRAGMA synchronous = " + synchronousMode + ";").c_str());
+
+    // when appending, the existing table determines the layout
+    isClustered = isTableClustered("vectorData");
+    if (isClustered) {
+        prepareStatement(stmt, "SELECT IFNULL(MAX(rowid), 0) + 1 FROM vectorData;");
+        if (sqlite3_step(stmt) != SQLITE_ROW)
+            error(sqlite3_errmsg(db));
+        nextRowId = sqlite3_column_int64(stmt, 0);
+        finalizeStatement(stmt);
+    }
+
     prepareStatements();
     //NOTE: this line is only present in the scalar writer:
     //checkOK(sqlite3_exec(db, "BEGIN IMMEDIATE TRANSACTION;", nullptr, 0, nullptr));
@@ -92,6 +124,7 @@ void SqliteVectorFileWriter::close()
         finalizeStatement(add_vector_stmt);
         finalizeStatement(add_vector_attr_stmt);
         finalizeStatement(add_vector_data_stmt);
+        finalizeStatement(add_vector_data_batch_stmt);
         finalizeStatement(update_vector_stmt);
 
         executeSql("PRAGMA journal_mode = DELETE;");
@@ -110,6 +143,7 @@ void SqliteVectorFileWriter::cleanup()  // MUST NOT THROW
         finalizeStatement(add_vector_stmt);
         finalizeStatement(add_vector_attr_stmt);
         finalizeStatement(add_vector_data_stmt);
+        finalizeStatement(add_vector_data_batch_stmt);
         finalizeStatement(update_vector_stmt);
 
         // note: no checkOK() because it would throw
@@ -125,9 +159,25 @@ void SqliteVectorFileWriter::cleanup()  // MUST NOT THROW
 
 void SqliteVectorFileWriter::createVectorIndex()
 {
+    // a clustered table is already ordered by vectorId
+    if (isClustered)
+        return;
     executeSql("CREATE INDEX IF NOT EXISTS vectorData_idx ON vectorData (vectorId);");
 }
 
+bool SqliteVectorFileWriter::isTableClustered(const char *tableName)
+{
+    prepareStatement(stmt, "SELECT sql FROM sqlite_master WHERE type='table' AND name=?;");
+    checkOK(sqlite3_bind_text(stmt, 1, tableName, -1, SQLITE_STATIC));
+    bool result = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *sql = (const char *)sqlite3_column_text(stmt, 0);
+        result = sql != nullptr && opp_stringendswith(opp_trim(sql).c_str(), "WITHOUT ROWID");
+    }
+    finalizeStatement(stmt);
+    return result;
+}
+
 void SqliteVectorFileWriter::executeSql(const char *sql)
 {
     checkOK(sqlite3_exec(db, sql, nullptr, nullptr, nullptr));
@@ -148,7 +198,23 @@ void SqliteVectorFileWriter::prepareStatements()
 {
     prepareStatement(add_vector_stmt, "INSERT INTO vector (runId, moduleName, vectorName) VALUES (?, ?, ?);");
     prepareStatement(add_vector_attr_stmt, "INSERT INTO vectorAttr (vectorId, attrName, attrValue) VALUES (?, ?, ?);");
-    prepareStatement(add_vector_data_stmt, "INSERT INTO vectorData (vectorId, eventNumber, simtimeRaw, value) VALUES (?, ?, ?, ?);");
+
+    // the clustered table has an explicit rowid column
+    const char *columns = isClustered ? "vectorId, eventNumber, simtimeRaw, value, rowid" : "vectorId, eventNumber, simtimeRaw, value";
+    const char *placeholders = isClustered ? "(?, ?, ?, ?, ?)" : "(?, ?, ?, ?)";
+    int numColumns = isClustered ? 5 : 4;
+    prepareStatement(add_vector_data_stmt, opp_stringf("INSERT INTO vectorData (%s) VALUES %s;", columns, placeholders).c_str());
+
+    // multi-row insert, within the limit on the number of parameters in a statement
+    int maxRows = sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1) / numColumns;
+    batchRows = std::max(1, std::min(insertBatchSize, maxRows));
+    if (batchRows > 1) {
+        std::string sql = opp_stringf("INSERT INTO vectorData (%s) VALUES %s", columns, placeholders);
+        for (int i = 1; i < batchRows; i++)
+            sql += std::string(", ") + placeholders;
+        sql += ";";
+        prepareStatement(add_vector_data_batch_stmt, sql.c_str());
+    }
 }
 
 void SqliteVectorFileWriter::beginRecordingForRun(const std::string& runName, int simtimeScaleExp, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& configEntries)
@@ -336,18 +402,38 @@ void SqliteVectorFileWriter::writeBlock(VectorData *vp)
 
     Assert(db != nullptr);
 
-    for (const Sample& sample : vp->buffer) {
+    // full batches with the multi-row statement, the rest one by one
+    size_t numSamples = vp->buffer.size();
+    size_t i = 0;
+    if (add_vector_data_batch_stmt != nullptr) {
+        for ( ; i + batchRows <= numSamples; i += batchRows) {
+            checkOK(sqlite3_reset(add_vector_data_batch_stmt));
+            int paramIndex = 1;
+            for (int k = 0; k < batchRows; k++)
+                bindSample(add_vector_data_batch_stmt, paramIndex, vp, vp->buffer[i+k]);
+            checkDone(sqlite3_step(add_vector_data_batch_stmt));
+        }
+    }
+    for ( ; i < numSamples; i++) {
         checkOK(sqlite3_reset(add_vector_data_stmt));
-        checkOK(sqlite3_bind_int64(add_vector_data_stmt, 1, vp->id));
-        checkOK(sqlite3_bind_int64(add_vector_data_stmt, 2, sample.eventNumber));
-        checkOK(sqlite3_bind_int64(add_vector_data_stmt, 3, sample.simtime));
-        checkOK(sqlite3_bind_double(add_vector_data_stmt, 4, sample.value));
+        int paramIndex = 1;
+        bindSample(add_vector_data_stmt, paramIndex, vp, vp->buffer[i]);
         checkDone(sqlite3_step(add_vector_data_stmt));
     }
     bufferedSamples -= vp->buffer.size();
     vp->buffer.clear();
 }
 
+void SqliteVectorFileWriter::bindSample(sqlite3_stmt *stmt, int& paramIndex, VectorData *vp, const Sample& sample)
+{
+    checkOK(sqlite3_bind_int64(stmt, paramIndex++, vp->id));
+    checkOK(sqlite3_bind_int64(stmt, paramIndex++, sample.eventNumber));
+    checkOK(sqlite3_bind_int64(stmt, paramIndex++, sample.simtime));
+    checkOK(sqlite3_bind_double(stmt, paramIndex++, sample.value));
+    if (isClustered)
+        checkOK(sqlite3_bind_int64(stmt, paramIndex++, nextRowId++));
+}
+
 void SqliteVectorFileWriter::flush()
 {
     if (db)
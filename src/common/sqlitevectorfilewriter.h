@@ -71,8 +71,21 @@ class COMMON_API SqliteVectorFileWriter
     sqlite3_stmt *add_vector_stmt;
     sqlite3_stmt *add_vector_attr_stmt;
     sqlite3_stmt *add_vector_data_stmt;
+    sqlite3_stmt *add_vector_data_batch_stmt; // multi-row insert of batchRows samples; nullptr if batchRows<=1
     sqlite3_stmt *update_vector_stmt;
 
+    // configuration, must be set before open()
+    int pageSize;              // page size for new database files
+    std::string journalMode;   // argument for "PRAGMA journal_mode"
+    std::string synchronousMode; // argument for "PRAGMA synchronous"
+    int insertBatchSize;       // requested number of samples per INSERT statement
+    bool clusteredTable;       // whether to create vectorData as a WITHOUT ROWID table clustered by (vectorId, eventNumber)
+
+    // table layout, determined in open()
+    bool isClustered;          // whether vectorData is clustered (has an explicit rowid column)
+    int batchRows;             // number of samples per multi-row INSERT statement
+    sqlite_int64 nextRowId;    // next value for the explicit rowid column if isClustered
+
     int bufferedSamplesLimit;  // limit of total buffered samples; 0=no limit
 
     Vectors vectors;           // registered output vectors
@@ -85,7 +98,9 @@ class COMMON_API SqliteVectorFileWriter
     virtual void writeOneBlock(VectorData *vp);
     virtual void writeBlock(VectorData *vp);
     virtual void finalizeVector(VectorData *vp);
+    void bindSample(sqlite3_stmt *stmt, int& paramIndex, VectorData *vp, const Sample& sample);
     void executeSql(const char *sql);
+    bool isTableClustered(const char *tableName);
 
     void prepareStatement(sqlite3_stmt *&stmt, const char *sql);
     void finalizeStatement(sqlite3_stmt *&stmt);
@@ -104,6 +119,18 @@ class COMMON_API SqliteVectorFileWriter
     void setOverallMemoryLimit(size_t limit) {bufferedSamplesLimit = limit / sizeof(Sample);}
     size_t getOverallMemoryLimit() const {return bufferedSamplesLimit * sizeof(Sample);}
 
+    // database settings; they take effect at the next open(). The page size only affects newly created files.
+    void setPageSize(int bytes) {pageSize = bytes;}
+    int getPageSize() const {return pageSize;}
+    void setJournalMode(const char *mode) {journalMode = mode;}
+    const char *getJournalMode() const {return journalMode.c_str();}
+    void setSynchronousMode(const char *mode) {synchronousMode = mode;}
+    const char *getSynchronousMode() const {return synchronousMode.c_str();}
+    void setInsertBatchSize(int numSamples) {insertBatchSize = numSamples;}
+    int getInsertBatchSize() const {return insertBatchSize;}
+    void setClusteredTable(bool enable) {clusteredTable = enable;}
+    bool getClusteredTable() const {return clusteredTable;}
+
     void beginRecordingForRun(const std::string& runName, int simtimeScaleExp, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments);
     void endRecordingForRun();
     void *registerVector(const std::string& componentFullPath, const std::string& name, const StringMap& attributes, size_t bufferSize);
@@ -49,6 +49,7 @@
 #include "omnetpp/cobjectfactory.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cfingerprint.h"
+#include "omnetpp/ceventprofiler.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/cnedmathfunction.h"
 #include "omnetpp/cnedfunction.h"
@@ -140,13 +141,14 @@ Register_PerRunConfigOption(CFGID_EVENTLOGMANAGER_CLASS, "eventlogmanager-class"
 Register_PerRunConfigOption(CFGID_OUTPUTVECTORMANAGER_CLASS, "outputvectormanager-class", CFG_STRING, DEFAULT_OUTPUTVECTORMANAGER_CLASS, "Part of the Envir plugin mechanism: selects the output vector manager class to be used to record data from output vectors. The class has to implement the `cIOutputVectorManager` interface.");
 Register_PerRunConfigOption(CFGID_OUTPUTSCALARMANAGER_CLASS, "outputscalarmanager-class", CFG_STRING, DEFAULT_OUTPUTSCALARMANAGER_CLASS, "Part of the Envir plugin mechanism: selects the output scalar manager class to be used to record data passed to recordScalar(). The class has to implement the `cIOutputScalarManager` interface.");
 Register_PerRunConfigOption(CFGID_SNAPSHOTMANAGER_CLASS, "snapshotmanager-class", CFG_STRING, "omnetpp::envir::FileSnapshotManager", "Part of the Envir plugin mechanism: selects the class to handle streams to which snapshot() writes its output. The class has to implement the `cISnapshotManager` interface.");
-Register_PerRunConfigOption(CFGID_FUTUREEVENTSET_CLASS, "futureeventset-class", CFG_STRING, "omnetpp::cEventHeap", "Part of the Envir plugin mechanism: selects the class for storing the future events in the simulation. The class has to implement the `cFutureEventSet` interface.");
+Register_PerRunConfigOption(CFGID_FUTUREEVENTSET_CLASS, "futureeventset-class", CFG_STRING, "omnetpp::cEventHeap", "Part of the Envir plugin mechanism: selects the class for storing the future events in the simulation. The class has to implement the `cFutureEventSet` interface. Alternative built-in implementation: `omnetpp::cTimerWheelEventHeap`.");
 Register_GlobalConfigOption(CFGID_IMAGE_PATH, "image-path", CFG_PATH, "./images", "A semicolon-separated list of directories that contain module icons and other resources. This list will be concatenated with the contents of the `OMNETPP_IMAGE_PATH` environment variable or with a compile-time, hardcoded image path if the environment variable is empty.");
 Register_GlobalConfigOption(CFGID_FNAME_APPEND_HOST, "fname-append-host", CFG_BOOL, nullptr, "Turning it on will cause the host name and process Id to be appended to the names of output files (e.g. omnetpp.vec, omnetpp.sca). This is especially useful with distributed simulation. The default value is true if parallel simulation is enabled, false otherwise.");
 Register_PerRunConfigOption(CFGID_DEBUG_ON_ERRORS, "debug-on-errors", CFG_BOOL, "false", "When set to true, runtime errors will cause the simulation program to break into the C++ debugger (if the simulation is running under one, or just-in-time debugging is activated). Once in the debugger, you can view the stack trace or examine variables.");
 Register_PerRunConfigOption(CFGID_PRINT_UNDISPOSED, "print-undisposed", CFG_BOOL, "true", "Whether to report objects left (that is, not deallocated by simple module destructors) after network cleanup.");
 Register_GlobalConfigOption(CFGID_SIMTIME_SCALE, "simtime-scale", CFG_INT, "-12", "DEPRECATED in favor of simtime-resolution. Sets the scale exponent, and thus the resolution of time for the 64-bit fixed-point simulation time representation. Accepted values are -18..0; for example, -6 selects microsecond resolution. -12 means picosecond resolution, with a maximum simtime of ~110 days.");
 Register_GlobalConfigOption(CFGID_SIMTIME_RESOLUTION, "simtime-resolution", CFG_CUSTOM, "ps", "Sets the resolution for the 64-bit fixed-point simulation time representation. Accepted values are: second-or-smaller time units (`s`, `ms`, `us`, `ns`, `ps`, `fs` or as), power-of-ten multiples of such units (e.g. 100ms), and base-10 scale exponents in the -18..0 range. The maximum representable simulation time depends on the resolution. The default is picosecond resolution, which offers a range of ~110 days.");
+Register_GlobalConfigOption(CFGID_NED_CACHE_DIR, "ned-cache-dir", CFG_PATH, "", "Name of a directory where the parsed and validated form of NED files loaded from the NED path is cached. On subsequent runs, NED files whose content has not changed are loaded from the cache, skipping parsing and validation. The directory is created if it does not exist. Empty means no caching.");
 Register_GlobalConfigOption(CFGID_NED_PATH, "ned-path", CFG_PATH, "", "A semicolon-separated list of directories. The directories will be regarded as roots of the NED package hierarchy, and all NED files will be loaded from their subdirectory trees. This option is normally left empty, as the OMNeT++ IDE sets the NED path automatically, and for simulations started outside the IDE it is more convenient to specify it via command-line option (-n) or via environment variable (OMNETPP_NED_PATH, NEDPATH).");
 Register_GlobalConfigOption(CFGID_NED_EXCLUSION_PATH, "ned-exclusion-path", CFG_PATH, "", "A semicolon-separated list of directories to be skipped when loading NED files. Relative paths are interpreted as relative to root of the NED folder being loaded, i.e. specifying 'tests' will skip the 'tests' subdirectory in each folder in the NED path. The NED exclusion path may also be specified via command-line option (-x) and environment variable (OMNETPP_NED_EXCLUSION_PATH).");
 Register_GlobalConfigOption(CFGID_DEBUGGER_ATTACH_ON_STARTUP, "debugger-attach-on-startup", CFG_BOOL, "false", "When set to true, the simulation program will launch an external debugger attached to it (if not already present), allowing you to set breakpoints before proceeding. The debugger command is configurable. Note that debugging (i.e. attaching to) a non-child process needs to be explicitly enabled on some systems, e.g. Ubuntu.");
@@ -160,17 +162,21 @@ Register_PerRunConfigOptionU(CFGID_SIM_TIME_LIMIT, "sim-time-limit", "s", nullpt
 Register_PerRunConfigOptionU(CFGID_CPU_TIME_LIMIT, "cpu-time-limit", "s", nullptr, "Stops the simulation when CPU usage has reached the given limit. The default is no limit. Note: To reduce per-event overhead, this time limit is only checked every N events (by default, N=1024).");
 Register_PerRunConfigOptionU(CFGID_REAL_TIME_LIMIT, "real-time-limit", "s", nullptr, "Stops the simulation after the specified amount of time has elapsed. The default is no limit. Note: To reduce per-event overhead, this time limit is only checked every N events (by default, N=1024).");
 Register_PerRunConfigOptionU(CFGID_WARMUP_PERIOD, "warmup-period", "s", nullptr, "Length of the initial warm-up period. When set, results belonging to the first x seconds of the simulation will not be recorded into output vectors, and will not be counted into output scalars (see option `**.result-recording-modes`). This option is useful for steady-state simulations. The default is 0s (no warmup period). Note that models that compute and record scalar results manually (via `recordScalar()`) will not automatically obey this setting.");
-Register_PerRunConfigOption(CFGID_FINGERPRINT, "fingerprint", CFG_STRING, nullptr, "The expected fingerprints of the simulation. If you need multiple fingerprints, separate them with commas. When provided, the fingerprints will be calculated from the specified properties of simulation events, messages, and statistics during execution, and checked against the provided values. Fingerprints are suitable for crude regression tests. As fingerprints occasionally differ across platforms, more than one value can be specified for a single fingerprint, separated by spaces, and a match with any of them will be accepted. To obtain a fingerprint, enter a dummy value (such as `0000`), and run the simulation.");
+Register_PerRunConfigOption(CFGID_FINGERPRINT, "fingerprint", CFG_STRING, nullptr, "The expected fingerprints of the simulation. If you need multiple fingerprints, separate them with commas. When provided, the fingerprints will be calculated from the specified properties of simulation events, messages, and statistics during execution, and checked against the provided values. Fingerprints are suitable for crude regression tests. As fingerprints occasionally differ across platforms, more than one value can be specified for a single fingerprint, separated by spaces, and a match with any of them will be accepted. To obtain a fingerprint, enter a dummy value (such as `0000`), and run the simulation. Fingerprints longer than 8 hex digits (such as `0000-0000-0000-0000`) select the 64-bit xxHash64 hash function.");
 #ifndef USE_OMNETPP4x_FINGERPRINTS
 Register_PerRunConfigOption(CFGID_FINGERPRINTER_CLASS, "fingerprintcalculator-class", CFG_STRING, "omnetpp::cSingleFingerprintCalculator", "Part of the Envir plugin mechanism: selects the fingerprint calculator class to be used to calculate the simulation fingerprint. The class has to implement the `cFingerprintCalculator` interface.");
 #endif
+Register_PerRunConfigOption(CFGID_PROFILING, "profiling", CFG_BOOL, "false", "Enables the built-in event profiler, which measures the time spent in processing events, and breaks it down by module, NED type, event/message class and message kind. The results are printed at the end of the run. See also `profiling-record-scalars`.");
+Register_PerRunConfigOption(CFGID_PROFILING_RECORD_SCALARS, "profiling-record-scalars", CFG_BOOL, "false", "When `profiling=true`: record the profiling results as scalars: `profile:numEvents` and `profile:time` for each module, and their breakdown by NED type, event/message class and message kind for the network module.");
 Register_PerRunConfigOption(CFGID_NUM_RNGS, "num-rngs", CFG_INT, "1", "The number of random number generators.");
-Register_PerRunConfigOption(CFGID_RNG_CLASS, "rng-class", CFG_STRING, "omnetpp::cMersenneTwister", "The random number generator class to be used. It can be `cMersenneTwister`, `cLCG32`, `cAkaroaRNG`, or you can use your own RNG class (it must be subclassed from `cRNG`).");
+Register_PerRunConfigOption(CFGID_RNG_CLASS, "rng-class", CFG_STRING, "omnetpp::cMersenneTwister", "The random number generator class to be used. It can be `cMersenneTwister`, `cLCG32`, `cPhiloxRNG`, `cAkaroaRNG`, or you can use your own RNG class (it must be subclassed from `cRNG`).");
+Register_PerRunConfigOption(CFGID_COMPONENT_RNG_STREAMS, "component-rng-streams", CFG_BOOL, "false", "When enabled, every module and channel gets its own random number streams instead of drawing from the global RNGs: local RNG k of a component is a stream keyed by the seed set, the component's full path and k (`rng-k` mappings are ignored). Components created with the same full path as an earlier one also have their instance number in the key. The numbers a component draws then do not depend on other components or on the partitioning of a parallel simulation. Requires an RNG class that supports keyed streams, e.g. `cPhiloxRNG`.");
 Register_PerRunConfigOption(CFGID_SEED_SET, "seed-set", CFG_INT, "${runnumber}", "Selects the kth set of automatic random number seeds for the simulation. Meaningful values include `${repetition}` which is the repeat loop counter (see `repeat` option), and `${runnumber}`.");
 Register_PerRunConfigOption(CFGID_RESULT_DIR, "result-dir", CFG_STRING, "results", "Base value for the `${resultdir}` variable, which is used as the default directory for result files (output vector file, output scalar file, eventlog file, etc.). See also the `resultdir-subdivision` config option.");
 Register_PerRunConfigOption(CFGID_RECORD_EVENTLOG, "record-eventlog", CFG_BOOL, "false", "Enables recording an eventlog file, which can be later visualized on a sequence chart. See `eventlog-file` option too.");
 Register_PerRunConfigOption(CFGID_DEBUG_STATISTICS_RECORDING, "debug-statistics-recording", CFG_BOOL, "false", "Turns on the printing of debugging information related to statistics recording (`@statistic` properties)");
 Register_PerRunConfigOption(CFGID_CHECK_SIGNALS, "check-signals", CFG_BOOL, CHECKSIGNALS_DEFAULT, "Controls whether the simulation kernel will validate signals emitted by modules and channels against signal declarations (`@signal` properties) in NED files. The default setting depends on the build type: `true` in DEBUG, and `false` in RELEASE mode.");
+Register_PerRunConfigOption(CFGID_OWNER_LIST_TRACKING, "owner-list-tracking", CFG_BOOL, "true", "Whether modules and channels keep a list of the objects they own (messages, packets, queues, etc.). Setting it to `false` makes object creation, deletion and ownership transfer cheaper, which is useful for production runs in express mode; the downside is that these objects cannot be seen in inspectors, and they are neither reported as undisposed nor garbage collected when their owner is deleted. Ownership checks (e.g. that a message being sent is not owned by a queue) are not affected.");
 
 Register_PerObjectConfigOption(CFGID_PARTITION_ID, "partition-id", KIND_MODULE, CFG_STRING, nullptr, "With parallel simulation: in which partition the module should be instantiated. Specify numeric partition ID, or a comma-separated list of partition IDs for compound modules that span across multiple partitions. Ranges (`5..9`) and `*` (=all) are accepted too.");
 Register_PerObjectConfigOption(CFGID_RNG_K, "rng-%", KIND_COMPONENT, CFG_INT, "", "Maps a module-local RNG to one of the global RNGs. Example: `**.gen.rng-1=3` maps the local RNG 1 of modules matching `**.gen` to the global RNG 3. The value may be an expression, with the `index` and `ancestorIndex()` operators being potentially very useful. The default is one-to-one mapping, i.e. RNG k of all modules refer to the global RNG k (`for k=0..num-rngs-1`).\nUsage: `<module-full-path>.rng-<local-index>=<global-index>`. Examples: `**.mac.rng-0=1; **.source[*].rng-0=index`");
@@ -276,6 +282,7 @@ EnvirOptions::EnvirOptions()
     parsim = false;
     numRNGs = 1;
     seedset = 0;
+    componentRngStreams = false;
     debugStatisticsRecording = false;
     checkSignals = false;
     fnameAppendHost = false;
@@ -331,6 +338,8 @@ EnvirBase::~EnvirBase()
     for (int i = 0; i < numRNGs; i++)
         delete rngs[i];
     delete[] rngs;
+    for (cRNG *rng : componentRngs)
+        delete rng;
 
 #ifdef WITH_PARSIM
     delete parsimComm;
@@ -595,6 +604,7 @@ bool EnvirBase::setup()
         }
 
         // load NED files from folders on the NED path
+        getSimulation()->setNedAstCacheFolder(getConfig()->getAsPath(CFGID_NED_CACHE_DIR).c_str());
         StringTokenizer tokenizer(opt->nedPath.c_str(), PATH_SEPARATOR);
         std::set<std::string> foldersLoaded;
         while (tokenizer.hasMoreTokens()) {
@@ -1167,6 +1177,8 @@ void EnvirBase::moduleCreated(cModule *newmodule)
 
 void EnvirBase::moduleDeleted(cModule *module)
 {
+    if (!componentRngSlots.empty())
+        releaseComponentRngs(module);
     if (recordEventlog)
         eventlogManager->moduleDeleted(module);
 }
@@ -1197,6 +1209,8 @@ void EnvirBase::connectionCreated(cGate *srcgate)
 
 void EnvirBase::connectionDeleted(cGate *srcgate)
 {
+    if (!componentRngSlots.empty() && srcgate->getChannel())
+        releaseComponentRngs(srcgate->getChannel());
     if (recordEventlog)
         eventlogManager->connectionDeleted(srcgate);
 }
@@ -1385,8 +1399,10 @@ void EnvirBase::readPerRunOptions()
     opt->numRNGs = cfg->getAsInt(CFGID_NUM_RNGS);
     opt->rngClass = cfg->getAsString(CFGID_RNG_CLASS);
     opt->seedset = cfg->getAsInt(CFGID_SEED_SET);
+    opt->componentRngStreams = cfg->getAsBool(CFGID_COMPONENT_RNG_STREAMS);
     opt->debugStatisticsRecording = cfg->getAsBool(CFGID_DEBUG_STATISTICS_RECORDING);
     opt->checkSignals = cfg->getAsBool(CFGID_CHECK_SIGNALS);
+    opt->ownerListTracking = cfg->getAsBool(CFGID_OWNER_LIST_TRACKING);
     opt->schedulerClass = cfg->getAsString(CFGID_SCHEDULER_CLASS);
     opt->futureeventsetClass = cfg->getAsString(CFGID_FUTUREEVENTSET_CLASS);
     opt->eventlogManagerClass = cfg->getAsString(CFGID_EVENTLOGMANAGER_CLASS);
@@ -1448,7 +1464,14 @@ void EnvirBase::readPerRunOptions()
     }
     getSimulation()->setFingerprintCalculator(fingerprint);
 
+    // install event profiler
+    cEventProfiler *profiler = nullptr;
+    if (cfg->getAsBool(CFGID_PROFILING))
+        profiler = new cEventProfiler(cfg->getAsBool(CFGID_PROFILING_RECORD_SCALARS));
+    getSimulation()->setEventProfiler(profiler);
+
     cComponent::setCheckSignals(opt->checkSignals);
+    cOwnedObject::setOwnerListTracking(opt->ownerListTracking);
 
     // run RNG self-test on RNG class selected for this run
     cRNG *testRng = createByClassName<cRNG>(opt->rngClass.c_str(), "random number generator");
@@ -1459,6 +1482,13 @@ void EnvirBase::readPerRunOptions()
     for (int i = 0; i < numRNGs; i++)
         delete rngs[i];
     delete[] rngs;
+    for (cRNG *rng : componentRngs)
+        delete rng;
+    componentRngs.clear();
+    componentRngKeys.clear();
+    freeComponentRngSlots.clear();
+    componentRngSlots.clear();
+    componentPathInstances.clear();
 
     numRNGs = opt->numRNGs;
     rngs = new cRNG *[numRNGs];
@@ -1478,6 +1508,42 @@ void EnvirBase::readPerRunOptions()
     recordEventlog = cfg->getAsBool(CFGID_RECORD_EVENTLOG);
 }
 
+void EnvirBase::switchToActiveRun()
+{
+    cConfiguration *cfg = getConfig();
+
+    // time limits and seeds may differ among runs that share the network setup
+    opt->realTimeLimit = cfg->getAsDouble(CFGID_REAL_TIME_LIMIT, -1);
+    opt->cpuTimeLimit = cfg->getAsDouble(CFGID_CPU_TIME_LIMIT, -1);
+    stopwatch.setCPUTimeLimit(opt->cpuTimeLimit);
+    stopwatch.setRealTimeLimit(opt->realTimeLimit);
+
+    // re-seed RNGs in place, as components refer to them by index
+    opt->seedset = cfg->getAsInt(CFGID_SEED_SET);
+    for (int i = 0; i < numRNGs; i++)
+        rngs[i]->initialize(opt->seedset, i, numRNGs, getParsimProcId(), getParsimNumPartitions(), cfg);
+    for (size_t i = 0; i < componentRngs.size(); i++)
+        if (componentRngs[i])
+            componentRngs[i]->initializeStream(opt->seedset, componentRngKeys[i].first, componentRngKeys[i].second, cfg);
+
+    // keep the fingerprint calculated so far, and check it against the expected
+    // fingerprints of this run; it matches the fingerprint of the run simulated
+    // from the start if the simulation so far did not depend on the seeds
+    cFingerprintCalculator *fingerprint = getSimulation()->getFingerprintCalculator();
+    if (fingerprint) {
+        std::string expectedFingerprints = cfg->getAsString(CFGID_FINGERPRINT);
+        if (expectedFingerprints.empty())
+            getSimulation()->setFingerprintCalculator(nullptr);
+        else
+            fingerprint->setExpectedFingerprints(expectedFingerprints.c_str());
+    }
+
+    // let result file names follow the new run (files are only opened on first write)
+    outvectorManager->startRun();
+    outScalarManager->startRun();
+    snapshotManager->startRun();
+}
+
 int EnvirBase::parseSimtimeResolution(const char *resolution)
 {
     try {
@@ -1549,17 +1615,28 @@ int EnvirBase::getNumRNGs() const
 
 cRNG *EnvirBase::getRNG(int k)
 {
+    if (k < 0 && -1-k < (int)componentRngs.size() && componentRngs[-1-k])
+        return componentRngs[-1-k];  // per-component stream
     if (k < 0 || k >= numRNGs)
         throw cRuntimeError("RNG index %d is out of range (num-rngs=%d, check the configuration)", k, numRNGs);
     return rngs[k];
 }
 
+// 64-bit FNV-1a; unlike std::hash, its value is the same on all platforms
+static uint64_t fnv1aHash64(const char *s)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for ( ; *s; s++)
+        hash = (hash ^ (unsigned char)*s) * 0x100000001b3ULL;
+    return hash;
+}
+
 void EnvirBase::setupRNGMapping(cComponent *component)
 {
     cConfigurationEx *cfg = getConfigEx();
     std::string componentFullPath = component->getFullPath();
     std::vector<const char *> suffixes = cfg->getMatchingPerObjectConfigKeySuffixes(componentFullPath.c_str(), "rng-*");  // CFGID_RNG_K
-    if (suffixes.empty())
+    if (suffixes.empty() && !opt->componentRngStreams)
         return;
 
     // extract into tmpmap[]
@@ -1607,6 +1684,41 @@ void EnvirBase::setupRNGMapping(cComponent *component)
         }
     }
 
+    // with per-component streams, map each local RNG to a stream of its own,
+    // keyed by the component's full path and the local RNG index. A component
+    // created with the same full path as an earlier one (e.g. a dynamically
+    // created module replacing a deleted one) also gets its instance number
+    // mixed into the key, so that it does not replay the earlier one's numbers.
+    if (opt->componentRngStreams) {
+        while (mapsize < numRNGs) {
+            tmpmap[mapsize] = mapsize;
+            mapsize++;
+        }
+        uint64_t streamKey = fnv1aHash64(componentFullPath.c_str());
+        int instance = componentPathInstances[streamKey]++;
+        if (instance > 0)
+            streamKey = fnv1aHash64((componentFullPath + "#" + std::to_string(instance)).c_str());
+        std::vector<int>& slots = componentRngSlots[component];
+        for (int i = 0; i < mapsize; i++) {
+            cRNG *rng = createByClassName<cRNG>(opt->rngClass.c_str(), "random number generator");
+            rng->initializeStream(opt->seedset, streamKey, i, getConfig());
+            int slot;
+            if (freeComponentRngSlots.empty()) {
+                slot = componentRngs.size();
+                componentRngs.push_back(rng);
+                componentRngKeys.push_back(std::make_pair(streamKey, i));
+            }
+            else {
+                slot = freeComponentRngSlots.back();
+                freeComponentRngSlots.pop_back();
+                componentRngs[slot] = rng;
+                componentRngKeys[slot] = std::make_pair(streamKey, i);
+            }
+            slots.push_back(slot);
+            tmpmap[i] = -1-slot;
+        }
+    }
+
     // install map into the module
     if (mapsize > 0) {
         int *map = new int[mapsize];
@@ -1615,6 +1727,19 @@ void EnvirBase::setupRNGMapping(cComponent *component)
     }
 }
 
+void EnvirBase::releaseComponentRngs(cComponent *component)
+{
+    auto it = componentRngSlots.find(component);
+    if (it == componentRngSlots.end())
+        return;
+    for (int slot : it->second) {
+        delete componentRngs[slot];
+        componentRngs[slot] = nullptr;
+        freeComponentRngSlots.push_back(slot);
+    }
+    componentRngSlots.erase(it);
+}
+
 //-------------------------------------------------------------
 
 void *EnvirBase::registerOutputVector(const char *modulename, const char *vectorname)
@@ -2050,6 +2175,13 @@ void EnvirBase::checkFingerprint()
                 fingerprint->str().c_str(), cfg->getAsString(CFGID_FINGERPRINT).c_str());
 }
 
+void EnvirBase::printProfilingReport()
+{
+    cEventProfiler *profiler = getSimulation()->getEventProfiler();
+    if (profiler)
+        profiler->printReport(out);
+}
+
 cModuleType *EnvirBase::resolveNetwork(const char *networkname)
 {
     cModuleType *network = nullptr;
@@ -22,6 +22,7 @@
 #ifndef __OMNETPP_ENVIR_ENVIRBASE_H
 #define __OMNETPP_ENVIR_ENVIRBASE_H
 
+#include <unordered_map>
 #include "omnetpp/carray.h"
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cchannel.h"
@@ -92,6 +93,7 @@ struct ENVIR_API EnvirOptions
     int numRNGs;
     std::string rngClass;
     int seedset; // which set of seeds to use
+    bool componentRngStreams;
 
     std::string schedulerClass;
     std::string eventlogManagerClass;
@@ -107,6 +109,7 @@ struct ENVIR_API EnvirOptions
 
     bool debugStatisticsRecording;
     bool checkSignals;
+    bool ownerListTracking;
     bool fnameAppendHost;
 
     bool useStderr;
@@ -147,6 +150,15 @@ class ENVIR_API EnvirBase : public cRunnableEnvir
     int numRNGs;
     cRNG **rngs;
 
+    // Per-component RNG streams (component-rng-streams=true); component RNG maps
+    // refer to them with negative indices (-1-index). Slots of deleted components
+    // are nullptr, and get reused for new components.
+    std::vector<cRNG *> componentRngs;
+    std::vector<std::pair<uint64_t,int>> componentRngKeys; // stream key and local RNG index of componentRngs[i]
+    std::vector<int> freeComponentRngSlots;
+    std::unordered_map<cComponent *, std::vector<int>> componentRngSlots; // slots used by each component
+    std::unordered_map<uint64_t, int> componentPathInstances; // number of components created so far with a given full path (hash)
+
     // log related
     LogFormatter logFormatter;
     bool logFormatUsesEventName;
@@ -323,6 +335,11 @@ class ENVIR_API EnvirBase : public cRunnableEnvir
     virtual EnvirOptions *createOptions() {return new EnvirOptions();}
     virtual void readOptions();
     virtual void readPerRunOptions();
+
+    // Re-seeds the RNGs and restarts result recording according to the currently
+    // active run, keeping the network and its state. Used by forked runs, where
+    // a child process continues a simulation set up under another run number.
+    virtual void switchToActiveRun();
     int parseSimtimeResolution(const char *resolution);
 
     // Utility function; never returns nullptr
@@ -338,8 +355,12 @@ class ENVIR_API EnvirBase : public cRunnableEnvir
     // Utility function: checks simulation fingerprint and displays a message accordingly
     void checkFingerprint();
 
+    // Utility function: prints the results of the event profiler, if enabled
+    void printProfilingReport();
+
     // Set up RNG mapping for the component
     virtual void setupRNGMapping(cComponent *component);
+    virtual void releaseComponentRngs(cComponent *component);
 
     // Utility function for getXMLDocument() and getParsedXMLString()
     cXMLElement *resolveXMLPath(cXMLElement *documentnode, const char *path);
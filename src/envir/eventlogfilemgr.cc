@@ -307,7 +307,7 @@ void EventlogFileManager::recordMessages()
 void EventlogFileManager::recordModules(cModule *module)
 {
     moduleCreated(module);
-    for (cModule::GateIterator it(module); !it.end(); ++it)
+    for (cModule::GateIterator it(module, false); !it.end(); ++it)
         gateCreated(*it);
     displayStringChanged(module);
     for (cModule::SubmoduleIterator it(module); !it.end(); ++it)
@@ -316,7 +316,7 @@ void EventlogFileManager::recordModules(cModule *module)
 
 void EventlogFileManager::recordConnections(cModule *module)
 {
-    for (cModule::GateIterator it(module); !it.end(); ++it) {
+    for (cModule::GateIterator it(module, false); !it.end(); ++it) {
         cGate *gate = *it;
         if (gate->getNextGate())
             connectionCreated(gate);
@@ -55,8 +55,12 @@ Register_Class(OmnetppOutputScalarManager);
 
 void OmnetppOutputScalarManager::startRun()
 {
-    // prevent reuse of object for multiple runs
-    Assert(state == NEW);
+    // prevent reuse of object for multiple runs; being started again before
+    // anything was written is allowed, and retargets it to the active run
+    // (see EnvirBase::switchToActiveRun())
+    if (state == OPENED)
+        throw cRuntimeError("Cannot switch to another run, results have already been written to output scalar file '%s'", fname.c_str());
+    Assert(state == NEW || state == STARTED);
     state = STARTED;
 
     // delete file left over from previous runs
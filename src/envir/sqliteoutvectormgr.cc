@@ -50,12 +50,20 @@ extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING;
 extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING_INTERVALS;
 extern omnetpp::cConfigOption *CFGID_VECTOR_BUFFER;
 
-Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_INDEXING, "output-vector-db-indexing", CFG_CUSTOM, "skip", "Whether and when to add an index to the 'vectordata' table in SQLite output vector files. Possible values: skip, ahead, after");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_INDEXING, "output-vector-db-indexing", CFG_CUSTOM, "skip", "Whether and when to add an index to the 'vectordata' table in SQLite output vector files. Possible values: skip, ahead, after, clustered. `clustered` creates the table as a WITHOUT ROWID table ordered by (vectorId, eventNumber), which needs no separate index; writing is slower, but there is no indexing step at the end.");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_PAGE_SIZE, "output-vector-db-page-size", CFG_INT, "16384", "Page size of newly created SQLite output vector files, in bytes. Must be a power of two between 512 and 65536.");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_JOURNAL_MODE, "output-vector-db-journal-mode", CFG_CUSTOM, "truncate", "SQLite journal mode to use while writing output vector files. Possible values: delete, truncate, persist, memory, wal, off. Files are switched back to `delete` mode when closed.");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_SYNCHRONOUS, "output-vector-db-synchronous", CFG_CUSTOM, "off", "SQLite synchronous mode to use while writing output vector files. Possible values: off, normal, full. `off` is the fastest, but the file may become corrupted if the operating system crashes during the simulation.");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_INSERT_BATCH_SIZE, "output-vector-db-insert-batch-size", CFG_INT, "100", "The number of samples to write with one multi-row INSERT statement into SQLite output vector files; 1 means one statement per sample. The value is capped by SQLite's limit on the number of statement parameters.");
 
 void SqliteOutputVectorManager::startRun()
 {
-    // prevent reuse of object for multiple runs
-    Assert(state == NEW);
+    // prevent reuse of object for multiple runs; being started again before
+    // anything was written is allowed, and retargets it to the active run
+    // (see EnvirBase::switchToActiveRun())
+    if (state == OPENED)
+        throw cRuntimeError("Cannot switch to another run, results have already been written to output vector file '%s'", fname.c_str());
+    Assert(state == NEW || state == STARTED);
     state = STARTED;
 
     // delete file left over from previous runs
@@ -76,9 +84,36 @@ void SqliteOutputVectorManager::startRun()
         indexingMode = INDEX_AHEAD;
     else if (indexModeStr == "after")
         indexingMode = INDEX_AFTER;
+    else if (indexModeStr == "clustered")
+        indexingMode = INDEX_CLUSTERED;
     else
-        throw cRuntimeError("Invalid value '%s' for '%s', expecting 'skip', 'ahead' or 'after'",
+        throw cRuntimeError("Invalid value '%s' for '%s', expecting 'skip', 'ahead', 'after' or 'clustered'",
                 indexModeStr.c_str(), CFGID_OUTPUT_VECTOR_DB_INDEXING->getName());
+    writer.setClusteredTable(indexingMode == INDEX_CLUSTERED);
+
+    int pageSize = getEnvir()->getConfig()->getAsInt(CFGID_OUTPUT_VECTOR_DB_PAGE_SIZE);
+    if (pageSize < 512 || pageSize > 65536 || (pageSize & (pageSize-1)) != 0)
+        throw cRuntimeError("Invalid value %d for '%s', expecting a power of two between 512 and 65536",
+                pageSize, CFGID_OUTPUT_VECTOR_DB_PAGE_SIZE->getName());
+    writer.setPageSize(pageSize);
+
+    std::string journalMode = getEnvir()->getConfig()->getAsCustom(CFGID_OUTPUT_VECTOR_DB_JOURNAL_MODE);
+    if (journalMode != "delete" && journalMode != "truncate" && journalMode != "persist" && journalMode != "memory" && journalMode != "wal" && journalMode != "off")
+        throw cRuntimeError("Invalid value '%s' for '%s', expecting 'delete', 'truncate', 'persist', 'memory', 'wal' or 'off'",
+                journalMode.c_str(), CFGID_OUTPUT_VECTOR_DB_JOURNAL_MODE->getName());
+    writer.setJournalMode(journalMode.c_str());
+
+    std::string synchronousMode = getEnvir()->getConfig()->getAsCustom(CFGID_OUTPUT_VECTOR_DB_SYNCHRONOUS);
+    if (synchronousMode != "off" && synchronousMode != "normal" && synchronousMode != "full")
+        throw cRuntimeError("Invalid value '%s' for '%s', expecting 'off', 'normal' or 'full'",
+                synchronousMode.c_str(), CFGID_OUTPUT_VECTOR_DB_SYNCHRONOUS->getName());
+    writer.setSynchronousMode(synchronousMode.c_str());
+
+    int insertBatchSize = getEnvir()->getConfig()->getAsInt(CFGID_OUTPUT_VECTOR_DB_INSERT_BATCH_SIZE);
+    if (insertBatchSize < 1)
+        throw cRuntimeError("Invalid value %d for '%s', must be at least 1",
+                insertBatchSize, CFGID_OUTPUT_VECTOR_DB_INSERT_BATCH_SIZE->getName());
+    writer.setInsertBatchSize(insertBatchSize);
 }
 
 void SqliteOutputVectorManager::endRun()
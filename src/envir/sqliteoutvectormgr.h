@@ -55,7 +55,7 @@ class SqliteOutputVectorManager : public cIOutputVectorManager
     SqliteVectorFileWriter writer;
     Vectors vectors;  // registered output vectors
 
-    enum IndexingMode { INDEX_AHEAD, INDEX_AFTER, INDEX_NONE } indexingMode = INDEX_AFTER;
+    enum IndexingMode { INDEX_AHEAD, INDEX_AFTER, INDEX_CLUSTERED, INDEX_NONE } indexingMode = INDEX_AFTER;
 
   protected:
     virtual void openFileForRun();
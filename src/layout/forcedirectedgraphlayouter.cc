@@ -50,6 +50,8 @@ ForceDirectedGraphLayouter::ForceDirectedGraphLayouter()
     expectedEdgeLength = -1;
     pointLikeDistance = true;
     slippery = false;
+    barnesHutThreshold = 500;
+    barnesHutTheta = 0.8;
 }
 
 ForceDirectedGraphLayouter::~ForceDirectedGraphLayouter()
@@ -74,6 +76,8 @@ void ForceDirectedGraphLayouter::setParameters()
     // various algorithm parameters
     embedding.parameters.defaultSlippery = environment->getBoolParameter("sp", 0, slippery);
     embedding.parameters.defaultPointLikeDistance = environment->getBoolParameter("pld", 0, pointLikeDistance);
+    barnesHutThreshold = environment->getLongParameter("bhn", 0, barnesHutThreshold);
+    barnesHutTheta = environment->getDoubleParameter("bht", 0, barnesHutTheta);
     embedding.parameters.defaultSpringCoefficient = environment->getDoubleParameter("sc", 0, privUniform(0.1, 1));
     embedding.parameters.defaultSpringReposeLength = environment->getDoubleParameter("srl", 0, privUniform(expectedEdgeLength / 2, expectedEdgeLength));
     embedding.parameters.electricRepulsionCoefficient = environment->getDoubleParameter("erc", 0, privUniform(10000, 100000));
@@ -268,6 +272,26 @@ void ForceDirectedGraphLayouter::setBorderPositions()
 void ForceDirectedGraphLayouter::addElectricRepulsions()
 {
     const std::vector<IBody *>& bodies = embedding.getBodies();
+
+    std::vector<IBody *> charges;
+    for (auto body : bodies)
+        if (!dynamic_cast<WallBody *>(body))
+            charges.push_back(body);
+
+    if ((int)charges.size() > barnesHutThreshold) {
+        // number the connected subcomponents for the component ids
+        std::map<GraphComponent *, int> componentIds;
+        std::vector<int> chargeComponentIds;
+        for (auto body : charges) {
+            Vertex *vertex = graphComponent.findVertex(body->getVariable());
+            Assert(vertex);
+            auto it = componentIds.insert(std::make_pair(vertex->connectedSubComponent, (int)componentIds.size())).first;
+            chargeComponentIds.push_back(it->second);
+        }
+        embedding.addForceProvider(new BarnesHutElectricRepulsion(charges, chargeComponentIds, barnesHutTheta, expectedEdgeLength / 2, expectedEdgeLength));
+        return;
+    }
+
     for (int i = 0; i < (int)bodies.size(); i++)
         for (int j = i + 1; j < (int)bodies.size(); j++) {
             IBody *body1 = bodies[i];
@@ -97,6 +97,14 @@ class LAYOUT_API ForceDirectedGraphLayouter : public GraphLayouter
     bool slippery;
     bool pointLikeDistance;
 
+    /**
+     * Above this many bodies, electric repulsion is computed with the Barnes-Hut
+     * approximation (see BarnesHutElectricRepulsion) instead of pairwise force
+     * providers; barnesHutTheta is the accuracy parameter of the approximation.
+     */
+    int barnesHutThreshold;
+    double barnesHutTheta;
+
     // border bodies will be added if there are either
     // fixed nodes or edges connected to the border
     // or the width or the height of the bounding box is specified
@@ -170,6 +178,8 @@ class LAYOUT_API ForceDirectedGraphLayouter : public GraphLayouter
     /**
      * Adds electric repulsions between bodies. Bodies being part of different connected
      * subcomponents will have a finite repulsion range determined by default spring repose length.
+     * Above barnesHutThreshold bodies, a single BarnesHutElectricRepulsion is added instead
+     * of one ElectricRepulsion per pair.
      */
     void addElectricRepulsions();
 
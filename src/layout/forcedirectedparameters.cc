@@ -14,11 +14,262 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <algorithm>
 #include "forcedirectedparameters.h"
 
 namespace omnetpp {
 namespace layout {
 
+// cells with at most this many bodies are not subdivided further
+static const int BARNESHUT_LEAF_SIZE = 8;
+
+// limits the depth of the quadtree when many bodies are at the same position
+static const int BARNESHUT_MAX_DEPTH = 32;
+
+BarnesHutElectricRepulsion::BarnesHutElectricRepulsion(const std::vector<IBody *>& bodies, const std::vector<int>& componentIds, double theta, double linearityDistance, double maxDistance, int slippery) : AbstractForceProvider(slippery)
+{
+    Assert(bodies.size() == componentIds.size());
+    this->bodies = bodies;
+    this->componentIds = componentIds;
+    this->theta = theta;
+    this->linearityDistance = linearityDistance;
+    this->maxDistance = maxDistance;
+    numComponents = componentIds.empty() ? 0 : *std::max_element(componentIds.begin(), componentIds.end()) + 1;
+    allRoot = -1;
+    maxBodyExtent = 0;
+}
+
+void BarnesHutElectricRepulsion::reinitialize()
+{
+    AbstractForceProvider::reinitialize();
+    if (linearityDistance == -1)
+        linearityDistance = embedding->parameters.defaultElectricRepulsionLinearityDistance;
+    if (maxDistance == -1)
+        maxDistance = embedding->parameters.defaultElectricRepulsionMaxDistance;
+}
+
+void BarnesHutElectricRepulsion::buildTrees()
+{
+    int n = bodies.size();
+    positions.resize(n);
+    maxBodyExtent = 0;
+    for (int i = 0; i < n; i++) {
+        positions[i] = bodies[i]->getPosition();
+        const Rs& size = bodies[i]->getSize();
+        maxBodyExtent = std::max(maxBodyExtent, std::sqrt(size.width * size.width + size.height * size.height) / 2);
+    }
+
+    // first half: grouped by component (counting sort), second half: all bodies
+    bodyOrder.resize(2 * n);
+    std::vector<int> componentBegins(numComponents + 1, 0);
+    for (int i = 0; i < n; i++)
+        componentBegins[componentIds[i] + 1]++;
+    for (int c = 0; c < numComponents; c++)
+        componentBegins[c + 1] += componentBegins[c];
+    std::vector<int> next(componentBegins.begin(), componentBegins.end() - 1);
+    for (int i = 0; i < n; i++) {
+        bodyOrder[next[componentIds[i]]++] = i;
+        bodyOrder[n + i] = i;
+    }
+
+    cells.clear();
+    allRoot = buildTree(n, 2 * n);
+    componentRoots.assign(numComponents, -1);
+    if (isRangeLimited())
+        for (int c = 0; c < numComponents; c++)
+            componentRoots[c] = buildTree(componentBegins[c], componentBegins[c + 1]);
+}
+
+int BarnesHutElectricRepulsion::buildTree(int begin, int end)
+{
+    if (begin == end)
+        return -1;
+
+    double left = POSITIVE_INFINITY, top = POSITIVE_INFINITY, right = NEGATIVE_INFINITY, bottom = NEGATIVE_INFINITY;
+    for (int k = begin; k < end; k++) {
+        const Pt& pt = positions[bodyOrder[k]];
+        left = std::min(left, pt.x);
+        top = std::min(top, pt.y);
+        right = std::max(right, pt.x);
+        bottom = std::max(bottom, pt.y);
+    }
+
+    return buildCell(begin, end, left, top, std::max(right - left, bottom - top), 0);
+}
+
+int BarnesHutElectricRepulsion::buildCell(int begin, int end, double x, double y, double size, int depth)
+{
+    Cell cell;
+    cell.x = x;
+    cell.y = y;
+    cell.size = size;
+    cell.begin = begin;
+    cell.end = end;
+    std::fill(cell.children, cell.children + 4, -1);
+    cell.leaf = end - begin <= BARNESHUT_LEAF_SIZE || depth >= BARNESHUT_MAX_DEPTH;
+    cell.charge = 0;
+    cell.center = Pt::getZero();
+
+    if (cell.leaf) {
+        for (int k = begin; k < end; k++) {
+            int i = bodyOrder[k];
+            double charge = bodies[i]->getCharge();
+            cell.charge += charge;
+            cell.center.add(Pt(positions[i]).multiply(charge));
+        }
+    }
+    else {
+        // split into quadrants: first by y, then both halves by x
+        double half = size / 2;
+        double midX = x + half, midY = y + half;
+        auto first = bodyOrder.begin() + begin, last = bodyOrder.begin() + end;
+        auto isAbove = [&](int i) { return positions[i].y < midY; };
+        auto isLeft = [&](int i) { return positions[i].x < midX; };
+        auto splitY = std::partition(first, last, isAbove);
+        auto splitTopX = std::partition(first, splitY, isLeft);
+        auto splitBottomX = std::partition(splitY, last, isLeft);
+
+        int bounds[5] = { begin, (int)(splitTopX - bodyOrder.begin()), (int)(splitY - bodyOrder.begin()), (int)(splitBottomX - bodyOrder.begin()), end };
+        double offsets[4][2] = { {0, 0}, {half, 0}, {0, half}, {half, half} };
+        for (int q = 0; q < 4; q++) {
+            if (bounds[q] == bounds[q + 1])
+                continue;
+            // note: cells may be reallocated by the recursive call, so no references into it are kept
+            int child = buildCell(bounds[q], bounds[q + 1], x + offsets[q][0], y + offsets[q][1], half, depth + 1);
+            cell.children[q] = child;
+            cell.charge += cells[child].charge;
+            cell.center.add(Pt(cells[child].center).multiply(cells[child].charge));
+        }
+    }
+
+    if (cell.charge != 0)
+        cell.center.divide(cell.charge);
+    else
+        cell.center = positions[bodyOrder[begin]];
+
+    cells.push_back(cell);
+    return cells.size() - 1;
+}
+
+double BarnesHutElectricRepulsion::computePairForce(int i, int j, bool rangeLimited, Pt& force)
+{
+    IBody *charge1 = bodies[i];
+    IBody *charge2 = bodies[j];
+    if (charge1->getVariable() == charge2->getVariable())
+        return 0;
+
+    double distance;
+    Pt vector = getDistanceAndVector(charge1, charge2, distance);
+    Assert(distance >= 0);
+
+    // same as in AbstractElectricRepulsion
+    double potential = embedding->parameters.electricRepulsionCoefficient * charge1->getCharge() * charge2->getCharge();
+    double power;
+    if (distance == 0)
+        power = maxForce;
+    else
+        power = getValidForce(potential / distance / distance);
+
+    if (rangeLimited && linearityDistance != -1 && distance > linearityDistance)
+        power *= 1 - std::min(1.0, (distance - linearityDistance) / (maxDistance - linearityDistance));
+
+    vector.multiply(power);
+    if (vector.isFullySpecified())
+        force.add(vector);
+
+    return potential / distance;
+}
+
+double BarnesHutElectricRepulsion::computeForce(int i, Pt& force)
+{
+    const Pt& position = positions[i];
+    double charge = bodies[i]->getCharge();
+    double coefficient = embedding->parameters.electricRepulsionCoefficient;
+    double energy = 0;
+    bool rangeLimited = isRangeLimited();
+
+    // unlimited repulsion from the bodies of the same component, with the Barnes-Hut approximation
+    stack.clear();
+    stack.push_back(rangeLimited ? componentRoots[componentIds[i]] : allRoot);
+    while (!stack.empty()) {
+        const Cell& cell = cells[stack.back()];
+        stack.pop_back();
+
+        if (cell.leaf) {
+            for (int k = cell.begin; k < cell.end; k++)
+                if (bodyOrder[k] != i)
+                    energy += computePairForce(i, bodyOrder[k], false, force);
+            continue;
+        }
+
+        // never approximate a cell the body is in, as that would include itself
+        bool inside = cell.x <= position.x && position.x <= cell.x + cell.size && cell.y <= position.y && position.y <= cell.y + cell.size;
+        Pt vector = Pt(position).subtract(cell.center);
+        double distance = vector.getLength();
+        if (!inside && distance > 0 && cell.size < theta * distance) {
+            vector.divide(distance);
+            // limit the force as if it came from count bodies of average charge
+            int count = cell.end - cell.begin;
+            double power = count * getValidForce(coefficient * charge * cell.charge / count / distance / distance);
+            force.add(vector.multiply(power));
+            energy += coefficient * charge * cell.charge / distance;
+        }
+        else {
+            for (int child : cell.children)
+                if (child != -1)
+                    stack.push_back(child);
+        }
+    }
+
+    // range limited repulsion from the bodies of other components, computed exactly
+    if (rangeLimited) {
+        double range = maxDistance + 2 * maxBodyExtent;
+        stack.push_back(allRoot);
+        while (!stack.empty()) {
+            const Cell& cell = cells[stack.back()];
+            stack.pop_back();
+
+            if (position.x < cell.x - range || position.x > cell.x + cell.size + range ||
+                position.y < cell.y - range || position.y > cell.y + cell.size + range)
+                continue;
+
+            if (cell.leaf) {
+                for (int k = cell.begin; k < cell.end; k++)
+                    if (componentIds[bodyOrder[k]] != componentIds[i])
+                        energy += computePairForce(i, bodyOrder[k], true, force);
+            }
+            else {
+                for (int child : cell.children)
+                    if (child != -1)
+                        stack.push_back(child);
+            }
+        }
+    }
+
+    return energy;
+}
+
+void BarnesHutElectricRepulsion::applyForces()
+{
+    buildTrees();
+    for (int i = 0; i < (int)bodies.size(); i++) {
+        Pt force = Pt::getZero();
+        computeForce(i, force);
+        bodies[i]->getVariable()->addForce(force);
+    }
+}
+
+double BarnesHutElectricRepulsion::getPotentialEnergy()
+{
+    buildTrees();
+    double energy = 0;
+    for (int i = 0; i < (int)bodies.size(); i++) {
+        Pt force = Pt::getZero();
+        energy += computeForce(i, force);
+    }
+    return energy / 2;  // every pair was counted from both sides
+}
+
 } // namespace layout
 }  // namespace omnetpp
 
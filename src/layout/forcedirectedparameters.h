@@ -18,6 +18,7 @@
 #define __OMNETPP_LAYOUT_FORCEDIRECTEDPARAMETERS_H
 
 #include <cmath>
+#include <vector>
 #include "geometry.h"
 #include "forcedirectedparametersbase.h"
 #include "forcedirectedembedding.h"
@@ -421,6 +422,86 @@ class HorizontalElectricRepulsion : public AbstractElectricRepulsion {
         }
 };
 
+/**
+ * Electric repulsion between all pairs of a set of bodies, approximated with the
+ * Barnes-Hut algorithm. Instead of an ElectricRepulsion for every pair, which is
+ * O(n^2) both in memory and in time per step, the bodies are put into a quadtree
+ * (by their base plane projection) every time forces are applied, and a group of
+ * distant bodies acts on a body as a single charge placed in their center of
+ * charge. A quadtree cell counts as distant if its size divided by its distance
+ * from the body is less than theta: 0 gives the exact result, larger values are
+ * faster but less accurate.
+ *
+ * Bodies sharing the same variable do not repel each other (except when approximated
+ * as part of a distant group). Bodies with different component ids only repel each
+ * other within maxDistance, decreasing linearly above linearityDistance, like the
+ * range limited ElectricRepulsion; being short range, these are computed exactly.
+ */
+class LAYOUT_API BarnesHutElectricRepulsion : public AbstractForceProvider {
+    protected:
+        struct Cell {
+            double x, y;        // top left corner
+            double size;        // side length of the square
+            int begin, end;     // range in bodyOrder
+            int children[4];    // indices into cells, or -1
+            bool leaf;
+            double charge;      // total charge of the bodies in the cell
+            Pt center;          // center of charge
+        };
+
+        std::vector<IBody *> bodies;
+
+        std::vector<int> componentIds;
+
+        int numComponents;
+
+        double theta;
+
+        double linearityDistance;
+
+        double maxDistance;
+
+        // the quadtrees, rebuilt from the current positions in every applyForces() call:
+        // one per component, and one for all bodies (in the second half of bodyOrder)
+        std::vector<Pt> positions;
+        std::vector<int> bodyOrder;
+        std::vector<Cell> cells;
+        std::vector<int> componentRoots;
+        int allRoot;
+        double maxBodyExtent;
+        std::vector<int> stack;
+
+    public:
+        /**
+         * Component ids must be in the range 0..n-1. Use the same id for all bodies
+         * to make all pairs repel each other without a range limit.
+         */
+        BarnesHutElectricRepulsion(const std::vector<IBody *>& bodies, const std::vector<int>& componentIds, double theta, double linearityDistance = -1, double maxDistance = -1, int slippery = -1);
+
+        virtual void reinitialize() override;
+
+        virtual const char *getClassName() override {
+            return "BarnesHutElectricRepulsion";
+        }
+
+        virtual void applyForces() override;
+
+        virtual double getPotentialEnergy() override;
+
+    protected:
+        bool isRangeLimited() {
+            return numComponents > 1 && maxDistance != -1;
+        }
+
+        void buildTrees();
+        int buildCell(int begin, int end, double x, double y, double size, int depth);
+        int buildTree(int begin, int end);
+
+        // returns the potential energy of body i in the field of the others
+        double computeForce(int i, Pt& force);
+        double computePairForce(int i, int j, bool rangeLimited, Pt& force);
+};
+
 /**
  * An attractive force which increases in a linear way proportional to the distance of the bodies.
  * Abstract base class for spring attractive forces.
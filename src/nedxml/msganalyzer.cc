@@ -309,6 +309,7 @@ void MsgAnalyzer::analyzeClassOrStruct(ClassInfo& classInfo, const std::string&
     classInfo.generateClass = opts.generateClasses && !existingClass;
     classInfo.generateDescriptor = opts.generateDescriptors && !classInfo.isOpaque && getPropertyAsBool(classInfo.props, PROP_DESCRIPTOR, true); // opaque also means no descriptor
     classInfo.generateSettersInDescriptor = opts.generateSettersInDescriptors && (getProperty(classInfo.props, PROP_DESCRIPTOR) != "readonly");
+    classInfo.compactPacking = getPropertyAsBool(classInfo.props, PROP_COMPACTPACKING, true);
 
     if (!existingClass && isQualified(classInfo.name))
         errors->addError(classInfo.astNode, "class name may only contain '::' when generating descriptor for an existing class");
@@ -116,6 +116,7 @@ class NEDXML_API MsgAnalyzer
     static constexpr const char* PROP_BEFORECHANGE = "beforeChange";
     static constexpr const char* PROP_IMPLEMENTS = "implements";
     static constexpr const char* PROP_NOPACK = "nopack";
+    static constexpr const char* PROP_COMPACTPACKING = "compactPacking";
     static constexpr const char* PROP_OWNED = "owned";
     static constexpr const char* PROP_EDITABLE = "editable";
     static constexpr const char* PROP_REPLACEABLE = "replaceable";
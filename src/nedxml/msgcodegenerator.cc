@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <set>
 
 #include "common/stringutil.h"
 #include "common/stlutil.h"
@@ -544,6 +545,52 @@ inline std::string forEachIndex(const MsgTypeTable::FieldInfo& field)
     return str("    for (") + field.sizeType + " i = 0; i < " + field.sizeVar + "; i++)";
 }
 
+// C++ types whose values can be packed as raw memory in the compact parsim layout
+static const std::set<std::string> TRIVIALLY_PACKABLE_TYPES = {
+    "bool", "float", "double", "char", "short", "int", "long",
+    "unsigned char", "unsigned short", "unsigned int", "unsigned long",
+    "int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t"
+};
+
+static bool isTriviallyPackable(const MsgTypeTable::FieldInfo& field)
+{
+    return !field.isPointer && !field.isConst && !field.nopack && !field.isAbstract && !field.isCustom && contains(TRIVIALLY_PACKABLE_TYPES, field.dataType);
+}
+
+// Returns the index after the last field of the run of consecutive fields
+// starting at index i that can be packed as a single raw memory block, or i
+// if there is no such run. Data members are declared in field order, so the
+// members of a run are laid out in memory in increasing address order.
+static int findCompactPackingRun(const MsgTypeTable::ClassInfo& classInfo, int i)
+{
+    if (!classInfo.compactPacking)
+        return i;
+    const auto& fields = classInfo.fieldList;
+    int end = i;
+    while (end < (int)fields.size() && isTriviallyPackable(fields[end]) && !fields[end].isDynamicArray)
+        end++;
+    if (end == i+1 && !fields[i].isFixedArray)
+        return i;  // a single scalar is not worth a block
+    return end;
+}
+
+static bool hasCompactPacking(const MsgTypeTable::ClassInfo& classInfo)
+{
+    for (int i = 0; i < (int)classInfo.fieldList.size(); i++) {
+        const auto& field = classInfo.fieldList[i];
+        if (findCompactPackingRun(classInfo, i) != i || (classInfo.compactPacking && field.isDynamicArray && isTriviallyPackable(field)))
+            return true;
+    }
+    return false;
+}
+
+// arguments of packBytes()/unpackBytes() for the memory block of fields [first,last]
+static std::string compactBlockArgs(const std::string& prefix, const MsgTypeTable::FieldInfo& first, const MsgTypeTable::FieldInfo& last)
+{
+    std::string begin = str("&") + prefix + first.var;
+    return begin + ", (int)((const char *)(&" + prefix + last.var + " + 1) - (const char *)" + begin + ")";
+}
+
 void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
 {
     std::string maybe_handleChange_line = classInfo.beforeChange.empty() ? "" : (str("    ") + classInfo.beforeChange + ";\n");
@@ -739,7 +786,17 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "    doParsimPacking(b,(::" << classInfo.baseClass << "&)*this);\n";  // this would do for cOwnedObject too, but the other is nicer
         }
     }
-    for (const auto& field : classInfo.fieldList) {
+    bool compact = hasCompactPacking(classInfo);
+    if (compact)
+        CC << "    b->packLayoutTag(sizeof(" << classInfo.className << "));\n";
+    for (int i = 0; i < (int)classInfo.fieldList.size(); ) {
+        int runEnd = findCompactPackingRun(classInfo, i);
+        if (runEnd != i) {
+            CC << "    b->packBytes(" << compactBlockArgs("this->", classInfo.fieldList[i], classInfo.fieldList[runEnd-1]) << ");\n";
+            i = runEnd;
+            continue;
+        }
+        const auto& field = classInfo.fieldList[i++];
         if (field.nopack)
             continue; // @nopack specified
         if (field.isAbstract || field.isCustom) {
@@ -749,7 +806,10 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             if (field.isArray) {
                 if (field.isDynamicArray)
                     CC << "    b->pack(" << field.sizeVar << ");\n";
-                CC << "    doParsimArrayPacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                if (compact && isTriviallyPackable(field))
+                    CC << "    b->packBytes(" << var(field) << ", (int)(" << field.sizeVar << " * sizeof(" << field.dataType << ")));\n";
+                else
+                    CC << "    doParsimArrayPacking(b," << var(field) << "," << field.sizeVar << ");\n";
             }
             else {
                 CC << "    doParsimPacking(b," << var(field) << ");\n";
@@ -770,7 +830,16 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "    doParsimUnpacking(b,(::" << classInfo.baseClass << "&)*this);\n";  // this would do for cOwnedObject too, but the other is nicer
         }
     }
-    for (const auto& field : classInfo.fieldList) {
+    if (compact)
+        CC << "    b->checkLayoutTag(sizeof(" << classInfo.className << "), \"" << classInfo.className << "\");\n";
+    for (int i = 0; i < (int)classInfo.fieldList.size(); ) {
+        int runEnd = findCompactPackingRun(classInfo, i);
+        if (runEnd != i) {
+            CC << "    b->unpackBytes(" << compactBlockArgs("this->", classInfo.fieldList[i], classInfo.fieldList[runEnd-1]) << ");\n";
+            i = runEnd;
+            continue;
+        }
+        const auto& field = classInfo.fieldList[i++];
         if (field.nopack)
             continue; // @nopack specified
         if (field.isAbstract || field.isCustom) {
@@ -788,7 +857,10 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
                     CC << "        " << var(field) << " = nullptr;\n";
                     CC << "    } else {\n";
                     CC << "        " << var(field) << " = new " << field.dataType << "[" << field.sizeVar << "];\n";
-                    CC << "        doParsimArrayUnpacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                    if (compact && isTriviallyPackable(field))
+                        CC << "        b->unpackBytes(" << var(field) << ", (int)(" << field.sizeVar << " * sizeof(" << field.dataType << ")));\n";
+                    else
+                        CC << "        doParsimArrayUnpacking(b," << var(field) << "," << field.sizeVar << ");\n";
                     CC << "    }\n";
                 }
             }
@@ -1048,7 +1120,17 @@ void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo)
     CC << "{\n";
     if (!classInfo.baseClass.empty())
         CC << "    doParsimPacking(b,(::" << classInfo.baseClass << "&)a);\n";
-    for (const auto& field : classInfo.fieldList) {
+    bool compact = hasCompactPacking(classInfo);
+    if (compact)
+        CC << "    b->packLayoutTag(sizeof(" << classInfo.className << "));\n";
+    for (int i = 0; i < (int)classInfo.fieldList.size(); ) {
+        int runEnd = findCompactPackingRun(classInfo, i);
+        if (runEnd != i) {
+            CC << "    b->packBytes(" << compactBlockArgs("a.", classInfo.fieldList[i], classInfo.fieldList[runEnd-1]) << ");\n";
+            i = runEnd;
+            continue;
+        }
+        const auto& field = classInfo.fieldList[i++];
         if (field.isCustom)
             continue;
         if (field.isArray)
@@ -1063,7 +1145,16 @@ void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo)
     CC << "{\n";
     if (!classInfo.baseClass.empty())
         CC << "    doParsimUnpacking(b,(::" << classInfo.baseClass << "&)a);\n";
-    for (const auto& field : classInfo.fieldList) {
+    if (compact)
+        CC << "    b->checkLayoutTag(sizeof(" << classInfo.className << "), \"" << classInfo.className << "\");\n";
+    for (int i = 0; i < (int)classInfo.fieldList.size(); ) {
+        int runEnd = findCompactPackingRun(classInfo, i);
+        if (runEnd != i) {
+            CC << "    b->unpackBytes(" << compactBlockArgs("a.", classInfo.fieldList[i], classInfo.fieldList[runEnd-1]) << ");\n";
+            i = runEnd;
+            continue;
+        }
+        const auto& field = classInfo.fieldList[i++];
         if (field.isCustom)
             continue;
         if (field.isArray)
@@ -57,6 +57,7 @@ const char *MsgCompiler::BUILTIN_DEFINITIONS =
         @property[beforeChange](type=string; usage=class; desc="Method to be called before mutator code (in setters, non-const getters, operator=, etc.).");
         @property[implements](type=stringlist; usage=class; desc="Names of additional base classes.");
         @property[nopack](type=bool; usage=field; desc="If true: Ignore this field in parsimPack/parsimUnpack methods.");
+        @property[compactPacking](type=bool; usage=class; desc="Whether parsimPack/parsimUnpack methods may pack runs of consecutive primitive fields and arrays as raw memory blocks. Default is true; set it to false if partitions may run on platforms with different data representation.");
         @property[editable](type=bool; usage=field,class; desc="Specifies whether field value (or value of fields that are instances of this type) can be set via the class descriptor's setFieldValueFromString() method.");
         @property[replaceable](type=bool; usage=field; desc="If true: Field is a pointer whose value can be set via the class descriptor's setFieldStructValuePointer() method.");
         @property[resizable](type=bool; usage=field; desc="If true: Field is a variable-size array whose size can be set via the class descriptor's setFieldArraySize() method.");
@@ -183,6 +183,7 @@ class NEDXML_API MsgTypeTable
         bool generateClass = true;
         bool generateDescriptor = true;
         bool generateSettersInDescriptor = true;
+        bool compactPacking = true;    // from @compactPacking; whether to pack runs of primitive fields as raw memory blocks
 
         StringVector implements;       // values from @implements
         std::string beforeChange;      // @beforeChange; method to be called before mutator methods
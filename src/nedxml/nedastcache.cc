@@ -0,0 +1,257 @@
+//==========================================================================
+// NEDASTCACHE.CC -
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstdio>
+#include <cstring>
+#include "common/fileutil.h"
+#include "common/stringutil.h"
+#include "omnetpp/platdep/platmisc.h" // getpid()
+#include "exception.h"
+#include "nedastcache.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace nedxml {
+
+// Entry format (native byte order; the cache is not meant to be portable):
+//   magic, version, source hash, source size, NED file name, tree
+// where tree is: tag code, source location, source region (4 ints),
+// attribute values, number of children, children (recursively).
+// Strings are stored as a 32-bit length followed by the characters.
+static const char MAGIC[8] = {'O','P','P','N','E','D','A','\0'};
+static const uint32_t FORMAT_VERSION = 1;
+
+static uint64_t fnv1a(const char *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ (unsigned char)data[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+template<typename T>
+static void put(std::string& out, T value)
+{
+    out.append((const char *)&value, sizeof(T));
+}
+
+static void putString(std::string& out, const char *s)
+{
+    uint32_t len = s ? strlen(s) : 0;
+    put(out, len);
+    out.append(s ? s : "", len);
+}
+
+template<typename T>
+static bool get(const char *&p, const char *end, T& value)
+{
+    if (end - p < (ptrdiff_t)sizeof(T))
+        return false;
+    memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+static bool getString(const char *&p, const char *end, std::string& s)
+{
+    uint32_t len;
+    if (!get(p, end, len) || end - p < (ptrdiff_t)len)
+        return false;
+    s.assign(p, len);
+    p += len;
+    return true;
+}
+
+uint64_t NedAstCache::computeHash(const std::string& nedText)
+{
+    return fnv1a(nedText.data(), nedText.size());
+}
+
+std::string NedAstCache::getEntryFileName(const char *nedFilename) const
+{
+    char buf[32];
+    sprintf(buf, "%016llx.nedast", (unsigned long long)fnv1a(nedFilename, strlen(nedFilename)));
+    return concatDirAndFile(folder.c_str(), buf);
+}
+
+void NedAstCache::serializeTree(ASTNode *node, std::string& out)
+{
+    put(out, (int32_t)node->getTagCode());
+    putString(out, node->getSourceLocation().c_str());
+    const SourceRegion& region = node->getSourceRegion();
+    put(out, (int32_t)region.startLine);
+    put(out, (int32_t)region.startColumn);
+    put(out, (int32_t)region.endLine);
+    put(out, (int32_t)region.endColumn);
+    int numAttrs = node->getNumAttributes();
+    put(out, (int32_t)numAttrs);
+    for (int i = 0; i < numAttrs; i++)
+        putString(out, node->getAttribute(i));
+    int numChildren = 0;
+    for (ASTNode *child = node->getFirstChild(); child; child = child->getNextSibling())
+        numChildren++;
+    put(out, (int32_t)numChildren);
+    for (ASTNode *child = node->getFirstChild(); child; child = child->getNextSibling())
+        serializeTree(child, out);
+}
+
+ASTNode *NedAstCache::deserializeTree(const char *&p, const char *end, ASTNodeFactory *factory)
+{
+    int32_t tagCode, numAttrs, numChildren;
+    std::string str;
+    SourceRegion region;
+    int32_t coords[4];
+    if (!get(p, end, tagCode) || !getString(p, end, str))
+        return nullptr;
+    for (int i = 0; i < 4; i++)
+        if (!get(p, end, coords[i]))
+            return nullptr;
+    if (!get(p, end, numAttrs))
+        return nullptr;
+
+    // note: the factory and setAttribute() throw on an unknown tag code or
+    // invalid attribute value, which is a corrupt entry here, not an error
+    ASTNode *node;
+    try {
+        node = factory->createElementWithTag(tagCode);
+    }
+    catch (NedException& e) {
+        return nullptr;
+    }
+    if (!node)
+        return nullptr;
+    node->setSourceLocation(str.c_str());
+    region.startLine = coords[0];
+    region.startColumn = coords[1];
+    region.endLine = coords[2];
+    region.endColumn = coords[3];
+    node->setSourceRegion(region);
+    if (numAttrs != node->getNumAttributes()) {
+        delete node;
+        return nullptr;
+    }
+    for (int i = 0; i < numAttrs; i++) {
+        if (!getString(p, end, str)) {
+            delete node;
+            return nullptr;
+        }
+        try {
+            node->setAttribute(i, str.c_str());
+        }
+        catch (NedException& e) {
+            delete node;
+            return nullptr;
+        }
+    }
+    if (!get(p, end, numChildren)) {
+        delete node;
+        return nullptr;
+    }
+    for (int i = 0; i < numChildren; i++) {
+        ASTNode *child = deserializeTree(p, end, factory);
+        if (!child) {
+            delete node;
+            return nullptr;
+        }
+        node->appendChild(child);
+    }
+    return node;
+}
+
+bool NedAstCache::readEntry(const char *nedFilename, std::string& entry) const
+{
+    std::string fileName = getEntryFileName(nedFilename);
+    FILE *f = fopen(fileName.c_str(), "rb");
+    if (!f)
+        return false;
+    entry.clear();
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        entry.append(buf, n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+NedFileElement *NedAstCache::decodeEntry(const std::string& entry, const char *nedFilename, uint64_t hash, size_t size) const
+{
+    const char *p = entry.data();
+    const char *end = p + entry.size();
+
+    // check header
+    uint32_t version;
+    uint64_t storedHash, storedSize;
+    std::string storedFilename;
+    if (end - p < (ptrdiff_t)sizeof(MAGIC) || memcmp(p, MAGIC, sizeof(MAGIC)) != 0)
+        return nullptr;
+    p += sizeof(MAGIC);
+    if (!get(p, end, version) || version != FORMAT_VERSION)
+        return nullptr;
+    if (!get(p, end, storedHash) || !get(p, end, storedSize) || !getString(p, end, storedFilename))
+        return nullptr;
+    if (storedHash != hash || storedSize != size || storedFilename != nedFilename)
+        return nullptr;
+
+    NedAstNodeFactory factory;
+    ASTNode *tree = deserializeTree(p, end, &factory);
+    NedFileElement *nedFileElement = dynamic_cast<NedFileElement *>(tree);
+    if (!nedFileElement || p != end) {
+        delete tree;
+        return nullptr;
+    }
+    return nedFileElement;
+}
+
+NedFileElement *NedAstCache::load(const char *nedFilename, uint64_t hash, size_t size) const
+{
+    std::string entry;
+    if (!readEntry(nedFilename, entry))
+        return nullptr;
+    return decodeEntry(entry, nedFilename, hash, size);
+}
+
+void NedAstCache::store(const char *nedFilename, uint64_t hash, size_t size, NedFileElement *tree) const
+{
+    std::string entry;
+    entry.append(MAGIC, sizeof(MAGIC));
+    put(entry, FORMAT_VERSION);
+    put(entry, (uint64_t)hash);
+    put(entry, (uint64_t)size);
+    putString(entry, nedFilename);
+    serializeTree(tree, entry);
+
+    try {
+        mkPath(folder.c_str());
+    }
+    catch (std::exception& e) {
+        return;
+    }
+
+    // write into a temp file then rename, so that concurrent readers never see a partial entry
+    std::string fileName = getEntryFileName(nedFilename);
+    std::string tmpFileName = opp_stringf("%s.%d.tmp", fileName.c_str(), (int)getpid());
+    FILE *f = fopen(tmpFileName.c_str(), "wb");
+    if (!f)
+        return;
+    bool ok = fwrite(entry.data(), 1, entry.size(), f) == entry.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+        remove(tmpFileName.c_str());
+}
+
+}  // namespace nedxml
+}  // namespace omnetpp
@@ -0,0 +1,93 @@
+//==========================================================================
+// NEDASTCACHE.H -
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+
+#ifndef __OMNETPP_NEDXML_NEDASTCACHE_H
+#define __OMNETPP_NEDXML_NEDASTCACHE_H
+
+#include <string>
+#include <cstdint>
+#include "nedelements.h"
+
+namespace omnetpp {
+namespace nedxml {
+
+/**
+ * @brief On-disk cache of parsed and validated NED files.
+ *
+ * The AST of each NED file is stored in a binary file in the cache folder,
+ * together with the hash and size of the NED source it was parsed from.
+ * A cached AST is only used if the NED source is unchanged; otherwise
+ * the file is parsed again, and the cache entry is replaced. Cache
+ * entries are written atomically (via a temporary file and rename),
+ * so several simulation processes may share the same cache folder.
+ *
+ * @ingroup NedResources
+ */
+class NEDXML_API NedAstCache
+{
+  protected:
+    std::string folder;
+
+  protected:
+    std::string getEntryFileName(const char *nedFilename) const;
+    static void serializeTree(ASTNode *node, std::string& out);
+    static ASTNode *deserializeTree(const char *&p, const char *end, ASTNodeFactory *factory);
+
+  public:
+    /**
+     * Constructor. The folder is created on the first store() if it
+     * does not exist.
+     */
+    NedAstCache(const char *folder) : folder(folder) {}
+
+    /**
+     * Returns the hash of the given NED source text, to be passed to
+     * load() and store().
+     */
+    static uint64_t computeHash(const std::string& nedText);
+
+    /**
+     * Reads the raw cache entry for the given NED file. Returns false if
+     * there is none. This function does not create AST nodes, so it may be
+     * called from multiple threads concurrently.
+     */
+    bool readEntry(const char *nedFilename, std::string& entry) const;
+
+    /**
+     * Reconstructs the AST from a cache entry read by readEntry(). Returns
+     * nullptr if the entry is for a different NED file, for a different
+     * version of it (hash or size mismatch), or is corrupt.
+     */
+    NedFileElement *decodeEntry(const std::string& entry, const char *nedFilename, uint64_t hash, size_t size) const;
+
+    /**
+     * Convenience function: readEntry() plus decodeEntry().
+     */
+    NedFileElement *load(const char *nedFilename, uint64_t hash, size_t size) const;
+
+    /**
+     * Stores the AST of the given NED file into the cache. Errors are
+     * ignored, as the cache is only an optimization.
+     */
+    void store(const char *nedFilename, uint64_t hash, size_t size, NedFileElement *tree) const;
+};
+
+}  // namespace nedxml
+}  // namespace omnetpp
+
+
+#endif
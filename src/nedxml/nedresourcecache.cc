@@ -16,6 +16,11 @@
 
 #include <cstdio>
 #include <cstring>
+#include <memory>
+#ifdef THREADED
+#include <thread>
+#include <atomic>
+#endif
 #include "common/fileutil.h"
 #include "common/stringutil.h"
 #include "common/stlutil.h"
@@ -32,6 +37,7 @@
 #include "nedsyntaxvalidator.h"
 #include "nedcrossvalidator.h"
 #include "xmlastparser.h"
+#include "nedastcache.h"
 
 using namespace omnetpp::common;
 
@@ -53,6 +59,13 @@ NedResourceCache::~NedResourceCache()
         delete file;
     for (auto & nedType : nedTypes)
         delete nedType.second;
+    delete astCache;
+}
+
+void NedResourceCache::setAstCacheFolder(const char *folder)
+{
+    delete astCache;
+    astCache = opp_isempty(folder) ? nullptr : new NedAstCache(canonicalize(folder).c_str());
 }
 
 void NedResourceCache::registerBuiltinDeclarations()
@@ -88,6 +101,11 @@ static std::vector<std::string> resolvePath(const char *folder, const char *path
     return result;
 }
 
+inline bool isPackageNedFile(const char *fname)
+{
+    return strcmp(fname, "package.ned") == 0 || opp_stringendswith(fname, "/package.ned");
+}
+
 int NedResourceCache::loadNedSourceFolder(const char *folderName, const char *exclusionPath)
 {
     try {
@@ -103,12 +121,49 @@ int NedResourceCache::loadNedSourceFolder(const char *folderName, const char *ex
 }
 
 int NedResourceCache::doLoadNedSourceFolder(const char *folderName, const char *expectedPackage, const std::vector<std::string>& excludedFolders)
+{
+    // Files are read (and their cache entries looked up) in parallel, but
+    // parsed and registered one by one, in directory traversal order: the
+    // NED parser is not reentrant, and the registration order affects
+    // error reporting.
+    std::vector<NedFileToLoad> files;
+    collectNedFiles(folderName, expectedPackage, excludedFolders, files);
+    readNedFiles(files);
+
+    for (NedFileToLoad& file : files) {
+        const char *pkg = file.hasExpectedPackage ? file.expectedPackage.c_str() : nullptr;
+        if (!file.readOk) {
+            doLoadNedFileOrText(file.fileName.c_str(), nullptr, pkg, false);  // reports the error
+            continue;
+        }
+        if (doneLoadingNedFilesCalled && isPackageNedFile(file.fileName.c_str()))
+            throw NedException("Cannot load %s: 'package.ned' files can no longer be loaded at this point", file.fileName.c_str()); // as it could contain e.g. @namespace
+
+        NedFileElement *tree = nullptr;
+        uint64_t hash = 0;
+        if (astCache) {
+            hash = NedAstCache::computeHash(file.nedText);
+            if (!file.cacheEntry.empty())
+                tree = astCache->decodeEntry(file.cacheEntry, file.fileName.c_str(), hash, file.nedText.size());
+        }
+        if (!tree) {
+            tree = parseAndValidateNedFileOrText(file.fileName.c_str(), file.nedText.c_str(), false);
+            if (astCache)
+                astCache->store(file.fileName.c_str(), hash, file.nedText.size(), tree);
+        }
+        file.nedText.clear();
+        file.cacheEntry.clear();
+        addLoadedNedFile(file.fileName.c_str(), file.displayName.c_str(), tree, pkg);
+    }
+    return files.size();
+}
+
+void NedResourceCache::collectNedFiles(const char *folderName, const char *expectedPackage, const std::vector<std::string>& excludedFolders, std::vector<NedFileToLoad>& files)
 {
     if (contains(excludedFolders, canonicalize(folderName)))
-        return 0;
+        return;
 
     PushDir pushDir(folderName);
-    int count = 0;
 
     FileGlobber globber("*");
     const char *filename;
@@ -117,19 +172,61 @@ int NedResourceCache::doLoadNedSourceFolder(const char *folderName, const char *
             continue;  // ignore ".", "..", and dotfiles
         }
         if (isDirectory(filename)) {
-            count += doLoadNedSourceFolder(filename, expectedPackage == nullptr ? nullptr : opp_join(".", expectedPackage, filename).c_str(), excludedFolders);
+            collectNedFiles(filename, expectedPackage == nullptr ? nullptr : opp_join(".", expectedPackage, filename).c_str(), excludedFolders, files);
         }
         else if (opp_stringendswith(filename, ".ned")) {
-            doLoadNedFileOrText(filename, nullptr, expectedPackage, false);
-            count++;
+            NedFileToLoad file;
+            file.fileName = canonicalize(filename);
+            file.displayName = filename;
+            file.hasExpectedPackage = expectedPackage != nullptr;
+            file.expectedPackage = expectedPackage ? expectedPackage : "";
+            files.push_back(file);
         }
     }
-    return count;
 }
 
-inline bool isPackageNedFile(const char *fname)
+static bool readTextFile(const char *fileName, std::string& text)
 {
-    return strcmp(fname, "package.ned") == 0 || opp_stringendswith(fname, "/package.ned");
+    FILE *f = fopen(fileName, "rb");
+    if (!f)
+        return false;
+    text.clear();
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        text.append(buf, n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+void NedResourceCache::readNedFiles(std::vector<NedFileToLoad>& files)
+{
+    // note: must not touch AST nodes or the parser, as it runs on multiple threads
+    auto readFile = [this](NedFileToLoad& file) {
+        file.readOk = readTextFile(file.fileName.c_str(), file.nedText);
+        if (file.readOk && astCache && !astCache->readEntry(file.fileName.c_str(), file.cacheEntry))
+            file.cacheEntry.clear();
+    };
+
+#ifdef THREADED
+    int numThreads = std::min((int)std::thread::hardware_concurrency(), (int)files.size() / 8);  // not worth it for a few files
+    if (numThreads > 1) {
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i; (i = next++) < files.size(); )
+                readFile(files[i]);
+        };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++)
+            threads.push_back(std::thread(worker));
+        for (auto& thread : threads)
+            thread.join();
+        return;
+    }
+#endif
+    for (NedFileToLoad& file : files)
+        readFile(file);
 }
 
 void NedResourceCache::doLoadNedFileOrText(const char *nedFilename, const char *nedText, const char *expectedPackage, bool isXML)
@@ -140,6 +237,11 @@ void NedResourceCache::doLoadNedFileOrText(const char *nedFilename, const char *
     if (doneLoadingNedFilesCalled && isPackageNedFile(canonicalFilename.c_str()))
         throw NedException("Cannot load %s: 'package.ned' files can no longer be loaded at this point", canonicalFilename.c_str()); // as it could contain e.g. @namespace
     NedFileElement *tree = parseAndValidateNedFileOrText(canonicalFilename.c_str(), nedText, isXML);
+    addLoadedNedFile(canonicalFilename.c_str(), nedFilename, tree, expectedPackage);
+}
+
+void NedResourceCache::addLoadedNedFile(const char *canonicalFilename, const char *nedFilename, NedFileElement *tree, const char *expectedPackage)
+{
     Assert(tree);
 
     // check that declared package matches expected package
@@ -150,7 +252,7 @@ void NedResourceCache::doLoadNedFileOrText(const char *nedFilename, const char *
                 declaredPackage.c_str(), expectedPackage, nedFilename);
 
     // register it
-    addFile(canonicalFilename.c_str(), tree);
+    addFile(canonicalFilename, tree);
 
     // if doneLoadingNedFiles() has already been called, we cannot defer resolving the types in it
     if (doneLoadingNedFilesCalled) {
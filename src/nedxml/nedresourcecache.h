@@ -28,6 +28,7 @@ namespace omnetpp {
 namespace nedxml {
 
 class ErrorStore;
+class NedAstCache;
 
 /**
  * @brief Context of NED type lookup, for NedResourceCache.
@@ -108,11 +109,28 @@ class NEDXML_API NedResourceCache
     // storage for NED components not resolved yet because of missing dependencies
     std::vector<PendingNedType> pendingList;
 
+    // on-disk cache of parsed NED files (may be nullptr)
+    NedAstCache *astCache = nullptr;
+
+    // a NED file found in a source folder, to be loaded
+    struct NedFileToLoad {
+        std::string fileName;  // canonical
+        std::string displayName;  // for error messages
+        std::string expectedPackage;
+        bool hasExpectedPackage;
+        std::string nedText;  // filled in by readNedFiles()
+        std::string cacheEntry;  // filled in by readNedFiles()
+        bool readOk = false;
+    };
+
   protected:
     virtual void addFile(const char *fname, NedFileElement *node);
     virtual void registerBuiltinDeclarations();
     virtual int doLoadNedSourceFolder(const char *foldername, const char *expectedPackage, const std::vector<std::string>& excludedFolders);
+    virtual void collectNedFiles(const char *foldername, const char *expectedPackage, const std::vector<std::string>& excludedFolders, std::vector<NedFileToLoad>& files);
+    virtual void readNedFiles(std::vector<NedFileToLoad>& files);
     virtual void doLoadNedFileOrText(const char *nedfname, const char *nedtext, const char *expectedPackage, bool isXML);
+    virtual void addLoadedNedFile(const char *canonicalFilename, const char *nedfname, NedFileElement *tree, const char *expectedPackage);
     virtual NedFileElement *parseAndValidateNedFileOrText(const char *nedfname, const char *nedtext, bool isXML);
     virtual std::string determineRootPackageName(const char *nedSourceFolderName);
     virtual std::string getNedSourceFolderForFolder(const char *folder) const;
@@ -145,6 +163,14 @@ class NEDXML_API NedResourceCache
      */
     virtual int loadNedSourceFolder(const char *foldername, const char *exclusionPath);
 
+    /**
+     * Enables caching of parsed NED files in the given folder, so that NED
+     * files that have not changed since the last run are loaded from the
+     * cache instead of being parsed. Pass nullptr or "" to disable caching.
+     * Only affects loadNedSourceFolder().
+     */
+    virtual void setAstCacheFolder(const char *folder);
+
     /**
      * Load a single NED file. If the expected package is given (non-nullptr),
      * it should match the package declaration inside the NED file.
@@ -38,6 +38,9 @@ namespace qtenv {
 
 bool DisplayUpdateController::animateUntilNextEvent(bool onlyHold)
 {
+    if (isInBatch())
+        endBatch();
+
     // if no more events, we lie that we reached it, so we notice that it's all over when we
     // try to execute the non-existent next event.
     if (!sim->guessNextEvent())
@@ -186,6 +189,9 @@ double DisplayUpdateController::getAnimationHoldEndTime() const
 
 void DisplayUpdateController::setRunMode(RunMode value)
 {
+    if (isInBatch() && value != RUNMODE_FAST)
+        endBatch();
+
     auto oldMode = runMode;
     runMode = value;
     currentProfile = &runProfile;
@@ -224,6 +230,9 @@ void DisplayUpdateController::setRunMode(RunMode value)
 // this is mostly (maybe even only...) called when the cSocketRTScheduler is used
 void DisplayUpdateController::idle()
 {
+    if (isInBatch())
+        endBatch();
+
     advanceToRealTimeLimited(currentTimes, stopwatch.getElapsedSeconds(), simTime());
 
     renderFrame(false); // seems a bit out of place
@@ -231,10 +240,33 @@ void DisplayUpdateController::idle()
 
 void DisplayUpdateController::simulationEvent()
 {
-    if (!getQtenv()->isExpressMode())
+    if (!getQtenv()->isExpressMode() && !isInBatch())
         advanceToRealTimeLimited(currentTimes, stopwatch.getElapsedSeconds(), simTime());
 }
 
+bool DisplayUpdateController::beginBatch()
+{
+    ASSERT(!isInBatch());
+    if (runMode != RUNMODE_FAST || recordingVideo || isPaused() || getAnimationSpeed() != 0)
+        return false;
+
+    // until the next frame or GUI update, whichever comes first
+    double deadline = std::min(lastFrameAt + 1.0/minFrameRate, lastGuiUpdateAt + 1.0/minGuiUpdateRate);
+    if (deadline <= stopwatch.getElapsedSecondsNoLoss())
+        return false;
+    batchDeadline = deadline;
+    return true;
+}
+
+void DisplayUpdateController::endBatch()
+{
+    ASSERT(isInBatch());
+    batchDeadline = -1;
+    // do what simulationEvent() skipped during the batch
+    advanceToSimTime(currentTimes, simTime());
+    advanceToRealTimeLimited(currentTimes, stopwatch.getElapsedSeconds(), simTime());
+}
+
 void DisplayUpdateController::skipHold()
 {
     currentTimes.animationTime = std::max(currentTimes.animationTime, getAnimationHoldEndTime());
@@ -526,6 +558,7 @@ void DisplayUpdateController::reset()
     videoFps = 30; // the framerate of the recorded video
 
     currentTimes = TimeTriplet();
+    batchDeadline = -1;
 
     stopwatch.reset();
     pausedCount = 0;
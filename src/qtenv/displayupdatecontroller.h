@@ -130,6 +130,11 @@ class QTENV_API DisplayUpdateController : public QObject
 
     bool recordingVideo = false; // a simple state variable
 
+    // in FAST mode, the (lossless stopwatch) time until which events are
+    // executed back-to-back without animateUntilNextEvent(); negative if
+    // there is no such batch in progress (see beginBatch())
+    double batchDeadline = -1;
+
     int frameCount = 0; // this will be the sequence number of the next recorded frame
     simtime_t lastRecordedFrame = -SimTime::getMaxTime(); // used in rendering mode, this stores the last SimTime we recorded, incremented by constant amounts
 
@@ -177,6 +182,17 @@ public:
     void idle();
     void simulationEvent();
 
+    // In FAST mode, if there is nothing to animate, the events between two GUI
+    // updates can be executed back-to-back, without calling animateUntilNextEvent()
+    // and performing hold animations before each one. beginBatch() starts such
+    // a batch if possible (returns false if not), and isBatchOver() tells when
+    // the next GUI update is due. The batch ends with the next animateUntilNextEvent()
+    // or idle() call, or when switching to another run mode.
+    bool beginBatch();
+    void endBatch(); // catches up with the time updates skipped during the batch
+    bool isInBatch() const { return batchDeadline >= 0; }
+    bool isBatchOver() { return stopwatch.getElapsedSecondsNoLoss() >= batchDeadline; }
+
     void skipHold(); // sets animationTime to the end of the current hold, effectively ending it
     void skipToNextEvent(); // the above, plus sets simTime to that of the next event
 
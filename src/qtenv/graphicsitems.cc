@@ -19,6 +19,7 @@
 #include <cmath>
 #include <QPen>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QFontMetricsF>
 #include <QDebug>
 #include "qtenv.h"
@@ -183,6 +184,57 @@ void ZoomLabel::setZoomFactor(double zoomFactor)
 
 //---- end of ZoomLabel ----
 
+//---- SubmoduleClusterItem implementation ----
+
+void SubmoduleClusterItem::setCells(const std::vector<Cell>& cells)
+{
+    prepareGeometryChange();
+    this->cells = cells;
+    bounds = QRectF();
+    for (const Cell& cell : cells)
+        bounds = bounds.united(cell.rect);
+    update();
+}
+
+void SubmoduleClusterItem::setZoomFactor(double zoomFactor)
+{
+    if (this->zoomFactor == zoomFactor)
+        return;
+
+    prepareGeometryChange();
+    this->zoomFactor = zoomFactor;
+    update();
+}
+
+QRectF SubmoduleClusterItem::boundingRect() const
+{
+    return QRectF(bounds.topLeft() * zoomFactor, bounds.size() * zoomFactor);
+}
+
+void SubmoduleClusterItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    painter->setPen(QPen(QColor("#404060"), 0));
+    painter->setBrush(QColor("#8080c0"));
+    QFontMetricsF metrics(painter->font());
+
+    for (const Cell& cell : cells) {
+        QRectF rect(cell.rect.topLeft() * zoomFactor, cell.rect.size() * zoomFactor);
+        // with thousands of cells, skipping the ones outside the exposed area matters
+        if (!rect.intersects(option->exposedRect))
+            continue;
+
+        // leave a small gap between neighbouring cells so they don't merge into one blob
+        QRectF box = rect.adjusted(1, 1, -1, -1);
+        painter->drawRect(box);
+
+        QString label = QString::number(cell.count);
+        if (metrics.width(label) < box.width() && metrics.height() < box.height())
+            painter->drawText(box, Qt::AlignCenter, label);
+    }
+}
+
+//---- end of SubmoduleClusterItem ----
+
 //---- OutlinedTextItem implementation ----
 
 OutlinedTextItem::OutlinedTextItem(QGraphicsItem *parent)
@@ -22,6 +22,7 @@
 #include <QFont>
 #include <QPen>
 #include <QTimer>
+#include <vector>
 #include "qtenvdefs.h"
 
 namespace omnetpp {
@@ -158,6 +159,35 @@ public:
     void setZoomFactor(double zoomFactor);
 };
 
+// Stands in for the submodules of a large compound module when too many of
+// them would be visible at once to draw them one by one. Each cell of the
+// viewer's spatial grid that contains submodules is drawn as a single box
+// labeled with the number of submodules in it. The cell rectangles are in
+// unzoomed (layout) coordinates.
+class QTENV_API SubmoduleClusterItem : public QGraphicsItem
+{
+public:
+    struct Cell {
+        QRectF rect;
+        int count;
+    };
+
+protected:
+    std::vector<Cell> cells;
+    QRectF bounds; // union of the cell rectangles, unzoomed
+    double zoomFactor = 1;
+
+public:
+    // the extended style option is needed for paint() to get the exposed rectangle
+    SubmoduleClusterItem(QGraphicsItem *parent = nullptr) : QGraphicsItem(parent) { setFlag(ItemUsesExtendedStyleOption); }
+
+    void setCells(const std::vector<Cell>& cells);
+    void setZoomFactor(double zoomFactor);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
 // XXX: Why not QGraphicsPathItem ?
 class QTENV_API BubbleItem : public QGraphicsObject {
     Q_OBJECT
@@ -33,7 +33,11 @@
 #include "graphicsitems.h"
 #include "areaselectordialog.h"
 #include "arrow.h"
+#include "qtutil.h"
+#include <cmath>
+#include <tuple>
 #include <QGraphicsScene>
+#include <QGraphicsPathItem>
 #include <QScrollBar>
 #include <QGraphicsPixmapItem>
 #include <QMessageBox>
@@ -136,6 +140,7 @@ void ModuleCanvasViewer::scrollContentsBy(int dx, int dy)
 {
     QGraphicsView::scrollContentsBy(dx, dy);
     updateZoomLabelPos();
+    updateVisibleSubmodules();
 }
 
 void ModuleCanvasViewer::updateZoomLabelPos()
@@ -282,7 +287,8 @@ void ModuleCanvasViewer::mouseMoveEvent(QMouseEvent *event)
 
         draggedSubmod->setDisplayString(ds);
         getQtenv()->getModuleLayouter()->refreshPositionFromDS(draggedSubmod);
-        submoduleGraphicsItems[draggedSubmod]->setPos(getSubmodCoords(draggedSubmod));
+        if (containsKey(submoduleGraphicsItems, draggedSubmod))
+            submoduleGraphicsItems[draggedSubmod]->setPos(getSubmodCoords(draggedSubmod));
         getQtenv()->callRefreshDisplaySafe();
         getQtenv()->refreshInspectors();
     }
@@ -303,6 +309,7 @@ void ModuleCanvasViewer::resizeEvent(QResizeEvent *event)
     if (isEnabled())
         recalcSceneRect();
     updateZoomLabelPos();
+    updateVisibleSubmodules();
 }
 
 bool ModuleCanvasViewer::event(QEvent *event)
@@ -502,9 +509,30 @@ void ModuleCanvasViewer::redrawModules()
     submoduleLayer->clear();
     submoduleGraphicsItems.clear();
     connectionGraphicsItems.clear();
+    connectionBatchItems.clear();
+    clusterItem = nullptr;
 
     cModule *parentModule = object;
 
+    int submoduleCount = 0;
+    for (cModule::SubmoduleIterator it(parentModule); !it.end(); ++it)
+        submoduleCount++;
+    largeModuleMode = submoduleCount > getQtenv()->opt->largeModuleThreshold;
+
+    if (largeModuleMode) {
+        rebuildSubmoduleGrid();
+        clusterItem = new SubmoduleClusterItem(submoduleLayer);
+        updateClusterItem();
+        updateVisibleSubmodules();
+
+        if (!containsKey(submoduleGridCells, draggedSubmod))
+            draggedSubmod = nullptr;
+
+        redrawEnclosingModule();
+        redrawConnectionBatch();
+        return;
+    }
+
     for (cModule::SubmoduleIterator it(parentModule); !it.end(); ++it)
         drawSubmodule(*it);
 
@@ -519,7 +547,7 @@ void ModuleCanvasViewer::redrawModules()
     for (cModule::SubmoduleIterator it(parentModule); !atParent; ++it) {
         cModule *mod = !it.end() ? *it : (atParent = true, parentModule);
 
-        for (cModule::GateIterator git(mod); !git.end(); ++git) {
+        for (cModule::GateIterator git(mod, false); !git.end(); ++git) {
             cGate *gate = *git;
             if (gate->getType() == (atParent ? cGate::INPUT : cGate::OUTPUT) && gate->getNextGate() != nullptr) {
                 drawConnection(gate);
@@ -561,6 +589,9 @@ QRectF ModuleCanvasViewer::getSubmodulesRect()
 {
     QRectF submodulesRect;
 
+    if (largeModuleMode && !submodulesBounds.isNull())
+        return submodulesBounds;  // most submodules have no item, so use the cached bounds
+
     if (submoduleGraphicsItems.empty()) {
         submodulesRect.setWidth(300 * zoomFactor);
         submodulesRect.setHeight(200 * zoomFactor);
@@ -622,6 +653,169 @@ void ModuleCanvasViewer::drawConnection(cGate *gate)
     item->setZValue(-1);
 }
 
+std::pair<int,int> ModuleCanvasViewer::getGridCell(const QPointF& pos)
+{
+    return std::make_pair((int)std::floor(pos.x() / gridCellSize), (int)std::floor(pos.y() / gridCellSize));
+}
+
+void ModuleCanvasViewer::rebuildSubmoduleGrid()
+{
+    submoduleGrid.clear();
+    submoduleGridCells.clear();
+    submodulesBounds = QRectF();
+
+    ModuleLayouter *layouter = getQtenv()->getModuleLayouter();
+
+    // choose the cell size so that the grid is about 64 cells wide or high
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool first = true;
+    for (cModule::SubmoduleIterator it(object); !it.end(); ++it) {
+        QPointF pos = layouter->getModulePosition(*it, 1);
+        if (std::isnan(pos.x()) || std::isnan(pos.y()))
+            continue;
+        minX = first ? pos.x() : std::min(minX, pos.x());
+        minY = first ? pos.y() : std::min(minY, pos.y());
+        maxX = first ? pos.x() : std::max(maxX, pos.x());
+        maxY = first ? pos.y() : std::max(maxY, pos.y());
+        first = false;
+    }
+    gridCellSize = std::max(50.0, std::max(maxX - minX, maxY - minY) / 64);
+
+    for (cModule::SubmoduleIterator it(object); !it.end(); ++it)
+        updateSubmoduleGridCell(*it);
+}
+
+void ModuleCanvasViewer::updateSubmoduleGridCell(cModule *submod)
+{
+    ModuleLayouter *layouter = getQtenv()->getModuleLayouter();
+    QPointF pos = layouter->getModulePosition(submod, 1);
+    if (std::isnan(pos.x()) || std::isnan(pos.y()))
+        pos = QPointF(0, 0);  // not yet layouted; will be corrected on the next redraw
+
+    auto cell = getGridCell(pos);
+    auto it = submoduleGridCells.find(submod);
+    if (it == submoduleGridCells.end() || it->second != cell) {
+        if (it != submoduleGridCells.end()) {
+            std::vector<cModule *>& oldCell = submoduleGrid[it->second];
+            oldCell.erase(std::find(oldCell.begin(), oldCell.end(), submod));
+            if (oldCell.empty())
+                submoduleGrid.erase(it->second);
+        }
+        submoduleGrid[cell].push_back(submod);
+        submoduleGridCells[submod] = cell;
+    }
+
+    // the bounds only grow here, they are recomputed on the next rebuild
+    submodulesBounds = submodulesBounds.united(layouter->getModuleRectangle(submod, zoomFactor, imageSizeFactor));
+}
+
+void ModuleCanvasViewer::updateClusterItem()
+{
+    std::vector<SubmoduleClusterItem::Cell> cells;
+    cells.reserve(submoduleGrid.size());
+    for (const auto& entry : submoduleGrid) {
+        QRectF rect(entry.first.first * gridCellSize, entry.first.second * gridCellSize, gridCellSize, gridCellSize);
+        cells.push_back({rect, (int)entry.second.size()});
+    }
+    clusterItem->setCells(cells);
+    clusterItem->setZoomFactor(zoomFactor);
+}
+
+void ModuleCanvasViewer::updateVisibleSubmodules()
+{
+    if (!largeModuleMode || !object || notDrawn || needsRedraw || layoutingScene)
+        return;
+
+    // the visible area in unzoomed coordinates, extended by half a viewport
+    // in every direction, so scrolling a little does not need new items
+    QRectF visibleRect = mapToScene(viewport()->rect()).boundingRect();
+    QRectF area(visibleRect.topLeft() / zoomFactor, visibleRect.size() / zoomFactor);
+    area.adjust(-area.width() / 2, -area.height() / 2, area.width() / 2, area.height() / 2);
+    auto topLeft = getGridCell(area.topLeft());
+    auto bottomRight = getGridCell(area.bottomRight());
+
+    std::vector<cModule *> visibleSubmods;
+    for (const auto& entry : submoduleGrid) {
+        const auto& cell = entry.first;
+        if (cell.first >= topLeft.first && cell.first <= bottomRight.first
+                && cell.second >= topLeft.second && cell.second <= bottomRight.second)
+            visibleSubmods.insert(visibleSubmods.end(), entry.second.begin(), entry.second.end());
+    }
+
+    // too many to draw one by one, let the cluster item show them
+    bool clustered = (int)visibleSubmods.size() > getQtenv()->opt->largeModuleThreshold;
+    clusterItem->setVisible(clustered);
+    if (clustered)
+        visibleSubmods.clear();
+
+    std::unordered_set<cModule *> visibleSet(visibleSubmods.begin(), visibleSubmods.end());
+    for (auto it = submoduleGraphicsItems.begin(); it != submoduleGraphicsItems.end(); ) {
+        if (!contains(visibleSet, it->first)) {
+            delete it->second;
+            it = submoduleGraphicsItems.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    for (cModule *submod : visibleSubmods) {
+        if (!containsKey(submoduleGraphicsItems, submod)) {
+            drawSubmodule(submod);
+            SubmoduleItemUtil::updateQueueSizeLabel(submoduleGraphicsItems[submod], submod);
+        }
+    }
+}
+
+void ModuleCanvasViewer::redrawConnectionBatch()
+{
+    for (auto item : connectionBatchItems)
+        delete item;
+    connectionBatchItems.clear();
+    connectionBatchChanged = false;
+
+    // one path per distinct line style (color, width, pen style) of the "ls" tag
+    std::map<std::tuple<QRgb, double, int>, QPainterPath> paths;
+
+    bool atParent = false;
+    for (cModule::SubmoduleIterator it(object); !atParent; ++it) {
+        cModule *mod = !it.end() ? *it : (atParent = true, object);
+
+        for (cModule::GateIterator git(mod, false); !git.end(); ++git) {
+            cGate *gate = *git;
+            if (gate->getType() != (atParent ? cGate::INPUT : cGate::OUTPUT) || gate->getNextGate() == nullptr)
+                continue;
+
+            cChannel *chan = gate->getChannel();
+            cDisplayString ds = chan && chan->hasDisplayString() && chan->parametersFinalized()
+                    ? chan->getDisplayString()
+                    : cDisplayString();
+            std::string buffer;
+            ds = substituteDisplayStringParamRefs(ds, buffer, chan, true);
+
+            bool ok;
+            double width = QString(ds.getTagArg("ls", 1)).toDouble(&ok);
+            if (ok && width == 0)
+                continue;  // explicitly hidden
+
+            QColor color = parseColor(ds.getTagArg("ls", 0), QColor("black"));
+            const char *style = ds.getTagArg("ls", 2);
+            Qt::PenStyle penStyle = style[0] == 'd' ? style[1] == 'a' ? Qt::DashLine : Qt::DotLine : Qt::SolidLine;
+
+            QLineF line = getConnectionLine(gate);
+            QPainterPath& path = paths[std::make_tuple(color.rgba(), width, (int)penStyle)];
+            path.moveTo(line.p1());
+            path.lineTo(line.p2());
+        }
+    }
+
+    for (const auto& entry : paths) {
+        auto item = new QGraphicsPathItem(entry.second, submoduleLayer);
+        item->setPen(QPen(QColor::fromRgba(std::get<0>(entry.first)), std::get<1>(entry.first), (Qt::PenStyle)std::get<2>(entry.first)));
+        item->setZValue(-1);
+        connectionBatchItems.push_back(item);
+    }
+}
+
 QPointF ModuleCanvasViewer::getSubmodCoords(cModule *mod)
 {
     ASSERT(mod->getParentModule() == object);
@@ -634,7 +828,8 @@ QRectF ModuleCanvasViewer::getSubmodRect(cModule *mod)
     // (like one between a sibling of a module and one of its submodules) gracefully.
     // ASSERT(mod->getParentModule() == object);
 
-    if (!containsKey(submoduleGraphicsItems, mod) && compoundModuleItem)
+    bool isSubmodule = largeModuleMode ? containsKey(submoduleGridCells, mod) : containsKey(submoduleGraphicsItems, mod);
+    if (!isSubmodule && compoundModuleItem)
         return compoundModuleItem->getArea();
 
     return getQtenv()->getModuleLayouter()->getModuleRectangle(mod, zoomFactor, imageSizeFactor);
@@ -766,6 +961,14 @@ void ModuleCanvasViewer::clear()
     connectionGraphicsItems.clear();
     compoundModuleItem = nullptr;
 
+    largeModuleMode = false;
+    submoduleGrid.clear();
+    submoduleGridCells.clear();
+    submodulesBounds = QRectF();
+    clusterItem = nullptr;
+    connectionBatchItems.clear();
+    connectionBatchChanged = false;
+
     compoundModuleChanged = false;
     changedSubmodules.clear();
     changedConnections.clear();
@@ -782,6 +985,13 @@ void ModuleCanvasViewer::refreshLayout()
 void ModuleCanvasViewer::refreshSubmodule(cModule *submod)
 {
     ASSERT(submod->getParentModule() == object);
+
+    if (largeModuleMode) {
+        updateSubmoduleGridCell(submod);
+        if (!containsKey(submoduleGraphicsItems, submod))
+            return;  // not near the visible area, it has no item
+    }
+
     ASSERT(containsKey(submoduleGraphicsItems, submod));
 
     auto item = submoduleGraphicsItems[submod];
@@ -795,7 +1005,12 @@ void ModuleCanvasViewer::refreshSubmodule(cModule *submod)
 
 void ModuleCanvasViewer::refreshSubmodules()
 {
-    if (object)
+    if (object && largeModuleMode) {
+        // only the ones that have an item; the rest are set up when they get near the visible area
+        for (auto p : submoduleGraphicsItems)
+            refreshSubmodule(p.first);
+    }
+    else if (object)
         for (cModule::SubmoduleIterator it(object); !it.end(); ++it)
             refreshSubmodule(*it);
     changedSubmodules.clear();
@@ -810,6 +1025,12 @@ void ModuleCanvasViewer::refreshQueueSizes()
 void ModuleCanvasViewer::refreshConnection(cGate *gate)
 {
     ASSERT(gate->getOwnerModule() == object || gate->getOwnerModule()->getParentModule() == object);
+
+    if (largeModuleMode) {
+        connectionBatchChanged = true;  // the batch is redrawn as a whole, see refresh()
+        return;
+    }
+
     ASSERT(containsKey(connectionGraphicsItems, gate));
 
     ConnectionItem *item = connectionGraphicsItems[gate];
@@ -821,7 +1042,7 @@ void ModuleCanvasViewer::refreshConnections(cModule *module)
 {
     ASSERT(module == object || module->getParentModule() == object);
 
-    for (cModule::GateIterator it(module); !it.end(); ++it) {
+    for (cModule::GateIterator it(module, false); !it.end(); ++it) {
         cGate *gate = *it;
         if (gate->getNextGate() == nullptr)
             continue;
@@ -841,7 +1062,11 @@ void ModuleCanvasViewer::refreshConnections(cModule *module)
 
 void ModuleCanvasViewer::refreshConnections()
 {
-    if (object) {
+    if (object && largeModuleMode) {
+        redrawConnectionBatch();
+        changedConnections.clear();
+    }
+    else if (object) {
         refreshConnections(object);
         for (cModule::SubmoduleIterator it(object); !it.end(); ++it)
             refreshConnections(*it);
@@ -900,7 +1125,7 @@ void ModuleCanvasViewer::refresh()
 
             // have to update all incoming and outgoing connections as well,
             // the bounding rect of the submodule might have changed
-            for (cModule::GateIterator it(s); !it.end(); ++it) {
+            for (cModule::GateIterator it(s, false); !it.end(); ++it) {
                 cGate *gate = *it;
                 if (gate->getType() == cGate::OUTPUT)
                     changedConnections.insert(gate);
@@ -914,7 +1139,7 @@ void ModuleCanvasViewer::refresh()
         if (compoundModuleChanged || !changedSubmodules.empty()) {
             redrawEnclosingModule();
 
-            for (cModule::GateIterator it(object); !it.end(); ++it) {
+            for (cModule::GateIterator it(object, false); !it.end(); ++it) {
                 cGate *gate = *it;
                 if (gate->getType() == cGate::INPUT)
                     changedConnections.insert(gate);
@@ -934,6 +1159,15 @@ void ModuleCanvasViewer::refresh()
                         refreshConnection(otherDirection);
                 }
             }
+
+        if (largeModuleMode) {
+            if (!changedSubmodules.empty()) {
+                updateClusterItem();
+                updateVisibleSubmodules();
+            }
+            if (connectionBatchChanged)
+                redrawConnectionBatch();
+        }
     }
 
     compoundModuleChanged = false;
@@ -962,12 +1196,17 @@ void ModuleCanvasViewer::setZoomFactor(double zoomFactor)
         needsRedraw = false;
 
         refreshLayout();
+        if (largeModuleMode) {
+            rebuildSubmoduleGrid();  // for the zoomed bounds
+            updateClusterItem();
+        }
         refreshSubmodules();
         // has to be done after the submodules have been positioned, but before connections
         redrawEnclosingModule();
         refreshConnections();
 
         recalcSceneRect();
+        updateVisibleSubmodules();
 
         viewport()->update();
     }
@@ -18,6 +18,8 @@
 #define __OMNETPP_QTENV_MODULECANVASVIEWER_H
 
 #include <map>
+#include <vector>
+#include <unordered_map>
 #include <QPointF>
 #include <QGraphicsView>
 #include <unordered_set>
@@ -25,6 +27,7 @@
 #include "qtenvdefs.h"
 
 class QGraphicsPixmapItem;
+class QGraphicsPathItem;
 class QRubberBand;
 
 namespace omnetpp {
@@ -40,6 +43,7 @@ class GraphicsLayer;
 class CompoundModuleItem;
 class SubmoduleItem;
 class ConnectionItem;
+class SubmoduleClusterItem;
 struct FigureRenderingHints;
 class CanvasRenderer;
 class ZoomLabel;
@@ -77,6 +81,21 @@ private:
     std::unordered_set<cModule *> changedSubmodules;
     std::unordered_set<cGate *> changedConnections;
 
+    // Level-of-detail rendering, used when the inspected module has more than
+    // QtenvOptions::largeModuleThreshold submodules. In this mode, submodules are
+    // indexed in a grid by their (unzoomed) position, and SubmoduleItems are only
+    // created for the ones near the visible area. If even that would be more than
+    // the threshold, clusterItem draws the grid cells instead. Connections are not
+    // separate items, but grouped by line style into a few path items.
+    bool largeModuleMode = false;
+    double gridCellSize = 1;
+    std::map<std::pair<int,int>, std::vector<cModule *>> submoduleGrid;
+    std::unordered_map<cModule *, std::pair<int,int>> submoduleGridCells;
+    QRectF submodulesBounds; // what getSubmodulesRect() returns in large module mode
+    SubmoduleClusterItem *clusterItem = nullptr;
+    std::vector<QGraphicsPathItem *> connectionBatchItems;
+    bool connectionBatchChanged = false;
+
     GraphicsLayer *backgroundLayer;
     GraphicsLayer *rangeLayer;
     GraphicsLayer *submoduleLayer;
@@ -102,6 +121,14 @@ private:
     void drawSubmodule(cModule *submod);
     void drawConnection(cGate *gate);
 
+    // large module mode
+    std::pair<int,int> getGridCell(const QPointF& pos);
+    void rebuildSubmoduleGrid();
+    void updateSubmoduleGridCell(cModule *submod);
+    void updateClusterItem();
+    void updateVisibleSubmodules();
+    void redrawConnectionBatch();
+
     FigureRenderingHints makeFigureRenderingHints();
 
     void updateZoomLabelPos();
@@ -240,6 +240,32 @@ void ModuleLayouter::ensureLayouted(cModule *module)
     if (!needsLayout)
         return;
 
+    // If all the missing ones have explicit coordinates in their display strings
+    // (typical for large generated networks), there is nothing to compute: take
+    // them from there, and spare the graph layouter (which is superlinear).
+    std::vector<std::pair<cModule *, QPointF>> explicitPositions;
+    bool allExplicit = true;
+    for (cModule::SubmoduleIterator it(module); !it.end() && allExplicit; ++it) {
+        cModule *submod = *it;
+        if (modulePositions.find(submod) != modulePositions.end())
+            continue;
+
+        bool explicitCoords, obeysLayout;
+        double x, y, sx, sy;
+        getSubmoduleCoords(submod, explicitCoords, obeysLayout, x, y, sx, sy);
+        if (explicitCoords)
+            explicitPositions.push_back(std::make_pair(submod, QPointF(x, y)));
+        else
+            allExplicit = false;
+    }
+
+    if (allExplicit) {
+        for (auto& p : explicitPositions)
+            modulePositions[p.first] = p.second;
+        emit moduleLayoutChanged(module);
+        return;
+    }
+
     // recalculate layout, using coordinates in submodPosMap as "fixed" nodes --
     // only new nodes are re-layouted
 
@@ -313,7 +339,7 @@ void ModuleLayouter::ensureLayouted(cModule *module)
     for (cModule::SubmoduleIterator it(module); !atParent; ++it) {
         cModule *mod = !it.end() ? *it : (atParent = true, module);
 
-        for (cModule::GateIterator git(mod); !git.end(); ++git) {
+        for (cModule::GateIterator git(mod, false); !git.end(); ++git) {
             cGate *gate = *git;
             cGate *destGate = gate->getNextGate();
             if (gate->getType() == (atParent ? cGate::INPUT : cGate::OUTPUT) && destGate) {
@@ -19,6 +19,7 @@
 #include "qtenv.h"
 #include "inspectorutil.h"
 
+#include <algorithm>
 #include <QDebug>
 
 namespace omnetpp {
@@ -74,6 +75,7 @@ void PreferencesDialog::init()
     }
     ui->showLayouting->setChecked(getQtenv()->opt->showLayouting);
     ui->arrange->setChecked(getQtenv()->opt->arrangeVectorConnections);
+    ui->largeModuleThreshold->setText(QString::number(getQtenv()->opt->largeModuleThreshold));
     variant = getQtenv()->getPref("layout-may-change-zoom");
     ui->allowZoom->setChecked(variant.isValid() ? variant.value<bool>() : false);
 
@@ -187,6 +189,9 @@ void PreferencesDialog::accept()
         LAYOUTER_AUTO;
 
     getQtenv()->opt->arrangeVectorConnections = ui->arrange->isChecked();
+    QString threshold = ui->largeModuleThreshold->text();
+    if (!threshold.isEmpty())
+        getQtenv()->opt->largeModuleThreshold = std::max(threshold.toInt(), 1);
     getQtenv()->opt->showBubbles = ui->showBubbles->isChecked();
     getQtenv()->setPref("confirm-exit", ui->confirmExit->isChecked());
 
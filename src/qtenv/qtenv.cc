@@ -207,6 +207,7 @@ void Qtenv::storeOptsInPrefs()
     setPref("layouterchoice", layouterChoiceString);
 
     setPref("arrangevectorconnections", opt->arrangeVectorConnections);
+    setPref("largemodulethreshold", opt->largeModuleThreshold);
     setPref("bubbles", opt->showBubbles);
     setPref("expressmode_autoupdate", opt->autoupdateInExpress);
 
@@ -308,6 +309,10 @@ void Qtenv::restoreOptsFromPrefs()
     if (pref.isValid())
         opt->arrangeVectorConnections = pref.toBool();
 
+    pref = getPref("largemodulethreshold");
+    if (pref.isValid())
+        opt->largeModuleThreshold = pref.toInt();
+
     pref = getPref("bubbles");
     if (pref.isValid())
         opt->showBubbles = pref.toBool();
@@ -819,8 +824,13 @@ void Qtenv::runSimulation(RunMode mode, simtime_t until_time, eventnumber_t unti
     stopClock();
     stopSimulationFlag = false;
 
+    // the run loop may have exited (stop, error, run-until condition, etc.)
+    // in the middle of a FAST mode event batch
+    if (displayUpdateController->isInBatch())
+        displayUpdateController->endBatch();
+
     animating = true;
-    loggingEnabled = true;
+    setLoggingEnabled(true);
     recordEventlog = false;
     runUntil.msg = nullptr;
 
@@ -892,26 +902,36 @@ bool Qtenv::doRunSimulation()
     //
     cSimulation *sim = getSimulation();
     speedometer.start(sim->getSimTime());
-    loggingEnabled = true;
+    setLoggingEnabled(true);
     bool firstevent = true;
 
     while (true) {
-        if (runMode == RUNMODE_EXPRESS)
+        if (runMode == RUNMODE_EXPRESS) {
+            if (displayUpdateController->isInBatch())
+                displayUpdateController->endBatch();
             return true;  // should continue, but in a different mode
+        }
 
-        displayUpdateController->setRunMode(runMode);
-        bool reached = displayUpdateController->animateUntilNextEvent();
-        performHoldAnimations();
+        // in FAST mode, events are executed in batches between GUI updates
+        // when there is nothing to animate (see DisplayUpdateController::beginBatch())
+        if (!displayUpdateController->isInBatch() || displayUpdateController->isBatchOver() || runMode != RUNMODE_FAST || messageAnimator->isHoldActive()) {
+            displayUpdateController->setRunMode(runMode);
+            bool reached = displayUpdateController->animateUntilNextEvent();
+            performHoldAnimations();
 
-        // if there is no event, we have to let the control through to
-        // takeNextEvent, and it will terminate the simulation with an exception.
-        if ((!reached || messageAnimator->isHoldActive()) && sim->guessNextEvent())
-            break;
+            // if there is no event, we have to let the control through to
+            // takeNextEvent, and it will terminate the simulation with an exception.
+            if ((!reached || messageAnimator->isHoldActive()) && sim->guessNextEvent())
+                break;
 
-        // if there is no event, we have to let the control through to
-        // takeNextEvent, and it will terminate the simulation with an exception.
-        if (runMode == RUNMODE_STEP && !doNextEventInStep && sim->guessNextEvent())
-            break;
+            // if there is no event, we have to let the control through to
+            // takeNextEvent, and it will terminate the simulation with an exception.
+            if (runMode == RUNMODE_STEP && !doNextEventInStep && sim->guessNextEvent())
+                break;
+
+            if (runMode == RUNMODE_FAST)
+                displayUpdateController->beginBatch();
+        }
 
         // query which module will execute the next event
         cEvent *event = sim->takeNextEvent();
@@ -1000,7 +1020,7 @@ bool Qtenv::doRunSimulationExpress()
 
     // OK, let's begin
     speedometer.start(getSimulation()->getSimTime());
-    loggingEnabled = false;
+    setLoggingEnabled(false);
     animating = false;
 
     messageAnimator->clear();
@@ -1087,6 +1107,7 @@ void Qtenv::finishSimulation()
         cLogProxy::flushLastLine();
 
         checkFingerprint();
+        printProfilingReport();
     }
     catch (std::exception& e) {
         stoppedWithException(e);
@@ -1821,7 +1842,7 @@ void Qtenv::simulationEvent(cEvent *event)
 {
     EnvirBase::simulationEvent(event);
 
-    if (loggingEnabled)
+    if (isLoggingEnabled())
         addEventToLog(event);  // must be done here, because eventnum and simtime are updated inside executeEvent()
 
     displayUpdateController->simulationEvent();
@@ -1833,7 +1854,7 @@ void Qtenv::simulationEvent(cEvent *event)
             if (!arrivalGate)
                 return;
 
-            if (loggingEnabled)
+            if (isLoggingEnabled())
                 logBuffer.delivery(msg);
 
             // if arrivalgate is connected, msg arrived on a connection, otherwise via sendDirect()
@@ -1870,7 +1891,7 @@ void Qtenv::beginSend(cMessage *msg, const SendOptions& options)
 {
     EnvirBase::beginSend(msg, options);
 
-    if (loggingEnabled)
+    if (isLoggingEnabled())
         logBuffer.beginSend(msg, options);
 
     if (animating && opt->animationEnabled && !isSilentEvent(msg))
@@ -1881,7 +1902,7 @@ void Qtenv::messageSendDirect(cMessage *msg, cGate *toGate, const ChannelResult&
 {
     EnvirBase::messageSendDirect(msg, toGate, result);
 
-    if (loggingEnabled)
+    if (isLoggingEnabled())
         logBuffer.messageSendDirect(msg, toGate, result);
 
     if (animating && opt->animationEnabled && !isSilentEvent(msg))
@@ -1892,7 +1913,7 @@ void Qtenv::messageSendHop(cMessage *msg, cGate *srcGate)
 {
     EnvirBase::messageSendHop(msg, srcGate);
 
-    if (loggingEnabled)
+    if (isLoggingEnabled())
         logBuffer.messageSendHop(msg, srcGate);
 
     if (animating && opt->animationEnabled && !isSilentEvent(msg)) {
@@ -1905,7 +1926,7 @@ void Qtenv::messageSendHop(cMessage *msg, cGate *srcGate, const cChannel::Result
 {
     EnvirBase::messageSendHop(msg, srcGate, result);
 
-    if (loggingEnabled)
+    if (isLoggingEnabled())
         logBuffer.messageSendHop(msg, srcGate, result);
 
     if (animating && opt->animationEnabled && !isSilentEvent(msg)) {
@@ -1918,7 +1939,7 @@ void Qtenv::endSend(cMessage *msg)
 {
     EnvirBase::endSend(msg);
 
-    if (loggingEnabled)
+    if (isLoggingEnabled())
         logBuffer.endSend(msg);
 
     if (animating && opt->animationEnabled && !isSilentEvent(msg))
@@ -2309,7 +2330,7 @@ void Qtenv::log(cLogEntry *entry)
 {
     EnvirBase::log(entry);
 
-    if (!loggingEnabled)
+    if (!isLoggingEnabled())
         return;
 
     std::string prefix = logFormatter.formatPrefix(entry);
@@ -90,6 +90,7 @@ struct QtenvOptions : public EnvirOptions
     bool showLayouting = false;            // show layouting process in graphical module inspectors
     LayouterChoice layouterChoice = LAYOUTER_AUTO; // which new layouting algorithm to use
     bool arrangeVectorConnections = false; // arrange connections on vector gates parallel to each other
+    int largeModuleThreshold = 1000;       // module inspectors switch to level-of-detail rendering above this many submodules
     bool showBubbles = true;               // show result of bubble() calls
     long updateFreqExpress = 1000;         // Express Run updates display every N milliseconds
     bool autoupdateInExpress = true;       // update inspectors at every display refresh in EXPRESS mode or not
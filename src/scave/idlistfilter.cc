@@ -0,0 +1,309 @@
+//=========================================================================
+//  IDLISTFILTER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include "common/stringutil.h"
+#include "fields.h" // for name constants
+#include "resultfilemanager.h"
+#include "interruptedflag.h"
+#include "idlistfilter.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace scave {
+
+// gives access to the parser of MatchExpression
+class MatchExpressionElemParser : public MatchExpression
+{
+  public:
+    using MatchExpression::parsePattern;
+};
+
+static const int WORDBITS = 8 * sizeof(IDListFilter::Word);
+
+IDListFilter::IDListFilter(const char *pattern)
+{
+    if (opp_isblank(pattern))  // no filter
+        throw opp_runtime_error("Empty filter expression is not allowed");
+
+    MatchExpressionElemParser parser;
+    std::vector<MatchExpression::Elem> elems = parser.parsePattern(pattern);
+    if (elems.empty())
+        throw opp_runtime_error("Empty filter expression is not allowed");
+
+    std::vector<int> stack;  // indices of the steps whose results are not yet operands
+    for (auto& elem : elems) {
+        switch (elem.type) {
+            case MatchExpression::Elem::PATTERN: {
+                const std::string& fieldName = elem.fieldname.empty() ? std::string(Scave::NAME) : elem.fieldname;
+                steps.push_back(Step{Step::TEST, addTest(fieldName, elem.pattern), -1, -1});
+                break;
+            }
+            case MatchExpression::Elem::AND:
+            case MatchExpression::Elem::OR: {
+                if (stack.size() < 2)
+                    throw opp_runtime_error("Malformed filter expression");
+                int arg2 = stack.back();
+                stack.pop_back();
+                int arg1 = stack.back();
+                stack.pop_back();
+                steps.push_back(Step{elem.type == MatchExpression::Elem::AND ? Step::AND : Step::OR, -1, arg1, arg2});
+                break;
+            }
+            case MatchExpression::Elem::NOT: {
+                if (stack.size() < 1)
+                    throw opp_runtime_error("Malformed filter expression");
+                int arg1 = stack.back();
+                stack.pop_back();
+                steps.push_back(Step{Step::NOT, -1, arg1, -1});
+                break;
+            }
+            default:
+                throw opp_runtime_error("Malformed filter expression: Unknown element type");
+        }
+        stack.push_back(steps.size() - 1);
+    }
+    if (stack.size() != 1)
+        throw opp_runtime_error("Malformed filter expression");
+}
+
+int IDListFilter::addField(const std::string& name)
+{
+    for (int i = 0; i < (int)fields.size(); i++)
+        if (fields[i].name == name)
+            return i;
+
+    Field field;
+    field.name = name;
+    field.kind = ITEM_PROPERTY;
+    if (name == Scave::RUN)
+        field.kind = RUN_NAME;
+    else if (name == Scave::FILE)
+        field.kind = FILE_NAME;
+    else if (opp_stringbeginswith(name.c_str(), Scave::RUNATTR_PREFIX)) {
+        field.kind = RUN_ATTR;
+        field.key = name.substr(strlen(Scave::RUNATTR_PREFIX));
+    }
+    else if (opp_stringbeginswith(name.c_str(), Scave::ITERVAR_PREFIX)) {
+        field.kind = ITERVAR;
+        field.key = name.substr(strlen(Scave::ITERVAR_PREFIX));
+    }
+    else if (opp_stringbeginswith(name.c_str(), Scave::CONFIG_PREFIX)) {
+        field.kind = CONFIG;
+        field.key = name.substr(strlen(Scave::CONFIG_PREFIX));
+    }
+    else if (opp_stringbeginswith(name.c_str(), Scave::ATTR_PREFIX))
+        field.kind = ITEM_ATTR;
+    fields.push_back(field);
+    return fields.size() - 1;
+}
+
+int IDListFilter::addTest(const std::string& fieldName, const std::string& pattern)
+{
+    int fieldIndex = addField(fieldName);
+    for (int i = 0; i < (int)tests.size(); i++)
+        if (tests[i].fieldIndex == fieldIndex && tests[i].pattern == pattern)
+            return i;
+
+    PatternMatcher matcher(pattern.c_str(), false  /*dottedpath*/, true  /*fullstring*/, true  /*casesensitive*/);
+    tests.push_back(Test{fieldIndex, pattern, matcher});
+    return tests.size() - 1;
+}
+
+const char *IDListFilter::getRunLevelProperty(const Field& field, FileRun *fileRun) const
+{
+    switch (field.kind) {
+        case RUN_NAME: return fileRun->getRun()->getRunName().c_str();
+        case FILE_NAME: return fileRun->getFile()->getFileName().c_str();
+        case RUN_ATTR: return fileRun->getRun()->getAttribute(field.key).c_str();
+        case ITERVAR: return fileRun->getRun()->getIterationVariable(field.key).c_str();
+        case CONFIG: return fileRun->getRun()->getConfigValue(field.key).c_str();
+        default: Assert(false); return nullptr;
+    }
+}
+
+// Caches of one filter() call. Property values are returned as pointers into
+// pooled or otherwise stable strings, so the pointer identifies the value.
+// (Different pointers with the same content are harmless, they merely cause
+// an extra pattern match.) Item attributes are the exception: they may be
+// returned from a temporary, so they are matched without caching.
+struct IDListFilter::Evaluation
+{
+    const IDListFilter *filter;
+    const ResultFileManager *manager;
+
+    // the current block
+    ID ids[WORDBITS];
+    int blockSize = 0;
+
+    // per field: the values looked up for the items of the current block
+    std::vector<std::vector<const char *>> values;
+    std::vector<Word> lookedUp;  // bits of the items whose value is in values[]
+
+    // per field, for run-level fields: the value for the last file run
+    std::vector<FileRun *> lastFileRun;
+    std::vector<const char *> lastRunValue;
+
+    // per test: match results per distinct value
+    std::vector<std::unordered_map<const char *, bool>> matchCache;
+    std::vector<const char *> lastValue;
+    std::vector<bool> lastMatch;
+
+    Evaluation(const IDListFilter *filter, const ResultFileManager *manager);
+    void beginBlock(const IDList& idlist, int start);
+    const char *getValue(int fieldIndex, int bit);
+    bool matches(int testIndex, const char *value);
+};
+
+IDListFilter::Evaluation::Evaluation(const IDListFilter *filter, const ResultFileManager *manager) :
+    filter(filter), manager(manager),
+    values(filter->fields.size(), std::vector<const char *>(WORDBITS)), lookedUp(filter->fields.size()),
+    lastFileRun(filter->fields.size()), lastRunValue(filter->fields.size()),
+    matchCache(filter->tests.size()), lastValue(filter->tests.size()), lastMatch(filter->tests.size())
+{
+}
+
+void IDListFilter::Evaluation::beginBlock(const IDList& idlist, int start)
+{
+    blockSize = std::min(WORDBITS, idlist.size() - start);
+    for (int bit = 0; bit < blockSize; bit++)
+        ids[bit] = idlist.get(start + bit);
+    std::fill(lookedUp.begin(), lookedUp.end(), 0);
+}
+
+const char *IDListFilter::Evaluation::getValue(int fieldIndex, int bit)
+{
+    Word bitMask = (Word)1 << bit;
+    if (lookedUp[fieldIndex] & bitMask)
+        return values[fieldIndex][bit];
+
+    const Field& field = filter->fields[fieldIndex];
+    const char *value;
+    if (field.kind == ITEM_PROPERTY)
+        value = manager->getItemProperty(ids[bit], field.name.c_str());
+    else {
+        // IDs are typically grouped by file/run, so only look up on change
+        FileRun *fileRun = manager->getFileRun(ids[bit]);
+        if (fileRun != lastFileRun[fieldIndex]) {
+            lastFileRun[fieldIndex] = fileRun;
+            lastRunValue[fieldIndex] = filter->getRunLevelProperty(field, fileRun);
+        }
+        value = lastRunValue[fieldIndex];
+    }
+    values[fieldIndex][bit] = value;
+    lookedUp[fieldIndex] |= bitMask;
+    return value;
+}
+
+bool IDListFilter::Evaluation::matches(int testIndex, const char *value)
+{
+    if (value == lastValue[testIndex])
+        return lastMatch[testIndex];
+    auto& cache = matchCache[testIndex];
+    auto it = cache.find(value);
+    bool match;
+    if (it != cache.end())
+        match = it->second;
+    else
+        cache[value] = match = filter->tests[testIndex].matcher.matches(value);
+    lastValue[testIndex] = value;
+    lastMatch[testIndex] = match;
+    return match;
+}
+
+IDListFilter::Word IDListFilter::evaluateTest(int testIndex, Word mask, Evaluation& evaluation) const
+{
+    const Test& test = tests[testIndex];
+    const Field& field = fields[test.fieldIndex];
+    Word result = 0;
+    for (int bit = 0; bit < evaluation.blockSize; bit++) {
+        Word bitMask = (Word)1 << bit;
+        if (!(mask & bitMask))
+            continue;
+        bool match;
+        if (field.kind == ITEM_ATTR)
+            match = test.matcher.matches(evaluation.manager->getItemProperty(evaluation.ids[bit], field.name.c_str()));
+        else
+            match = evaluation.matches(testIndex, evaluation.getValue(test.fieldIndex, bit));
+        if (match)
+            result |= bitMask;
+    }
+    return result;
+}
+
+IDListFilter::Word IDListFilter::evaluateStep(int stepIndex, Word mask, Evaluation& evaluation) const
+{
+    // evaluates the step for the items in mask; the result is a subset of mask
+    const Step& step = steps[stepIndex];
+    switch (step.op) {
+        case Step::TEST:
+            return evaluateTest(step.testIndex, mask, evaluation);
+        case Step::AND: {
+            Word result = evaluateStep(step.arg1, mask, evaluation);
+            return result == 0 ? 0 : evaluateStep(step.arg2, result, evaluation);
+        }
+        case Step::OR: {
+            Word result = evaluateStep(step.arg1, mask, evaluation);
+            Word rest = mask & ~result;
+            return rest == 0 ? result : result | evaluateStep(step.arg2, rest, evaluation);
+        }
+        case Step::NOT:
+            return mask & ~evaluateStep(step.arg1, mask, evaluation);
+    }
+    Assert(false);
+    return 0;
+}
+
+IDList IDListFilter::filter(const ResultFileManager *manager, const IDList& idlist, int limit, InterruptedFlag *interrupted) const
+{
+    InterruptedFlag dummy;
+    if (interrupted == nullptr)
+        interrupted = &dummy;
+
+    Evaluation evaluation(this, manager);
+    int root = steps.size() - 1;
+    std::vector<ID> out;
+    int n = idlist.size();
+    for (int start = 0; start < n; start += WORDBITS) {
+        if ((start & 0xffff) == 0 && interrupted->flag)
+            throw InterruptedException("Result filtering interrupted");
+
+        evaluation.beginBlock(idlist, start);
+        int blockSize = evaluation.blockSize;
+        if (limit <= 0) {
+            Word mask = blockSize == WORDBITS ? ~(Word)0 : ((Word)1 << blockSize) - 1;
+            Word result = evaluateStep(root, mask, evaluation);
+            for (int bit = 0; bit < blockSize; bit++)
+                if (result & ((Word)1 << bit))
+                    out.push_back(evaluation.ids[bit]);
+        }
+        else {
+            // item by item, so that nothing is evaluated after the limit is reached
+            for (int bit = 0; bit < blockSize; bit++) {
+                if (evaluateStep(root, (Word)1 << bit, evaluation) != 0) {
+                    out.push_back(evaluation.ids[bit]);
+                    if ((int)out.size() == limit)
+                        return IDList(std::move(out));
+                }
+            }
+        }
+    }
+    return IDList(std::move(out));
+}
+
+} // namespace scave
+}  // namespace omnetpp
@@ -0,0 +1,117 @@
+//=========================================================================
+//  IDLISTFILTER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_IDLISTFILTER_H
+#define __OMNETPP_SCAVE_IDLISTFILTER_H
+
+#include <string>
+#include <vector>
+#include "common/matchexpression.h"
+#include "common/patternmatcher.h"
+#include "idlist.h"
+
+namespace omnetpp {
+namespace scave {
+
+class ResultFileManager;
+class InterruptedFlag;
+class FileRun;
+
+/**
+ * A filter expression (see MatchExpression) compiled into an evaluation
+ * plan that can be applied to large IDLists efficiently.
+ *
+ * The expression is evaluated on blocks of 64 IDs at a time, with the
+ * per-ID results stored as bits of a word. AND and OR are evaluated with
+ * short-circuit: the right operand is only evaluated for the IDs whose
+ * result still depends on it, so a property is only looked up for an ID
+ * if the equivalent item-by-item evaluation would look it up, too.
+ * Property values of result items are pooled strings (module names, result
+ * names, run attributes, etc.), so the result of each pattern match is
+ * cached per distinct string, i.e. a pattern is evaluated only once per
+ * distinct value, and run-level properties are only looked up when the
+ * run changes.
+ *
+ * The result is the same as that of evaluating the expression via
+ * MatchExpression on each item.
+ */
+class SCAVE_API IDListFilter
+{
+  public:
+    typedef uint64_t Word;
+
+  private:
+    enum FieldKind { ITEM_PROPERTY, ITEM_ATTR, RUN_NAME, FILE_NAME, RUN_ATTR, ITERVAR, CONFIG };
+
+    // a distinct property referenced by the expression
+    struct Field {
+        std::string name;  // as written in the filter expression, e.g. "module" or "runattr:network"
+        FieldKind kind;
+        std::string key;  // for RUN_ATTR, ITERVAR, CONFIG: the part after the prefix
+    };
+
+    // a "field =~ pattern" test; leaves of the expression
+    struct Test {
+        int fieldIndex;
+        std::string pattern;
+        common::PatternMatcher matcher;
+    };
+
+    // expression node; the last one is the root
+    struct Step {
+        enum Op {TEST, AND, OR, NOT};
+        Op op;
+        int testIndex;  // for TEST
+        int arg1, arg2;  // operands (step indices) for AND, OR (both) and NOT (arg1)
+    };
+
+    struct Evaluation;  // caches of one filter() call
+
+    std::vector<Field> fields;
+    std::vector<Test> tests;
+    std::vector<Step> steps;
+
+  private:
+    int addField(const std::string& name);
+    int addTest(const std::string& fieldName, const std::string& pattern);
+    const char *getRunLevelProperty(const Field& field, FileRun *fileRun) const;
+    Word evaluateStep(int stepIndex, Word mask, Evaluation& evaluation) const;
+    Word evaluateTest(int testIndex, Word mask, Evaluation& evaluation) const;
+
+  public:
+    /**
+     * Compiles the given filter expression. Throws an exception if the
+     * expression is syntactically incorrect. The expression must not be empty.
+     */
+    IDListFilter(const char *pattern);
+
+    /**
+     * Returns the number of distinct "field =~ pattern" tests in the expression.
+     */
+    int getNumTests() const {return tests.size();}
+
+    /**
+     * Returns the IDs from the input list that match the filter expression,
+     * in the original order. If limit is positive, at most that many IDs are
+     * returned, and IDs after the last returned one are not evaluated.
+     * The caller is responsible for locking the ResultFileManager.
+     */
+    IDList filter(const ResultFileManager *manager, const IDList& idlist, int limit=-1, InterruptedFlag *interrupted=nullptr) const;
+};
+
+} // namespace scave
+}  // namespace omnetpp
+
+
+#endif
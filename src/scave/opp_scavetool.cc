@@ -29,6 +29,7 @@
 #include "resultfilemanager.h"
 #include "indexfileutils.h"
 #include "fields.h"
+#include "quantilesketch.h"
 #include "scaveutils.h"
 #include "sqliteresultfileutils.h"
 #include "exporter.h"
@@ -89,11 +90,12 @@ void ScaveTool::printHelpPage(const std::string& page)
         help.option("-e  --list-qnames", "List unique result names qualified with the module names they occur with");
         help.option("-r, --list-runs", "List unique runs");
         help.option("-c, --list-configs", "List unique configuration names");
+        help.option("-q, --quantiles <list>", "Merge the quantile sketches (histograms recorded with the 'quantiles' recorder) with the same module and name across runs, and print the given quantiles of the merged distributions; <list> is a comma-separated list of numbers in the [0,1] interval, e.g. 0.5,0.99");
         help.line();
         help.line("Options:");
         help.option("-T, --type <types>", "Limit item types; <types> is concatenation of type characters (v=vector, s=scalar, t=statistic, h=histogram, p=parameter).");
         help.option("-f, --filter <filter>", "Filter for result items (vectors, scalars, statistics, histograms, parameters) matched by filter expression (try 'help filter')");
-        help.option("-p, --per-run", "Per-run reporting (where applicable)");
+        help.option("-p, --per-run", "Per-run reporting (where applicable; with -q, sketches are not merged across runs)");
         help.option("-b, --bare", "Suppress labels (more suitable for machine processing)");
         help.option("-g, --grep-friendly", "Grep-friendly: with -p, put run names at the start of each line, not above groups as headings.");
         help.option("    --tabs", "Use tabs in tables instead of padding with spaces.");
@@ -351,7 +353,7 @@ void ScaveTool::queryCommand(int argc, char **argv)
 {
     enum QueryMode {
         PRINT_SUMMARY, LIST_RESULTS, LIST_RUNATTRS, LIST_ITERVARS, LIST_CONFIGENTRIES,
-        LIST_MODULES, LIST_NAMES, LIST_MODULE_AND_NAME_PAIRS, LIST_RUNS, LIST_CONFIGS
+        LIST_MODULES, LIST_NAMES, LIST_MODULE_AND_NAME_PAIRS, LIST_RUNS, LIST_CONFIGS, PRINT_QUANTILES
     };
 
     QueryMode opt_mode = PRINT_SUMMARY;
@@ -359,6 +361,7 @@ void ScaveTool::queryCommand(int argc, char **argv)
     string opt_filterExpression = "*";
     string opt_resultTypeFilterStr;
     string opt_runDisplayModeStr;
+    string opt_quantilesStr;
     int opt_resultTypeFilter = ResultFileManager::SCALAR | ResultFileManager::VECTOR | ResultFileManager::STATISTICS | ResultFileManager::HISTOGRAM | ResultFileManager::PARAMETER;
     RunDisplayMode opt_runDisplayMode = RUNDISPLAY_RUNID;
     bool opt_includeFields = false;
@@ -397,6 +400,10 @@ void ScaveTool::queryCommand(int argc, char **argv)
             opt_mode = LIST_RUNS;
         else if (opt == "-c" || opt == "--list-configs")
             opt_mode = LIST_CONFIGS;
+        else if ((opt == "-q" || opt == "--quantiles") && i != argc-1) {
+            opt_mode = PRINT_QUANTILES;
+            opt_quantilesStr = unquoteString(argv[++i]);
+        }
         else if ((opt == "-T" || opt == "--type") && i != argc-1)
             opt_resultTypeFilterStr = unquoteString(argv[++i]);
         else if (opt.substr(0,2) == "-T")
@@ -445,6 +452,15 @@ void ScaveTool::queryCommand(int argc, char **argv)
             throw opp_runtime_error("Invalid run display mode '%s' in '-D' option", opt_runDisplayModeStr.c_str());
     }
 
+    // resolve -q, quantiles
+    vector<double> quantiles;
+    for (const string& item : StringTokenizer(opt_quantilesStr.c_str(), ", ").asVector()) {
+        double q = opp_atof(item.c_str());
+        if (!(q >= 0 && q <= 1))
+            throw opp_runtime_error("Invalid quantile '%s' in '-q' option, must be in the [0,1] interval", item.c_str());
+        quantiles.push_back(q);
+    }
+
     // load files
     ResultFileManager resultFileManager;
     loadFiles(resultFileManager, opt_fileNames, opt_indexingAllowed, opt_verbose);
@@ -636,6 +652,53 @@ void ScaveTool::queryCommand(int argc, char **argv)
         print(out, uniqueConfigNames);
         break;
     }
+    case PRINT_QUANTILES: {
+        // histograms without the relativeAccuracy attribute are not quantile sketches
+        std::vector<ID> sketchIds;
+        for (ID id : histograms)
+            if (!resultFileManager.getHistogram(id)->getAttribute("relativeAccuracy").empty())
+                sketchIds.push_back(id);
+        IDList sketches(std::move(sketchIds));
+        RunList groupRuns = {nullptr};  // nullptr: merge across all runs
+        if (opt_perRun) {
+            groupRuns = resultFileManager.getUniqueRuns(sketches);
+            std::sort(groupRuns.begin(), groupRuns.end(), [](Run *a, Run *b)  {return a->getRunName() < b->getRunName();});
+        }
+        for (Run *run : groupRuns) {
+            string runName = run ? runStr(run, opt_runDisplayMode) : "";
+            string maybeRunColumnWithTab = opt_grepFriendly && run ? runName + "\t" : "";
+            if (run && !opt_grepFriendly)
+                out << runName << ":" << endl << endl;
+            IDList runSketches = run ? resultFileManager.filterIDList(sketches, run, nullptr, nullptr) : sketches;
+
+            // group by module and name, in the order of first occurrence
+            std::map<std::pair<string,string>, std::vector<ID>> groups;
+            std::vector<std::pair<string,string>> keys;
+            for (ID id : runSketches) {
+                const HistogramResult *h = resultFileManager.getHistogram(id);
+                auto key = std::make_pair(h->getModuleName(), h->getName());
+                if (groups.find(key) == groups.end())
+                    keys.push_back(key);
+                groups[key].push_back(id);
+            }
+#define L(label) (opt_bare ? "\t" : "\t" label "=")
+            for (auto& key : keys) {
+                IDList group(std::move(groups[key]));
+                QuantileSketch sketch = QuantileSketch::mergeAll(&resultFileManager, group);
+                out << maybeRunColumnWithTab << key.first << "\t" << key.second;
+                if (!run)
+                    out << L("runs") << resultFileManager.getUniqueRuns(group).size();
+                out << L("count") << sketch.getSumWeights();
+                for (double q : quantiles)
+                    out << (opt_bare ? "\t" : "\tq" + opp_stringf("%g", q) + "=") << sketch.getQuantile(q);
+                out << endl;
+            }
+#undef L
+            if (run)
+                out << endl;
+        }
+        break;
+    }
     default: {
         Assert(false);
     }
@@ -0,0 +1,158 @@
+//=========================================================================
+//  QUANTILESKETCH.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include "common/stringutil.h"
+#include "common/commonutil.h"
+#include "resultfilemanager.h"
+#include "scaveutils.h"
+#include "quantilesketch.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace scave {
+
+QuantileSketch::QuantileSketch(double relativeAccuracy) : relativeAccuracy(relativeAccuracy)
+{
+    if (!(relativeAccuracy > 0 && relativeAccuracy < 1))
+        throw opp_runtime_error("Quantile sketch: Relative accuracy must be in the (0,1) interval, %g given", relativeAccuracy);
+    logGamma = std::log((1 + relativeAccuracy) / (1 - relativeAccuracy));
+    min = INFINITY;
+    max = -INFINITY;
+}
+
+double QuantileSketch::getRelativeAccuracy(const HistogramResult& histogram)
+{
+    const std::string& value = histogram.getAttribute("relativeAccuracy");
+    double relativeAccuracy;
+    if (value.empty() || !parseDouble(value.c_str(), relativeAccuracy))
+        throw opp_runtime_error("Histogram %s.%s was not recorded as a quantile sketch (no 'relativeAccuracy' attribute)",
+                histogram.getModuleName().c_str(), histogram.getName().c_str());
+    return relativeAccuracy;
+}
+
+int QuantileSketch::getIndexOfEdge(double edge) const
+{
+    // edges are gamma^k; rounding compensates for floating-point and printing errors
+    return (int)std::lround(std::log(std::abs(edge)) / logGamma);
+}
+
+double QuantileSketch::getRepresentativeValue(int index) const
+{
+    double gamma = std::exp(logGamma);
+    return 2 * std::exp(index * logGamma) / (gamma + 1);
+}
+
+void QuantileSketch::merge(const HistogramResult& histogram)
+{
+    double histogramRelativeAccuracy = getRelativeAccuracy(histogram);
+    if (histogramRelativeAccuracy != relativeAccuracy)
+        throw opp_runtime_error("Cannot merge histogram %s.%s into quantile sketch: Relative accuracies differ (%g vs. %g)",
+                histogram.getModuleName().c_str(), histogram.getName().c_str(), relativeAccuracy, histogramRelativeAccuracy);
+    const Statistics& stat = histogram.getStatistics();
+    if (stat.isWeighted())
+        weighted = true;
+    merge(histogram.getHistogram(), stat.getMin(), stat.getMax());
+}
+
+void QuantileSketch::merge(const Histogram& histogram, double histogramMin, double histogramMax)
+{
+    // Bins are [-gamma^k, -gamma^(k-1)) for negative values, [gamma^(k-1), gamma^k)
+    // for positive values, with an optional bin around zero in between.
+    for (int i = 0; i < histogram.getNumBins(); i++) {
+        double value = histogram.getBinValue(i);
+        if (value == 0)
+            continue;
+        double lower = histogram.getBinEdge(i), upper = histogram.getBinEdge(i+1);
+        if (lower <= 0 && upper > 0)
+            zeroBinValue += value;
+        else if (upper <= 0)
+            negativeBins[getIndexOfEdge(lower)] += value;
+        else
+            positiveBins[getIndexOfEdge(upper)] += value;
+        totalWeight += value;
+    }
+    negInfs += histogram.getUnderflows();
+    posInfs += histogram.getOverflows();
+    totalWeight += histogram.getUnderflows() + histogram.getOverflows();
+    min = std::min(min, histogramMin);
+    max = std::max(max, histogramMax);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.relativeAccuracy != relativeAccuracy)
+        throw opp_runtime_error("Cannot merge quantile sketches: Relative accuracies differ (%g vs. %g)", relativeAccuracy, other.relativeAccuracy);
+    for (auto& bin : other.positiveBins)
+        positiveBins[bin.first] += bin.second;
+    for (auto& bin : other.negativeBins)
+        negativeBins[bin.first] += bin.second;
+    zeroBinValue += other.zeroBinValue;
+    weighted = weighted || other.weighted;
+    negInfs += other.negInfs;
+    posInfs += other.posInfs;
+    totalWeight += other.totalWeight;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+QuantileSketch QuantileSketch::mergeAll(ResultFileManager *manager, const IDList& histograms)
+{
+    if (histograms.isEmpty())
+        throw opp_runtime_error("Cannot merge quantile sketches: Empty list");
+    if (!histograms.areAllHistograms())
+        throw opp_runtime_error("Cannot merge quantile sketches: All items must be histograms");
+
+    QuantileSketch result(getRelativeAccuracy(*manager->getHistogram(histograms.get(0))));
+    for (ID id : histograms)
+        result.merge(*manager->getHistogram(id));
+    return result;
+}
+
+double QuantileSketch::getQuantile(double q) const
+{
+    if (q < 0 || q > 1)
+        throw opp_runtime_error("Quantile sketch: Argument must be in the [0,1] interval, %g given", q);
+    if (totalWeight == 0)
+        return NAN;
+    if (q == 0)
+        return min;
+    if (q == 1)
+        return max;
+
+    // walk the bins in increasing order of their values
+    double rank = weighted ? q * totalWeight : q * (totalWeight - 1);
+    double cumWeight = negInfs;
+    if (cumWeight > rank)
+        return -INFINITY;
+    for (auto it = negativeBins.rbegin(); it != negativeBins.rend(); ++it) {
+        cumWeight += it->second;
+        if (cumWeight > rank)
+            return std::min(std::max(-getRepresentativeValue(it->first), min), max);
+    }
+    cumWeight += zeroBinValue;
+    if (cumWeight > rank)
+        return std::min(std::max(0.0, min), max);
+    for (auto& bin : positiveBins) {
+        cumWeight += bin.second;
+        if (cumWeight > rank)
+            return std::min(std::max(getRepresentativeValue(bin.first), min), max);
+    }
+    return posInfs > 0 ? INFINITY : max;
+}
+
+} // namespace scave
+}  // namespace omnetpp
@@ -0,0 +1,111 @@
+//=========================================================================
+//  QUANTILESKETCH.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_QUANTILESKETCH_H
+#define __OMNETPP_SCAVE_QUANTILESKETCH_H
+
+#include <map>
+#include "common/histogram.h"
+#include "scavedefs.h"
+#include "idlist.h"
+
+namespace omnetpp {
+namespace scave {
+
+class ResultFileManager;
+class HistogramResult;
+
+/**
+ * Reconstructs quantile sketches recorded by the "quantiles" result
+ * recorder (cQuantileSketch in the simulation library) from their histogram
+ * form, and allows merging them (e.g. across modules or simulation runs)
+ * and querying quantiles of the merged distribution.
+ *
+ * Bin boundaries of the sketch are determined by the relative accuracy
+ * alone (bin k holds [gamma^(k-1), gamma^k), gamma=(1+alpha)/(1-alpha)),
+ * so the recorded bins can be mapped back to bin indices exactly, and
+ * merging does not lose accuracy.
+ */
+class SCAVE_API QuantileSketch
+{
+  private:
+    double relativeAccuracy;
+    double logGamma;
+    std::map<int,double> positiveBins;
+    std::map<int,double> negativeBins; // indexed by the absolute value
+    double zeroBinValue = 0;
+    double negInfs = 0, posInfs = 0;
+    double min, max;
+    double totalWeight = 0;
+    bool weighted = false;
+
+  private:
+    int getIndexOfEdge(double edge) const;
+    double getRepresentativeValue(int index) const;
+
+  public:
+    /**
+     * Creates an empty sketch with the given relative accuracy.
+     */
+    explicit QuantileSketch(double relativeAccuracy);
+
+    /**
+     * Returns the relative accuracy from the "relativeAccuracy" attribute
+     * of the histogram result, or throws an exception if the histogram was
+     * not recorded by the "quantiles" recorder.
+     */
+    static double getRelativeAccuracy(const HistogramResult& histogram);
+
+    /**
+     * Merges the given histogram result into the sketch. It must have been
+     * recorded with the same relative accuracy.
+     */
+    void merge(const HistogramResult& histogram);
+
+    /**
+     * Merges the given histogram (bin edges and values as recorded from
+     * cQuantileSketch) into the sketch. min and max are the exact minimum
+     * and maximum of the observations. Bin values are treated as counts,
+     * unless a weighted histogram result has been merged into the sketch.
+     */
+    void merge(const common::Histogram& histogram, double min, double max);
+
+    /**
+     * Merges another sketch into this one. The relative accuracies must match.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * Merges all histograms in the ID list, and returns the resulting sketch.
+     */
+    static QuantileSketch mergeAll(ResultFileManager *manager, const IDList& histograms);
+
+    double getRelativeAccuracy() const {return relativeAccuracy;}
+    double getSumWeights() const {return totalWeight;}
+    double getMin() const {return min;}
+    double getMax() const {return max;}
+
+    /**
+     * Returns the estimated q-quantile (0 <= q <= 1) of the merged
+     * observations, with the same relative accuracy as the original sketches.
+     * Returns NaN if the sketch is empty.
+     */
+    double getQuantile(double q) const;
+};
+
+} // namespace scave
+}  // namespace omnetpp
+
+
+#endif
@@ -44,6 +44,7 @@
 #include "sqliteresultfileloader.h"
 #include "vectorfileindex.h"
 #include "interruptedflag.h"
+#include "idlistfilter.h"
 
 
 #ifdef THREADED
@@ -915,17 +916,6 @@ IDList ResultFileManager::filterIDList(const IDList& idlist, const Run *run, con
     return IDList(std::move(result));
 }
 
-class MatchableResultItem : public MatchExpression::Matchable
-{
-    private:
-        const ResultFileManager *manager;
-        ID id;
-    public:
-        MatchableResultItem(const ResultFileManager *manager, ID id) : manager(manager), id(id) {}
-        virtual const char *getAsString() const override { return manager->getItemProperty(id, "name"); }
-        virtual const char *getAsString(const char *attribute) const override { return manager->getItemProperty(id, attribute); }
-};
-
 class MatchableRun : public MatchExpression::Matchable
 {
     private:
@@ -1093,27 +1083,12 @@ IDList ResultFileManager::filterIDList(const IDList& idlist, const char *pattern
     if (opp_isblank(pattern))  // no filter
         throw opp_runtime_error("Empty filter expression is not allowed");
 
-    MatchExpression matchExpr(pattern, false  /*dottedpath*/, true  /*fullstring*/, true  /*casesensitive*/);
-
-    InterruptedFlag dummy;
-    if (interrupted == nullptr)
-        interrupted = &dummy;
+    // compile the expression into a plan that evaluates 64 items at a time as
+    // bitsets, and matches patterns once per distinct pooled string
+    IDListFilter filter(pattern);
 
     READER_MUTEX
-    std::vector<ID> out;
-    int count = 0;
-    for (ID id : idlist) {
-        if (interrupted->flag)
-            throw InterruptedException("Result filtering interrupted");
-        MatchableResultItem matchable(this, id);
-        if (matchExpr.matches(&matchable)) {
-            out.push_back(id);
-            count++;
-            if (limit > 0 && count == limit)
-                break;
-        }
-    }
-    return IDList(std::move(out));
+    return filter.filter(this, idlist, limit, interrupted);
 }
 
 RunList ResultFileManager::filterRunList(const RunList& runlist, const char *pattern) const
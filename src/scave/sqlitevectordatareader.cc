@@ -109,7 +109,7 @@ void SqliteVectorDataReader::finalizeStatement()
     stmt = nullptr;
 }
 
-VectorDatum *SqliteVectorDataReader::getSingleEntry(int simtimeExp)
+VectorDatum *SqliteVectorDataReader::getSingleEntry(int vectorId, int simtimeExp)
 {
     assert(stmt != nullptr);
     int resultCode = sqlite3_step(stmt);
@@ -128,7 +128,7 @@ VectorDatum *SqliteVectorDataReader::getSingleEntry(int simtimeExp)
 
     finalizeStatement();
 
-    datum->serial = getSerialForRowId(rowid);
+    datum->serial = getSerialForRowId(vectorId, rowid);
 
     return datum;
 }
@@ -210,14 +210,15 @@ std::map<int, std::set<int>> SqliteVectorDataReader::groupVectorIdsBySimtimeExp(
     return result;
 }
 
-int SqliteVectorDataReader::getSerialForRowId(int64_t rowId)
+int SqliteVectorDataReader::getSerialForRowId(int vectorId, int64_t rowId)
 {
+    // note: the vectorId condition lets SQLite use the vectorId index, or the
+    // primary key of the clustered layout, where rowid is not the key
     prepareStatement(
         "SELECT COUNT(*) "
-        "FROM vectorData WHERE rowid < ? "
-        " AND vectorId IN (SELECT vectorId FROM vectorData WHERE rowid == ?);");
+        "FROM vectorData WHERE vectorId = ? AND rowid < ?;");
 
-    checkOK(sqlite3_bind_int64(stmt, 1, rowId));
+    checkOK(sqlite3_bind_int64(stmt, 1, vectorId));
     checkOK(sqlite3_bind_int64(stmt, 2, rowId));
 
     int resultCode = sqlite3_step(stmt);
@@ -269,7 +270,7 @@ VectorDatum *SqliteVectorDataReader::getEntryBySerial(int vectorId, int64_t seri
     checkOK(sqlite3_bind_int64(stmt, 1, vectorId));
     checkOK(sqlite3_bind_int64(stmt, 2, serial));
 
-    return getSingleEntry(getSimtimeExp(vectorId));
+    return getSingleEntry(vectorId, getSimtimeExp(vectorId));
 }
 
 VectorDatum *SqliteVectorDataReader::getEntryBySimtime(int vectorId, simultime_t simtime, bool after)
@@ -292,7 +293,7 @@ VectorDatum *SqliteVectorDataReader::getEntryBySimtime(int vectorId, simultime_t
     checkOK(sqlite3_bind_int64(stmt, 1, vectorId));
     checkOK(sqlite3_bind_int64(stmt, 2, simtime.getMantissaForScale(simtimeExp)));
 
-    return getSingleEntry(simtimeExp);
+    return getSingleEntry(vectorId, simtimeExp);
 }
 
 VectorDatum *SqliteVectorDataReader::getEntryByEventnum(int vectorId, eventnumber_t eventNum, bool after)
@@ -313,7 +314,7 @@ VectorDatum *SqliteVectorDataReader::getEntryByEventnum(int vectorId, eventnumbe
     checkOK(sqlite3_bind_int64(stmt, 1, vectorId));
     checkOK(sqlite3_bind_int64(stmt, 2, eventNum));
 
-    return getSingleEntry(getSimtimeExp(vectorId));
+    return getSingleEntry(vectorId, getSimtimeExp(vectorId));
 }
 
 void SqliteVectorDataReader::collectEntries(const std::set<int>& vectorIds)
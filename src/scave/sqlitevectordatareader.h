@@ -45,7 +45,7 @@ class SCAVE_API SqliteVectorDataReader : public IVectorDataReader
         void ensureDbOpen();
         int getSimtimeExp(int vectorId);
         std::map<int, std::set<int>> groupVectorIdsBySimtimeExp(const std::set<int>& vectorIds);
-        int getSerialForRowId(int64_t rowId);
+        int getSerialForRowId(int vectorId, int64_t rowId);
         static double sqlite3ColumnDouble(sqlite3_stmt *stmt, int fieldIdx);
         inline void checkOK(int sqlite3_result);
         inline void checkRow(int sqlite3_result);
@@ -53,7 +53,7 @@ class SCAVE_API SqliteVectorDataReader : public IVectorDataReader
         void prepareStatement(const char *sql);
         void finalizeStatement();
 
-        VectorDatum *getSingleEntry(int simtimeExp);
+        VectorDatum *getSingleEntry(int vectorId, int simtimeExp);
         void processStatementRows();
 
     public:
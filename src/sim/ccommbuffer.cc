@@ -42,5 +42,17 @@ cObject *cCommBuffer::unpackObject()
     return obj;
 }
 
+void cCommBuffer::checkLayoutTag(size_t objectSize, const char *className)
+{
+    int tag;
+    unpack(tag);
+    int version = (unsigned int)tag >> 24;
+    if (version != COMPACT_LAYOUT_VERSION)
+        throw cRuntimeError("Parsim error: Cannot unpack %s: Unsupported compact layout version %d (expected %d)", className, version, COMPACT_LAYOUT_VERSION);
+    if ((tag & 0xffffff) != (int)(objectSize & 0xffffff))
+        throw cRuntimeError("Parsim error: Cannot unpack %s: Object layout mismatch (size %d bytes on the sender side, %d bytes locally) "
+                            "-- are all partitions compiled for the same platform from the same sources?", className, tag & 0xffffff, (int)(objectSize & 0xffffff));
+}
+
 }  // namespace omnetpp
 
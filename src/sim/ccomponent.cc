@@ -70,6 +70,8 @@ EXECUTE_ON_SHUTDOWN(cComponent::invalidateCachedResultRecorderLists())
 
 cComponent::cComponent(const char *name) : cDefaultOwner(name)
 {
+    setListOptional(true);
+
     componentType = nullptr;
     simulation = nullptr;
     componentId = -1;
@@ -85,6 +85,7 @@ cDefaultOwner::~cDefaultOwner()
             else {
                 getEnvir()->undisposedObject(objs[i]);
                 objs[i]->owner = nullptr; // as its current owner (this) is being deleted
+                objs[i]->pos = cOwnedObject::NOT_LISTED;
             }
         }
 
@@ -97,6 +98,12 @@ void cDefaultOwner::doInsert(cOwnedObject *obj)
 {
     ASSERT(obj != this || this == &defaultList);
 
+    obj->owner = this;
+    if ((flags & FL_LISTOPTIONAL) && (!cOwnedObject::ownerListTracking || obj->isOwnerListExempt())) {
+        obj->pos = cOwnedObject::NOT_LISTED;
+        return;
+    }
+
     if (numObjs >= capacity) {
         if (capacity == 0) {
             // this is if we're invoked before main, before our ctor run
@@ -112,38 +119,42 @@ void cDefaultOwner::doInsert(cOwnedObject *obj)
         }
     }
 
-    obj->owner = this;
     objs[obj->pos = numObjs++] = obj;
 #ifdef SIMFRONTEND_SUPPORT
     lastChangeSerial = changeCounter++;
 #endif
 }
 
-void cDefaultOwner::ownedObjectDeleted(cOwnedObject *obj)
+void cDefaultOwner::doRemove(cOwnedObject *obj)
 {
-    ASSERT(obj && obj->owner == this);
+    ASSERT(obj->pos < (unsigned int)numObjs && objs[obj->pos] == obj);
 
     // move last object to obj's old position
     int pos = obj->pos;
     (objs[pos] = objs[--numObjs])->pos = pos;
+    obj->pos = cOwnedObject::NOT_LISTED;
 #ifdef SIMFRONTEND_SUPPORT
     lastChangeSerial = changeCounter++;
 #endif
 }
 
+void cDefaultOwner::ownedObjectDeleted(cOwnedObject *obj)
+{
+    ASSERT(obj && obj->owner == this);
+
+    if (obj->pos != cOwnedObject::NOT_LISTED)
+        doRemove(obj);
+}
+
 void cDefaultOwner::yieldOwnership(cOwnedObject *obj, cObject *newowner)
 {
-    ASSERT(obj && obj->owner == this && numObjs > 0);
+    ASSERT(obj && obj->owner == this);
 
     // give object to its new owner
     obj->owner = newowner;
 
-    // move last object to obj's old position
-    int pos = obj->pos;
-    (objs[pos] = objs[--numObjs])->pos = pos;
-#ifdef SIMFRONTEND_SUPPORT
-    lastChangeSerial = changeCounter++;
-#endif
+    if (obj->pos != cOwnedObject::NOT_LISTED)
+        doRemove(obj);
 }
 
 std::string cDefaultOwner::str() const
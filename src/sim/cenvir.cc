@@ -35,6 +35,13 @@ cEnvir::~cEnvir()
 {
 }
 
+void cEnvir::setLoggingEnabled(bool enabled)
+{
+    loggingEnabled = enabled;
+    if (cSimulation::getActiveEnvir() == this)
+        cLog::updateEnvirLogLevel();
+}
+
 cConfigurationEx *cEnvir::getConfigEx()
 {
     cConfigurationEx *cfg = dynamic_cast<cConfigurationEx *>(getConfig());
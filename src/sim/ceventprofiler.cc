@@ -0,0 +1,291 @@
+//=========================================================================
+//  CEVENTPROFILER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include "common/stringutil.h"
+#include "omnetpp/ceventprofiler.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/cmessage.h"
+#include "omnetpp/ccomponenttype.h"
+#include "omnetpp/simutil.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HAVE_RDTSC
+#elif (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+namespace omnetpp {
+
+using namespace omnetpp::common;
+
+cEventProfiler::cEventProfiler(bool recordAsScalars) : recordAsScalars(recordAsScalars)
+{
+    calibrationTicks = readTicks();
+    calibrationNanos = opp_get_monotonic_clock_nsecs();
+}
+
+uint64_t cEventProfiler::readTicks()
+{
+#ifdef HAVE_RDTSC
+    return __rdtsc();
+#else
+    return opp_get_monotonic_clock_nsecs();
+#endif
+}
+
+double cEventProfiler::toSeconds(uint64_t ticks) const
+{
+#ifdef HAVE_RDTSC
+    // the TSC runs at a constant rate on all CPUs of the last decade, but
+    // the rate itself is not known, so compare it to the monotonic clock
+    uint64_t elapsedTicks = readTicks() - calibrationTicks;
+    int64_t elapsedNanos = opp_get_monotonic_clock_nsecs() - calibrationNanos;
+    return elapsedTicks == 0 ? 0 : ticks * (elapsedNanos / 1e9 / elapsedTicks);
+#else
+    return ticks / 1e9;
+#endif
+}
+
+void cEventProfiler::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    switch (eventType) {
+        case LF_ON_SIMULATION_START:
+        case LF_ON_SIMULATION_RESUME:
+            startMeasurement();
+            break;
+
+        case LF_ON_SIMULATION_PAUSE:
+        case LF_ON_SIMULATION_SUCCESS:
+        case LF_ON_SIMULATION_ERROR:
+            stopMeasurement();
+            break;
+
+        case LF_PRE_NETWORK_FINISH:
+            stopMeasurement();
+            if (recordAsScalars)
+                recordScalars();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void cEventProfiler::startMeasurement()
+{
+    if (!running) {
+        running = true;
+        runStartNanos = opp_get_monotonic_clock_nsecs();
+        runStartCpu = clock();
+    }
+}
+
+void cEventProfiler::stopMeasurement()
+{
+    if (running) {
+        running = false;
+        totalNanos += opp_get_monotonic_clock_nsecs() - runStartNanos;
+        totalCpuSeconds += (clock() - runStartCpu) / (double)CLOCKS_PER_SEC;
+    }
+}
+
+void cEventProfiler::collectModuleNames(int moduleId)
+{
+    if (moduleId >= (int)moduleStats.size())
+        moduleStats.resize(std::max(moduleId + 1, 2 * (int)moduleStats.size()));
+    ModuleStats& stats = moduleStats[moduleId];
+    if (stats.fullPath.empty()) {
+        cModule *module = getSimulation()->getModule(moduleId);
+        if (module) {
+            stats.fullPath = module->getFullPath();
+            stats.nedTypeName = module->getComponentType()->getFullName();
+        }
+    }
+}
+
+void cEventProfiler::beginEvent(cEvent *event)
+{
+    if (event->isMessage()) {
+        cMessage *msg = static_cast<cMessage *>(event);
+        currentModuleId = msg->getArrivalModuleId();
+        currentKind = msg->getKind();
+        if (currentModuleId >= (int)moduleStats.size() || moduleStats[currentModuleId].numEvents == 0)
+            collectModuleNames(currentModuleId);
+    }
+    else {
+        currentModuleId = -1;
+    }
+    currentClass = &typeid(*event);
+    currentStartTicks = readTicks();
+}
+
+void cEventProfiler::endEvent()
+{
+    uint64_t ticks = readTicks() - currentStartTicks;
+    if (!currentClass)
+        return;
+
+    Stats& classStat = classStats[currentClass];
+    classStat.numEvents++;
+    classStat.ticks += ticks;
+
+    if (currentModuleId >= 0) {
+        Stats& moduleStat = moduleStats[currentModuleId];
+        moduleStat.numEvents++;
+        moduleStat.ticks += ticks;
+        Stats& kindStat = kindStats[currentKind];
+        kindStat.numEvents++;
+        kindStat.ticks += ticks;
+    }
+    else {
+        nonMessageStats.numEvents++;
+        nonMessageStats.ticks += ticks;
+    }
+    currentClass = nullptr;
+}
+
+int64_t cEventProfiler::getNumEvents() const
+{
+    int64_t numEvents = 0;
+    for (const auto& entry : classStats)
+        numEvents += entry.second.numEvents;
+    return numEvents;
+}
+
+double cEventProfiler::getEventTime() const
+{
+    uint64_t ticks = 0;
+    for (const auto& entry : classStats)
+        ticks += entry.second.ticks;
+    return toSeconds(ticks);
+}
+
+const cEventProfiler::Stats *cEventProfiler::getModuleStats(int moduleId) const
+{
+    if (moduleId < 0 || moduleId >= (int)moduleStats.size() || moduleStats[moduleId].numEvents == 0)
+        return nullptr;
+    return &moduleStats[moduleId];
+}
+
+std::map<std::string,cEventProfiler::Stats> cEventProfiler::getNedTypeStats() const
+{
+    std::map<std::string,Stats> result;
+    for (const ModuleStats& moduleStat : moduleStats) {
+        if (moduleStat.numEvents > 0) {
+            Stats& stats = result[moduleStat.nedTypeName.empty() ? "(unknown)" : moduleStat.nedTypeName];
+            stats.numEvents += moduleStat.numEvents;
+            stats.ticks += moduleStat.ticks;
+        }
+    }
+    return result;
+}
+
+std::map<std::string,cEventProfiler::Stats> cEventProfiler::getClassStats() const
+{
+    std::map<std::string,Stats> result;
+    for (const auto& entry : classStats)
+        result[omnetpp::opp_typename(*entry.first)] = entry.second;
+    return result;
+}
+
+void cEventProfiler::recordScalars()
+{
+    cSimulation *sim = getSimulation();
+    for (int id = 0; id < (int)moduleStats.size(); id++) {
+        const ModuleStats& stats = moduleStats[id];
+        cModule *module = stats.numEvents > 0 ? sim->getModule(id) : nullptr;
+        if (module) {
+            module->recordScalar("profile:numEvents", stats.numEvents);
+            module->recordScalar("profile:time", toSeconds(stats.ticks), "s");
+        }
+    }
+
+    cModule *network = sim->getSystemModule();
+    if (!network)
+        return;
+    auto record = [=](const std::string& suffix, const Stats& stats) {
+        network->recordScalar(("profile:numEvents:" + suffix).c_str(), stats.numEvents);
+        network->recordScalar(("profile:time:" + suffix).c_str(), toSeconds(stats.ticks), "s");
+    };
+    for (const auto& entry : getNedTypeStats())
+        record("type=" + entry.first, entry.second);
+    for (const auto& entry : getClassStats())
+        record("class=" + entry.first, entry.second);
+    for (const auto& entry : kindStats)
+        record("kind=" + std::to_string(entry.first), entry.second);
+}
+
+void cEventProfiler::printTable(std::ostream& out, const char *title, const std::vector<std::pair<std::string,Stats>>& rows, uint64_t totalTicks, int maxRows) const
+{
+    std::vector<std::pair<std::string,Stats>> sortedRows = rows;
+    std::stable_sort(sortedRows.begin(), sortedRows.end(), [](const std::pair<std::string,Stats>& a, const std::pair<std::string,Stats>& b) {
+        return a.second.ticks > b.second.ticks;
+    });
+
+    out << "\n" << title << ":\n";
+    out << opp_stringf("  %10s %7s %12s %10s  %s\n", "time[s]", "share", "events", "ns/event", "name");
+    int numRows = std::min((int)sortedRows.size(), maxRows);
+    for (int i = 0; i < numRows; i++) {
+        const std::string& name = sortedRows[i].first;
+        const Stats& stats = sortedRows[i].second;
+        double seconds = toSeconds(stats.ticks);
+        out << opp_stringf("  %10.3f %6.1f%% %12" PRId64 " %10.0f  %s\n",
+                seconds, totalTicks == 0 ? 0.0 : 100.0 * stats.ticks / totalTicks, stats.numEvents,
+                stats.numEvents == 0 ? 0.0 : seconds * 1e9 / stats.numEvents, name.c_str());
+    }
+    if ((int)sortedRows.size() > numRows)
+        out << "  ... and " << sortedRows.size() - numRows << " more\n";
+}
+
+void cEventProfiler::printReport(std::ostream& out, int maxRows) const
+{
+    uint64_t totalTicks = 0;
+    for (const auto& entry : classStats)
+        totalTicks += entry.second.ticks;
+    double eventTime = toSeconds(totalTicks);
+    double loopTime = totalNanos / 1e9;
+
+    out << "\nProfiling results: " << getNumEvents() << " events, " << opp_stringf("%.3fs", eventTime) << " in event processing";
+    if (loopTime > 0)
+        out << opp_stringf(" (%.1f%% of the event loop, %.3fs wall clock time, %.3fs CPU time)", 100.0 * eventTime / loopTime, loopTime, totalCpuSeconds);
+    out << "\n";
+
+    std::vector<std::pair<std::string,Stats>> rows;
+    for (const ModuleStats& stats : moduleStats)
+        if (stats.numEvents > 0)
+            rows.push_back(std::make_pair(stats.fullPath.empty() ? "(unknown)" : stats.fullPath, stats));
+    if (nonMessageStats.numEvents > 0)
+        rows.push_back(std::make_pair("(non-message events)", nonMessageStats));
+    printTable(out, "Modules", rows, totalTicks, maxRows);
+
+    auto nedTypeStats = getNedTypeStats();
+    printTable(out, "NED types", std::vector<std::pair<std::string,Stats>>(nedTypeStats.begin(), nedTypeStats.end()), totalTicks, maxRows);
+
+    auto classStats = getClassStats();
+    printTable(out, "Event classes", std::vector<std::pair<std::string,Stats>>(classStats.begin(), classStats.end()), totalTicks, maxRows);
+
+    rows.clear();
+    for (const auto& entry : kindStats)
+        rows.push_back(std::make_pair("kind=" + std::to_string(entry.first), entry.second));
+    printTable(out, "Message kinds", rows, totalTicks, maxRows);
+    out.flush();
+}
+
+}  // namespace omnetpp
+
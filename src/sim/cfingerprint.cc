@@ -38,6 +38,11 @@
 
 namespace omnetpp {
 
+void cFingerprintCalculator::setExpectedFingerprints(const char *expectedFingerprints)
+{
+    throw cRuntimeError("%s does not support changing the expected fingerprints", getClassName());
+}
+
 #ifdef USE_OMNETPP4x_FINGERPRINTS
 
 Register_Class(cOmnetpp4xFingerprintCalculator);
@@ -58,6 +63,11 @@ void cOmnetpp4xFingerprintCalculator::initialize(const char *expectedFingerprint
     hasher = new cHasher();
 }
 
+void cOmnetpp4xFingerprintCalculator::setExpectedFingerprints(const char *expectedFingerprints)
+{
+    this->expectedFingerprints = expectedFingerprints;
+}
+
 void cOmnetpp4xFingerprintCalculator::addEvent(cEvent *event)
 {
     if (event->isMessage()) {
@@ -135,14 +145,12 @@ inline std::string getListItem(const std::string& list, int index)
     return (index >= 0 && index < (int)items.size()) ? items[index] : "";
 }
 
-void cSingleFingerprintCalculator::initialize(const char *expectedFingerprints, cConfiguration *cfg, int index)
+// fingerprints may have an ingredients string embedded in them after a "/" character;
+// if so, that overrides the fingerprint-ingredients configuration option.
+// The length of the hash part determines the hash function.
+static void parseExpectedFingerprints(const char *expectedFingerprints, std::string& options, int& algorithm)
 {
-    this->expectedFingerprints = expectedFingerprints;
-    hasher = new cHasher();
-
-    // fingerprints may have an ingredients string embedded in them after a "/" character;
-    // if so, that overrides the fingerprint-ingredients configuration option.
-    std::string options;
+    algorithm = -1;
     cStringTokenizer tokenizer(expectedFingerprints);
     while (tokenizer.hasMoreTokens()) {
         const char *fingerprint = tokenizer.nextToken();
@@ -154,7 +162,23 @@ void cSingleFingerprintCalculator::initialize(const char *expectedFingerprints,
             else if (options != currentOptions)
                 throw cRuntimeError("Fingerprint option suffixes (parts after the '/') must agree"); //TODO better msg
         }
+        std::string hash = slash ? std::string(fingerprint, slash-fingerprint) : std::string(fingerprint);
+        int currentAlgorithm = cHasher::getAlgorithmOf(hash.c_str());
+        if (algorithm == -1)
+            algorithm = currentAlgorithm;
+        else if (algorithm != currentAlgorithm)
+            throw cRuntimeError("Fingerprints must agree in length (32-bit and 64-bit fingerprints cannot be alternatives of each other)");
     }
+}
+
+void cSingleFingerprintCalculator::initialize(const char *expectedFingerprints, cConfiguration *cfg, int index)
+{
+    this->expectedFingerprints = expectedFingerprints;
+
+    std::string options;
+    int algorithm;
+    parseExpectedFingerprints(expectedFingerprints, options, algorithm);
+    hasher = new cHasher(algorithm == -1 ? cHasher::ROTATE_XOR : (cHasher::Algorithm)algorithm);
 
     // parse configuration
     if (index == -1)
@@ -165,6 +189,18 @@ void cSingleFingerprintCalculator::initialize(const char *expectedFingerprints,
     parseResultMatcher(getListItem(cfg->getAsString(CFGID_FINGERPRINT_RESULTS), index).c_str());
 }
 
+void cSingleFingerprintCalculator::setExpectedFingerprints(const char *expectedFingerprints)
+{
+    std::string options;
+    int algorithm;
+    parseExpectedFingerprints(expectedFingerprints, options, algorithm);
+    if (algorithm != -1 && algorithm != hasher->getAlgorithm())
+        throw cRuntimeError("Cannot change expected fingerprints to '%s': they select a different hash function", expectedFingerprints);
+    if (!options.empty() && options != ingredients)
+        throw cRuntimeError("Cannot change expected fingerprints to '%s': they select different ingredients", expectedFingerprints);
+    this->expectedFingerprints = expectedFingerprints;
+}
+
 std::string cSingleFingerprintCalculator::str() const
 {
     return hasher->str() + "/" + ingredients;
@@ -180,18 +216,131 @@ cSingleFingerprintCalculator::FingerprintIngredient cSingleFingerprintCalculator
 void cSingleFingerprintCalculator::parseIngredients(const char *s)
 {
     ingredients = s;
+    eventSteps.clear();
     for (; *s; s++) {
         char ch = *s;
-        switch (validateIngredient(ch)) {
+        FingerprintIngredient ingredient = validateIngredient(ch);
+        switch (ingredient) {
             case RESULT_SCALAR: addScalarResults = true; break;
             case RESULT_STATISTIC: addStatisticResults = true; break;
             case RESULT_VECTOR: addVectorResults = true; break;
             case EXTRA_DATA: addExtraData_ = true; break;
-            default: addEvents = true;
+            case DISPLAY_STRINGS: case CANVAS_FIGURES: addEvents = true; break; // handled in addVisuals()
+            default: addEvents = true; eventSteps.push_back(compileEventIngredient(ingredient));
         }
     }
 }
 
+cSingleFingerprintCalculator::EventStep cSingleFingerprintCalculator::compileEventIngredient(FingerprintIngredient ingredient)
+{
+    typedef cSingleFingerprintCalculator Self;
+    EventStep step;
+    step.ingredient = ingredient;
+    switch (ingredient) {
+        case EVENT_NUMBER:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                self->hasher->add(getSimulation()->getEventNumber());
+            };
+            break;
+        case SIMULATION_TIME:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                self->hasher->add(simTime().raw());
+            };
+            break;
+        case MESSAGE_FULL_NAME:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                self->hasher->add(info.event->getFullName());
+            };
+            break;
+        case MESSAGE_CLASS_NAME:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                self->hasher->add(info.event->getClassName());
+            };
+            break;
+        case MESSAGE_KIND:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.message != nullptr)
+                    self->hasher->add(info.message->getKind());
+            };
+            break;
+        case MESSAGE_BIT_LENGTH:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.packet != nullptr)
+                    self->hasher->add(info.packet->getBitLength());
+            };
+            break;
+        case MESSAGE_CONTROL_INFO_CLASS_NAME:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                cObject *controlInfo = info.message != nullptr ? info.message->getControlInfo() : nullptr;
+                if (controlInfo != nullptr)
+                    self->hasher->add(controlInfo->getClassName());
+            };
+            break;
+        case MESSAGE_DATA:
+#ifndef WITH_PARSIM
+            throw cRuntimeError("Fingerprint is configured to contain MESSAGE_DATA (d),"
+                                " but parallel simulation support is disabled (WITH_PARSIM=no)"
+                                " which is required for serialization.");
+#else
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.message != nullptr) {
+                    // NOTE: workaround for control info and context pointer which cannot be packed
+                    // TODO: we should rather use a network byte order serialization API
+                    cMemCommBuffer buffer;
+                    cMessage *copy = info.message->dup();
+                    copy->parsimPack(&buffer);
+                    self->hasher->add(buffer.getBuffer(), buffer.getMessageSize());
+                    delete copy;
+                }
+            };
+#endif
+            break;
+        case MODULE_ID:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.module != nullptr)
+                    self->hasher->add(info.module->getId());
+            };
+            break;
+        case MODULE_FULL_NAME:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.module != nullptr)
+                    self->hasher->add(info.module->getFullName());
+            };
+            break;
+        case MODULE_FULL_PATH:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.module != nullptr)
+                    self->hasher->add(info.module->getFullPath().c_str());
+            };
+            break;
+        case MODULE_CLASS_NAME:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                if (info.module != nullptr)
+                    self->hasher->add(info.module->getComponentType()->getClassName());
+            };
+            break;
+        case RANDOM_NUMBERS_DRAWN:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                for (int i = 0; i < getEnvir()->getNumRNGs(); i++)
+                    self->hasher->add(getEnvir()->getRNG(i)->getNumbersDrawn());
+            };
+            break;
+        case CLEAN_HASHER:
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient) {
+                self->hasher->reset();
+            };
+            break;
+        default:
+            // ingredients added by subclasses
+            step.fn = [](Self *self, const EventInfo& info, FingerprintIngredient ingredient) {
+                if (!self->addEventIngredient(info.event, ingredient))
+                    throw cRuntimeError("Unknown fingerprint ingredient '%c' (%d)", ingredient, ingredient);
+            };
+            break;
+    }
+    return step;
+}
+
 void cSingleFingerprintCalculator::parseEventMatcher(const char *s)
 {
     if (s && *s && strcmp("*", s) != 0) {
@@ -218,103 +367,35 @@ void cSingleFingerprintCalculator::parseResultMatcher(const char *s)
 
 void cSingleFingerprintCalculator::addEvent(cEvent *event)
 {
-    if (addEvents) {
+    if (eventSteps.empty())
+        return;
+
+    if (eventMatcher != nullptr) {
         const MatchableObject matchableEvent(event);
-        if (eventMatcher == nullptr || eventMatcher->matches(&matchableEvent)) {
-            cMessage *message = nullptr;
-            cPacket *packet = nullptr;
-            cObject *controlInfo = nullptr;
-            cModule *module = nullptr;
-            if (event->isMessage()) {
-                message = static_cast<cMessage *>(event);
-                if (message->isPacket())
-                    packet = static_cast<cPacket *>(message);
-                controlInfo = message->getControlInfo();
-                module = message->getArrivalModule();
-            }
+        if (!eventMatcher->matches(&matchableEvent))
+            return;
+    }
 
-            MatchableObject matchableModule(module);
-            if (module == nullptr || moduleMatcher == nullptr || moduleMatcher->matches(&matchableModule)) {
-                for (char & ch : ingredients) {
-                    FingerprintIngredient ingredient = (FingerprintIngredient) ch;
-                    if (!addEventIngredient(event, ingredient)) {
-                        switch (ingredient) {
-                            case EVENT_NUMBER:
-                                hasher->add(getSimulation()->getEventNumber()); break;
-                            case SIMULATION_TIME:
-                                hasher->add(simTime().raw()); break;
-                            case MESSAGE_FULL_NAME:
-                                hasher->add(event->getFullName()); break;
-                            case MESSAGE_CLASS_NAME:
-                                hasher->add(event->getClassName()); break;
-                            case MESSAGE_KIND:
-                                if (message != nullptr)
-                                    hasher->add(message->getKind());
-                                break;
-                            case MESSAGE_BIT_LENGTH:
-                                if (packet != nullptr)
-                                    hasher->add(packet->getBitLength());
-                                break;
-                            case MESSAGE_CONTROL_INFO_CLASS_NAME:
-                                if (controlInfo != nullptr)
-                                    hasher->add(controlInfo->getClassName());
-                                break;
-                            case MESSAGE_DATA:
-                                if (message != nullptr) {
-                                    // NOTE: workaround for control info and context pointer which cannot be packed
-                                    // TODO: we should rather use a network byte order serialization API
-#ifdef WITH_PARSIM
-                                    cMemCommBuffer buffer;
-                                    cMessage *copy = message->dup();
-                                    copy->parsimPack(&buffer);
-                                    hasher->add(buffer.getBuffer(), buffer.getMessageSize());
-                                    delete copy;
-#else
-                                    throw cRuntimeError("Fingerprint is configured to contain MESSAGE_DATA (d),"
-                                                        " but parallel simulation support is disabled (WITH_PARSIM=no)"
-                                                        " which is required for serialization.");
-#endif
-                                }
-                                break;
-                            case MODULE_ID:
-                                if (module != nullptr)
-                                    hasher->add(module->getId());
-                                break;
-                            case MODULE_FULL_NAME:
-                                if (module != nullptr)
-                                    hasher->add(module->getFullName());
-                                break;
-                            case MODULE_FULL_PATH:
-                                if (module != nullptr)
-                                    hasher->add(module->getFullPath().c_str());
-                                break;
-                            case MODULE_CLASS_NAME:
-                                if (module != nullptr)
-                                    hasher->add(module->getComponentType()->getClassName());
-                                break;
-                            case RANDOM_NUMBERS_DRAWN:
-                                for (int i = 0; i < getEnvir()->getNumRNGs(); i++)
-                                    hasher->add(getEnvir()->getRNG(i)->getNumbersDrawn());
-                                break;
-                            case CLEAN_HASHER:
-                                hasher->reset();
-                                break;
-                            case RESULT_SCALAR:
-                            case RESULT_STATISTIC:
-                            case RESULT_VECTOR:
-                            case DISPLAY_STRINGS:
-                            case CANVAS_FIGURES:
-                            case EXTRA_DATA:
-                                // not processed here
-                                break;
-                            default:
-                                throw cRuntimeError("Unknown fingerprint ingredient '%c' (%d)", ingredient, ingredient);
-                        }
-                    }
-                }
-            }
-        }
+    EventInfo info;
+    info.event = event;
+    info.message = nullptr;
+    info.packet = nullptr;
+    info.module = nullptr;
+    if (event->isMessage()) {
+        info.message = static_cast<cMessage *>(event);
+        if (info.message->isPacket())
+            info.packet = static_cast<cPacket *>(info.message);
+        info.module = info.message->getArrivalModule();
+    }
+
+    if (info.module != nullptr && moduleMatcher != nullptr) {
+        MatchableObject matchableModule(info.module);
+        if (!moduleMatcher->matches(&matchableModule))
+            return;
     }
+
+    for (const EventStep& step : eventSteps)
+        step.fn(this, info, step.ingredient);
 }
 
 bool cSingleFingerprintCalculator::addEventIngredient(cEvent *event, FingerprintIngredient ingredient)
@@ -442,6 +523,15 @@ void cMultiFingerprintCalculator::initialize(const char *expectedFingerprintsLis
     }
 }
 
+void cMultiFingerprintCalculator::setExpectedFingerprints(const char *expectedFingerprintsList)
+{
+    std::vector<std::string> expectedFingerprints = cStringTokenizer(expectedFingerprintsList, ",").asVector();
+    if (expectedFingerprints.size() != elements.size())
+        throw cRuntimeError("Cannot change expected fingerprints to '%s': the number of fingerprints differs", expectedFingerprintsList);
+    for (int i = 0; i < (int)expectedFingerprints.size(); i++)
+        elements[i]->setExpectedFingerprints(expectedFingerprints[i].c_str());
+}
+
 void cMultiFingerprintCalculator::addEvent(cEvent *event)
 {
     for (auto& element: elements)
@@ -15,47 +15,185 @@
    `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <cerrno>
+#include <cinttypes>
 #include "omnetpp/chasher.h"
 
 namespace omnetpp {
 
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char *p)
+{
+    uint64_t x;
+    memcpy(&x, p, 8);
+    return x;
+}
+
+static inline uint32_t read32(const unsigned char *p)
+{
+    uint32_t x;
+    memcpy(&x, p, 4);
+    return x;
+}
+
+static inline uint64_t xxh64Round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t xxh64MergeRound(uint64_t h, uint64_t acc)
+{
+    h ^= xxh64Round(0, acc);
+    return h * PRIME64_1 + PRIME64_4;
+}
+
+void cHasher::resetXxHash64()
+{
+    // seed 0
+    acc[0] = PRIME64_1 + PRIME64_2;
+    acc[1] = PRIME64_2;
+    acc[2] = 0;
+    acc[3] = -PRIME64_1;
+    totalLength = 0;
+    bufferLength = 0;
+}
+
+void cHasher::appendStripes(const void *data, size_t length)
+{
+    totalLength += length;
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned char *end = p + length;
+
+    // complete and consume the buffered stripe
+    if (bufferLength > 0) {
+        size_t n = 32 - bufferLength;
+        memcpy(buffer + bufferLength, p, n);
+        p += n;
+        for (int i = 0; i < 4; i++)
+            acc[i] = xxh64Round(acc[i], read64(buffer + 8*i));
+        bufferLength = 0;
+    }
+
+    // consume whole stripes directly from the input
+    for ( ; p + 32 <= end; p += 32)
+        for (int i = 0; i < 4; i++)
+            acc[i] = xxh64Round(acc[i], read64(p + 8*i));
+
+    // buffer the rest
+    bufferLength = end - p;
+    memcpy(buffer, p, bufferLength);
+}
+
 void cHasher::add(const char *p, size_t length)
 {
+    if (algorithm == XXHASH64) {
+        append(p, length);
+        return;
+    }
+
     // add the bulk in 4-byte chunks
     size_t lengthmod4 = length & ~3U;
     size_t i;
     for (i = 0; i < lengthmod4; i += 4)
-        merge((uint32_t)(p[i] | (p[i+1] << 8) | (p[i+2] << 16) | (p[i+3] << 24)));
+        rotateXor((uint32_t)(p[i] | (p[i+1] << 8) | (p[i+2] << 16) | (p[i+3] << 24)));
 
     // add the 1, 2 or 3 bytes left
     switch (length - i) {
         case 0: break;
-        case 1: merge((uint32_t)(p[i])); break;
-        case 2: merge((uint32_t)(p[i] | (p[i+1] << 8))); break;
-        case 3: merge((uint32_t)(p[i] | (p[i+1] << 8) | (p[i+2] << 16))); break;
+        case 1: rotateXor((uint32_t)(p[i])); break;
+        case 2: rotateXor((uint32_t)(p[i] | (p[i+1] << 8))); break;
+        case 3: rotateXor((uint32_t)(p[i] | (p[i+1] << 8) | (p[i+2] << 16))); break;
         default: ASSERT(false);
     }
 }
 
-uint32_t cHasher::parse(const char *hash) const
+uint64_t cHasher::getHash64() const
 {
-    // remove spaces, hyphens and colons before parsing
+    if (algorithm != XXHASH64)
+        return value;
+
+    // xxHash64 finalization: merge the accumulators, then the buffered bytes
+    uint64_t h;
+    if (totalLength >= 32) {
+        h = rotl64(acc[0], 1) + rotl64(acc[1], 7) + rotl64(acc[2], 12) + rotl64(acc[3], 18);
+        for (int i = 0; i < 4; i++)
+            h = xxh64MergeRound(h, acc[i]);
+    }
+    else
+        h = PRIME64_5;  // seed 0
+    h += totalLength;
+
+    const unsigned char *p = buffer;
+    const unsigned char *end = buffer + bufferLength;
+    for ( ; p + 8 <= end; p += 8) {
+        h ^= xxh64Round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for ( ; p < end; p++) {
+        h ^= *p * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+    }
+
+    // avalanche
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static std::string stripSeparators(const char *hash)
+{
+    // remove spaces, hyphens and colons
     std::string s;
     for (const char *p = hash; *p; p++)
         if (*p != ' ' && *p != '-' && *p != ':')
             s += *p;
+    return s;
+}
 
-    // parse
+uint32_t cHasher::parse(const char *hash) const
+{
+    uint64_t value = parse64(hash);
+    if ((uint32_t)value != value)
+        throw cRuntimeError("Cannot verify hash: Invalid hash text \"%s\"", hash);
+    return (uint32_t)value;
+}
+
+uint64_t cHasher::parse64(const char *hash) const
+{
+    std::string s = stripSeparators(hash);
     char *e;
-    unsigned long d = strtoul(s.c_str(), &e, 16);
-    uint32_t value = (uint32_t)d;
-    if (*e || value != d)
+    errno = 0;
+    unsigned long long d = strtoull(s.c_str(), &e, 16);
+    uint64_t value = (uint64_t)d;
+    if (*e || errno == ERANGE || value != d)
         throw cRuntimeError("Cannot verify hash: Invalid hash text \"%s\"", hash);
     return value;
 }
 
 bool cHasher::equals(const char *hash) const
 {
+    if (algorithm == XXHASH64)
+        return getHash64() == parse64(hash);
     uint32_t value = parse(hash);
     return getHash() == value;
 }
@@ -63,12 +201,21 @@ bool cHasher::equals(const char *hash) const
 std::string cHasher::str() const
 {
     char buf[32];
-    sprintf(buf, "%08x", getHash());
+    if (algorithm == XXHASH64)
+        sprintf(buf, "%016" PRIx64, getHash64());
+    else
+        sprintf(buf, "%08x", getHash());
     std::string str = buf;
-    str.insert(str.length() - 4, "-");
+    for (int pos = str.length() - 4; pos > 0; pos -= 4)
+        str.insert(pos, "-");
     return str;
 }
 
+cHasher::Algorithm cHasher::getAlgorithmOf(const char *hash)
+{
+    return stripSeparators(hash).length() > 8 ? XXHASH64 : ROTATE_XOR;
+}
+
 /* XXX to test case
 
 int main(int argc, char **argv)
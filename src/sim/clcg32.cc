@@ -109,6 +109,21 @@ double cLCG32::doubleRand()
     return (double)intRand() * (1.0 / LCG32_MAX);
 }
 
+void cLCG32::fillDoubles(double *dest, int n)
+{
+    // same as doubleRand() in a loop, without the virtual calls
+    numDrawn += n;
+    const long int a = 16807, q = 127773, r = 2836;
+    long int s = seed;
+    for (int i = 0; i < n; i++) {
+        s = a * (s % q) - r * (s / q);
+        if (s <= 0)
+            s += LCG32_MAX + 1;
+        dest[i] = (double)(unsigned long)(s - 1) * (1.0 / LCG32_MAX);
+    }
+    seed = s;
+}
+
 double cLCG32::doubleRandNonz()
 {
     return (double)(intRand() + 1) * (1.0 / (LCG32_MAX + 1));
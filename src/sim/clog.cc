@@ -24,6 +24,7 @@
 namespace omnetpp {
 
 LogLevel cLog::logLevel = LOGLEVEL_TRACE;
+LogLevel cLog::envirLogLevel = LOGLEVEL_TRACE;
 cLog::NoncomponentLogPredicate cLog::noncomponentLogPredicate = &cLog::defaultNoncomponentLogPredicate;
 cLog::ComponentLogPredicate cLog::componentLogPredicate = &cLog::defaultComponentLogPredicate;
 
@@ -73,6 +74,12 @@ LogLevel cLog::resolveLogLevel(const char *name)
         throw cRuntimeError("Unknown log level name '%s'", name);
 }
 
+void cLog::updateEnvirLogLevel()
+{
+    cEnvir *envir = getEnvir();
+    envirLogLevel = (envir && !envir->isLoggingEnabled()) ? LOGLEVEL_OFF : LOGLEVEL_TRACE;
+}
+
 bool cLog::defaultNoncomponentLogPredicate(const void *object, LogLevel logLevel, const char *category)
 {
     // log called from outside cComponent methods, use context component to decide enablement
@@ -112,5 +112,11 @@ double cMersenneTwister::doubleRandIncl1()
     return rng.rand();
 }
 
+void cMersenneTwister::fillDoubles(double *dest, int n)
+{
+    numDrawn += n;
+    rng.fillExc(dest, n);
+}
+
 }  // namespace omnetpp
 
@@ -99,7 +99,7 @@ cModule::~cModule()
     }
 
     // adjust gates that were directed here
-    for (GateIterator it(this); !it.end(); ++it) {
+    for (GateIterator it(this, false); !it.end(); ++it) {
         cGate *gate = *it;
         if (gate->getNextGate() && gate->getNextGate()->getPreviousGate() == gate)
             gate->disconnect();
@@ -604,12 +604,27 @@ cGate *cModule::gate(int id)
             else
                 throw cRuntimeError(this, E_GATEID, id);  // id probably just plain garbage
         }
-        return isOutput ? desc->output.gatev[index] : desc->input.gatev[index];
+        cGate *g = isOutput ? desc->output.gatev[index] : desc->input.gatev[index];
+        return g ? g : materializeGate(desc, isOutput, index);
     }
 }
 
 #undef ENSURE
 
+cGate *cModule::materializeGate(cGate::Desc *desc, bool isOutput, int index) const
+{
+    // Note: this may be called from const methods (e.g. gate(id) const, GateIterator),
+    // but creating the gate object does not change the observable state of the module
+    cModule *self = const_cast<cModule *>(this);
+    cGate *newGate = self->createGateObject(isOutput ? cGate::OUTPUT : cGate::INPUT);
+    if (isOutput)
+        desc->setOutputGate(newGate, index);
+    else
+        desc->setInputGate(newGate, index);
+    EVCB.gateCreated(newGate);
+    return newGate;
+}
+
 cGate *cModule::addGate(const char *gatename, cGate::Type type, bool isVector)
 {
     char suffix;
@@ -708,7 +723,7 @@ void cModule::setGateSize(const char *gatename, int newSize)
     // we need to allocate more (to have good gate++ performance) but we
     // don't want to store the capacity -- so we'll always calculate the
     // capacity from the current size (by rounding it up to the nearest
-    // multiple of 2, 4, 16, 64).
+    // multiple of 2, 4, 16, 64, or to a power of two for large vectors).
     int oldCapacity = cGate::Desc::capacityFor(oldSize);
     int newCapacity = cGate::Desc::capacityFor(newSize);
 
@@ -716,18 +731,20 @@ void cModule::setGateSize(const char *gatename, int newSize)
     if (newSize < oldSize) {
         // remove excess gates
         for (int i = oldSize-1; i >= newSize; i--) {
-            // check & notify
+            // check & notify (gates not materialized yet are unconnected, and were never announced)
             if (type != cGate::OUTPUT) {
                 cGate *gate = desc->input.gatev[i];
-                if (gate->getPreviousGate() || gate->getNextGate())
+                if (gate && (gate->getPreviousGate() || gate->getNextGate()))
                     throw cRuntimeError(this, "setGateSize(): Cannot shrink gate vector %s[] to size %d, gate %s still connected", gatename, newSize, gate->getFullPath().c_str());
-                EVCB.gateDeleted(gate);
+                if (gate)
+                    EVCB.gateDeleted(gate);
             }
             if (type != cGate::INPUT) {
                 cGate *gate = desc->output.gatev[i];
-                if (gate->getPreviousGate() || gate->getNextGate())
+                if (gate && (gate->getPreviousGate() || gate->getNextGate()))
                     throw cRuntimeError(this, "setGateSize(): Cannot shrink gate vector %s[] to size %d, gate %s still connected", gatename, newSize, gate->getFullPath().c_str());
-                EVCB.gateDeleted(gate);
+                if (gate)
+                    EVCB.gateDeleted(gate);
             }
 
             // actually delete
@@ -758,23 +775,11 @@ void cModule::setGateSize(const char *gatename, int newSize)
         if (type != cGate::INPUT)
             reallocGatev(desc->output.gatev, oldCapacity, newCapacity);
 
-        // set new size beforehand, because EVCB.gateCreate() calls getId()
-        // which assumes that gate->index < gateSize.
+        // The additional gates are not created here: their slots stay nullptr,
+        // and gate objects are created by materializeGate() on first access.
+        // This makes large gate vectors of which only a few gates get
+        // connected (or which are grown one by one with gate++) cheap.
         desc->vectorSize = newSize;
-
-        // and create the additional gates
-        for (int i = oldSize; i < newSize; i++) {
-            if (type != cGate::OUTPUT) {
-                cGate *newGate = createGateObject(cGate::INPUT);
-                desc->setInputGate(newGate, i);
-                EVCB.gateCreated(newGate);
-            }
-            if (type != cGate::INPUT) {
-                cGate *newGate = createGateObject(cGate::OUTPUT);
-                desc->setOutputGate(newGate, i);
-                EVCB.gateCreated(newGate);
-            }
-        }
     }
 
 #ifdef SIMFRONTEND_SUPPORT
@@ -840,7 +845,8 @@ cGate *cModule::gate(const char *gatename, int index)
             throw cRuntimeError(this, "%s when accessing vector gate '%s'", (index == -1 ? "No gate index specified" : "Negative gate index specified"), gatename);
         if (index >= desc->vectorSize)
             throw cRuntimeError(this, "Gate index %d out of range when accessing vector gate '%s[]' with size %d", index, gatename, desc->vectorSize);
-        return isInput ? desc->input.gatev[index] : desc->output.gatev[index];
+        cGate *g = isInput ? desc->input.gatev[index] : desc->output.gatev[index];
+        return g ? g : materializeGate(const_cast<cGate::Desc *>(desc), !isInput, index);
     }
 }
 
@@ -862,10 +868,10 @@ int cModule::findGate(const char *gatename, int index) const
         return isInput ? desc->input.gate->getId() : desc->output.gate->getId();
     }
     else {
-        // gate is vector
+        // gate is vector; compute the ID without materializing the gate (see cGate::getId())
         if (index < 0 || index >= desc->vectorSize)
             return -1;  // index not specified (-1) or out of range
-        return isInput ? desc->input.gatev[index]->getId() : desc->output.gatev[index]->getId();
+        return ((descIndex+1) << GATEID_LBITS) | ((isInput ? 0 : 1) << (GATEID_LBITS-1)) | index;
     }
 }
 
@@ -877,6 +883,31 @@ cGate *cModule::gateHalf(const char *gatename, cGate::Type type, int index)
     return gate(nameWithSuffix, index);
 }
 
+void cModule::gatePair(const char *gatename, int index, cGate *& inputGate, cGate *& outputGate)
+{
+    char suffix;
+    cGate::Desc *desc = gateDesc(gatename, suffix);
+    if (suffix)
+        throw cRuntimeError(this, "gatePair(): Wrong gate name '%s', suffix '$i'/'$o' not accepted here", gatename);
+    if (desc->getType() != cGate::INOUT)
+        throw cRuntimeError(this, "gatePair(): Gate '%s' is not an inout gate", gatename);
+
+    if (!desc->isVector()) {
+        if (index != -1)
+            throw cRuntimeError(this, "Scalar gate '%s' referenced with index", gatename);
+        inputGate = desc->input.gate;
+        outputGate = desc->output.gate;
+    }
+    else {
+        if (index < 0)
+            throw cRuntimeError(this, "%s when accessing vector gate '%s'", (index == -1 ? "No gate index specified" : "Negative gate index specified"), gatename);
+        if (index >= desc->vectorSize)
+            throw cRuntimeError(this, "Gate index %d out of range when accessing vector gate '%s[]' with size %d", index, gatename, desc->vectorSize);
+        inputGate = desc->input.gatev[index] ? desc->input.gatev[index] : materializeGate(desc, false, index);
+        outputGate = desc->output.gatev[index] ? desc->output.gatev[index] : materializeGate(desc, true, index);
+    }
+}
+
 bool cModule::hasGate(const char *gatename, int index) const
 {
     char suffix;
@@ -923,37 +954,25 @@ bool cModule::isGateVector(const char *gatename) const
     return desc->isVector();
 }
 
-struct less_gateConnectedInside
-{
-    bool operator()(cGate *a, cGate *b) { return (a && a->isConnectedInside()) > (b && b->isConnectedInside()); }
-};
-
-struct less_gateConnectedOutside
-{
-    bool operator()(cGate *a, cGate *b) { return (a && a->isConnectedOutside()) > (b && b->isConnectedOutside()); }
-};
-
-struct less_gatePairConnectedInside
-{
-    cGate **otherv;
-    less_gatePairConnectedInside(cGate **otherv) { this->otherv = otherv; }
-    bool operator()(cGate *a, cGate *b)
-    {
-        return (a && a->isConnectedInside()) > (b && b->isConnectedInside()) &&
-               (a && otherv[a->getIndex()]->isConnectedInside()) > (b && otherv[b->getIndex()]->isConnectedInside());
-    }
-};
+// Note: nullptr (a gate that has not been materialized yet) counts as unconnected
+inline bool isConnectedInside(cGate *g) { return g && g->isConnectedInside(); }
+inline bool isConnectedOutside(cGate *g) { return g && g->isConnectedOutside(); }
 
-struct less_gatePairConnectedOutside
+// Returns the index of the first i in [0,size) for which isConnected(i) is false, assuming
+// that gates get connected from the beginning of the vector (see getOrCreateFirstUnconnectedGate()).
+template<typename Predicate>
+static int findFirstUnconnectedIndex(int size, Predicate isConnected)
 {
-    cGate **otherv;
-    less_gatePairConnectedOutside(cGate **otherv) { this->otherv = otherv; }
-    bool operator()(cGate *a, cGate *b)
-    {
-        return (a && a->isConnectedOutside()) > (b && b->isConnectedOutside()) &&
-               (a && otherv[a->getIndex()]->isConnectedOutside()) > (b && otherv[b->getIndex()]->isConnectedOutside());
+    int lo = 0, hi = size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (isConnected(mid))
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-};
+    return lo;
+}
 
 cGate *cModule::getOrCreateFirstUnconnectedGate(const char *gatename, char suffix,
         bool inside, bool expand)
@@ -989,27 +1008,27 @@ cGate *cModule::getOrCreateFirstUnconnectedGate(const char *gatename, char suffi
     // gates are not connected in order (i.e. some high gate indices get
     // connected before lower ones), binary search may not be able to find the
     // "holes" (unconnected gates) and we expand the gate unnecessarily.
-    // Note: nullptr is used as a synonym for "any unconnected gate" (see less_* struct).
-    cGate **it = inside ?
-        std::lower_bound(gatev, gatev + oldSize, (cGate *)nullptr, less_gateConnectedInside()) :
-        std::lower_bound(gatev, gatev + oldSize, (cGate *)nullptr, less_gateConnectedOutside());
-    if (it != gatev + oldSize)
-        return *it;
-
-    // no unconnected gate: expand gate vector
-    if (expand) {
-        setGateSize(desc->name->name.c_str(), oldSize + 1);
-        return inputSide ? desc->input.gatev[oldSize] : desc->output.gatev[oldSize];
+    int index = findFirstUnconnectedIndex(oldSize, [=](int i) {
+        return inside ? isConnectedInside(gatev[i]) : isConnectedOutside(gatev[i]);
+    });
+    if (index == oldSize) {
+        if (expand) {
+            // no unconnected gate: expand gate vector
+            setGateSize(desc->name->name.c_str(), oldSize + 1);
+        }
+        else {
+            // gate is not allowed to expand, so let's try harder to find an unconnected gate
+            // (in case the binary search missed it)
+            for (index = 0; index < oldSize; index++)
+                if (inside ? !isConnectedInside(gatev[index]) : !isConnectedOutside(gatev[index]))
+                    break;
+            if (index == oldSize)
+                return nullptr;  // sorry
+        }
     }
-    else {
-        // gate is not allowed to expand, so let's try harder to find an unconnected gate
-        // (in case the binary search missed it)
-        for (int i = 0; i < oldSize; i++)
-            if (inside ? !gatev[i]->isConnectedInside() : !gatev[i]->isConnectedOutside())
-                return gatev[i];
 
-        return nullptr;  // sorry
-    }
+    gatev = inputSide ? desc->input.gatev : desc->output.gatev;  // setGateSize() may have reallocated it
+    return gatev[index] ? gatev[index] : materializeGate(desc, !inputSide, index);
 }
 
 void cModule::getOrCreateFirstUnconnectedGatePair(const char *gatename,
@@ -1029,36 +1048,31 @@ void cModule::getOrCreateFirstUnconnectedGatePair(const char *gatename,
     cGate **inputgatev = desc->input.gatev;
     cGate **outputgatev = desc->output.gatev;
 
-    // binary search for the first unconnected gate -- see explanation in method above
-    cGate **it = inside ?
-        std::lower_bound(inputgatev, inputgatev + oldSize, (cGate *)nullptr, less_gatePairConnectedInside(outputgatev)) :
-        std::lower_bound(inputgatev, inputgatev + oldSize, (cGate *)nullptr, less_gatePairConnectedOutside(outputgatev));
-    if (it != inputgatev + oldSize) {
-        gatein = *it;
-        gateout = outputgatev[gatein->getIndex()];
-        return;
-    }
-
-    // no unconnected gate: expand gate vector
-    if (expand) {
-        setGateSize(desc->name->name.c_str(), oldSize + 1);
-        gatein = desc->input.gatev[oldSize];
-        gateout = desc->output.gatev[oldSize];
-        return;
+    // binary search for the first gate pair which is not fully connected -- see explanation in method above
+    int index = findFirstUnconnectedIndex(oldSize, [=](int i) {
+        return inside ? isConnectedInside(inputgatev[i]) && isConnectedInside(outputgatev[i]) :
+                        isConnectedOutside(inputgatev[i]) && isConnectedOutside(outputgatev[i]);
+    });
+    if (index == oldSize) {
+        if (expand) {
+            // no unconnected gate: expand gate vector
+            setGateSize(desc->name->name.c_str(), oldSize + 1);
+        }
+        else {
+            // gate is not allowed to expand, so let's try harder to find an unconnected gate
+            // (in case the binary search missed it)
+            for (index = 0; index < oldSize; index++)
+                if (inside ? !isConnectedInside(inputgatev[index]) && !isConnectedInside(outputgatev[index]) :
+                             !isConnectedOutside(inputgatev[index]) && !isConnectedOutside(outputgatev[index]))
+                    break;
+            if (index == oldSize) {
+                gatein = gateout = nullptr;  // sorry
+                return;
+            }
+        }
     }
-    else {
-        // gate is not allowed to expand, so let's try harder to find an unconnected gate
-        // (in case the binary search missed it)
-        for (int i = 0; i < oldSize; i++)
-            if (inside ? !inputgatev[i]->isConnectedInside() : !inputgatev[i]->isConnectedOutside())
-                if (inside ? !outputgatev[i]->isConnectedInside() : !outputgatev[i]->isConnectedOutside()) {
-                    gatein = inputgatev[i];
-                    gateout = outputgatev[i];
-                    return;
-                }
 
-        gatein = gateout = nullptr;  // sorry
-    }
+    gatePair(desc->name->name.c_str(), index, gatein, gateout);
 }
 
 int cModule::gateCount() const
@@ -1094,27 +1108,59 @@ bool cModule::checkInternalConnections() const
     // Note: checking of the inner side of compound module gates
     // cannot be turned off with @loose
     if (!isSimple()) {
-        for (GateIterator it(this); !it.end(); ++it) {
-            cGate *gate = *it;
-            if (gate->size() != 0 && !gate->isConnectedInside())
-                throw cRuntimeError(this, "Gate '%s' is not connected to a submodule (or internally to another gate of the same module)", gate->getFullPath().c_str());
-        }
+        cGate *gate = findUnconnectedGate(true, false);
+        if (gate)
+            throw cRuntimeError(this, "Gate '%s' is not connected to a submodule (or internally to another gate of the same module)", gate->getFullPath().c_str());
     }
 
     // check submodules
     for (SubmoduleIterator it(this); !it.end(); ++it) {
         cModule *submodule = *it;
-        for (GateIterator git(submodule); !git.end(); ++git) {
-            cGate *gate = *git;
-            if (gate->size() != 0 && !gate->isConnectedOutside() &&
-                gate->getProperties()->getAsBool("loose") == false &&
-                gate->getProperties()->getAsBool("directIn") == false)
-                throw cRuntimeError(this, "Gate '%s' is not connected to sibling or parent module", gate->getFullPath().c_str());
-        }
+        cGate *gate = submodule->findUnconnectedGate(false, true);
+        if (gate)
+            throw cRuntimeError(this, "Gate '%s' is not connected to sibling or parent module", gate->getFullPath().c_str());
     }
     return true;
 }
 
+cGate *cModule::findUnconnectedGate(bool inside, bool skipLooseGates) const
+{
+    // Note: we iterate over the gate descs instead of using GateIterator, so that
+    // gates that have not been materialized (and are thus unconnected) are not
+    // materialized here just for the check, and gate properties are only looked up
+    // once per gate vector.
+    for (int i = 0; i < gateDescArraySize; i++) {
+        cGate::Desc *desc = gateDescArray + i;
+        if (!desc->name || desc->gateSize() == 0)
+            continue;
+        if (skipLooseGates) {
+            cProperties *props = getComponentType()->getGateProperties(desc->name->name.c_str());
+            if (props->getAsBool("loose") || props->getAsBool("directIn"))
+                continue;
+        }
+        for (int side = 0; side < 2; side++) {
+            bool isOutput = side == 1;
+            if (desc->getType() == (isOutput ? cGate::INPUT : cGate::OUTPUT))
+                continue;
+            const cGate::Desc::Gates& gates = isOutput ? desc->output : desc->input;
+            if (!desc->isVector()) {
+                if (inside ? !gates.gate->isConnectedInside() : !gates.gate->isConnectedOutside())
+                    return gates.gate;
+            }
+            else {
+                for (int index = 0; index < desc->vectorSize; index++) {
+                    cGate *gate = gates.gatev[index];
+                    if (!gate)
+                        return materializeGate(desc, isOutput, index);  // for the error message
+                    if (inside ? !gate->isConnectedInside() : !gate->isConnectedOutside())
+                        return gate;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
 int cModule::findSubmodule(const char *name, int index) const
 {
     for (SubmoduleIterator it(this); !it.end(); ++it) {
@@ -1285,7 +1331,7 @@ void cModule::changeParentTo(cModule *module)
         throw cRuntimeError(this, "changeParentTo(): Got nullptr");
 
     // gates must be unconnected to avoid connections breaking module hierarchy rules
-    for (GateIterator it(this); !it.end(); ++it)
+    for (GateIterator it(this, false); !it.end(); ++it)
         if ((*it)->isConnectedOutside())
             throw cRuntimeError(this, "changeParentTo(): Gates of the module must not be "
                                       "connected (%s is connected now)", (*it)->getFullName());
@@ -1617,8 +1663,10 @@ cGate *cModule::GateIterator::current() const
         return isOutput ? desc->output.gate : desc->input.gate;
     else if (desc->vectorSize == 0)
         return nullptr;
-    else
-        return isOutput ? desc->output.gatev[index] : desc->input.gatev[index];
+    cGate *gate = isOutput ? desc->output.gatev[index] : desc->input.gatev[index];
+    if (!gate && materialize)
+        gate = module->materializeGate(desc, isOutput, index);
+    return gate;
 }
 
 void cModule::GateIterator::advance()
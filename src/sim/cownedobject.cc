@@ -55,6 +55,7 @@ void printAllObjects()
 
 // static class members
 cDefaultOwner *cOwnedObject::defaultOwner = &defaultList;
+bool cOwnedObject::ownerListTracking = true;
 long cOwnedObject::totalObjectCount = 0;
 long cOwnedObject::liveObjectCount = 0;
 
@@ -85,10 +86,24 @@ cOwnedObject::cOwnedObject(const char *name, bool namepooling) : cNamedObject(na
 #endif
 }
 
+cOwnedObject::cOwnedObject(const char *name, bool namepooling, bool ownerListExempt) : cNamedObject(name, namepooling)
+{
+    if (ownerListExempt)
+        setFlag(FL_OWNERLISTEXEMPT, true);  // before doInsert()
+    defaultOwner->doInsert(this);
+
+    // statistics
+    totalObjectCount++;
+    liveObjectCount++;
+#ifdef DEVELOPER_DEBUG
+    objectlist.insert(this);
+#endif
+}
+
 cOwnedObject::cOwnedObject(const cOwnedObject& obj) : cNamedObject(obj)
 {
+    copy(obj);  // before doInsert(), as it takes over the FL_OWNERLISTEXEMPT flag
     defaultOwner->doInsert(this);
-    copy(obj);
 
     // statistics
     totalObjectCount++;
@@ -129,6 +144,30 @@ cDefaultOwner *cOwnedObject::getDefaultOwner()
     return defaultOwner;
 }
 
+void cOwnedObject::setOwnerListExempt(bool b)
+{
+    if (b == isOwnerListExempt())
+        return;
+    setFlag(FL_OWNERLISTEXEMPT, b);
+
+    // make the change take effect if owned by a cDefaultOwner. Only objects
+    // on the list of a cDefaultOwner have pos != NOT_LISTED, so becoming
+    // exempt (the common case, from constructors) needs no dynamic_cast.
+    if (b) {
+        if (pos != NOT_LISTED) {
+            ASSERT(dynamic_cast<cDefaultOwner *>(owner) != nullptr);
+            cDefaultOwner *list = static_cast<cDefaultOwner *>(owner);
+            if (list->flags & cDefaultOwner::FL_LISTOPTIONAL)
+                list->doRemove(this);
+        }
+    }
+    else if (pos == NOT_LISTED) {
+        cDefaultOwner *list = dynamic_cast<cDefaultOwner *>(owner);
+        if (list)
+            list->doInsert(this);
+    }
+}
+
 void cOwnedObject::copy(const cOwnedObject& obj)
 {
     // Not too much to do:
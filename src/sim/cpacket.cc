@@ -34,6 +34,9 @@ using std::ostream;
 
 Register_Class(cPacket);
 
+long cPacket::sharedEncapsulationCount = 0;
+long cPacket::unsharingCopyCount = 0;
+
 cPacket::cPacket(const cPacket& pkt) : cMessage(pkt)
 {
     encapsulatedPacket = nullptr;
@@ -162,9 +165,13 @@ void cPacket::copy(const cPacket& msg)
     if (encapsulatedPacket)
         _deleteEncapMsg();
     encapsulatedPacket = msg.encapsulatedPacket;
-    if (encapsulatedPacket && ++encapsulatedPacket->shareCount == 0) {  // sharecount overflow
-        --encapsulatedPacket->shareCount;
-        take(encapsulatedPacket = (cPacket *)encapsulatedPacket->dup());
+    if (encapsulatedPacket) {
+        if (++encapsulatedPacket->shareCount == 0) {  // sharecount overflow
+            --encapsulatedPacket->shareCount;
+            take(encapsulatedPacket = (cPacket *)encapsulatedPacket->dup());
+        }
+        else
+            sharedEncapsulationCount++;
     }
 #endif
 
@@ -195,6 +202,7 @@ void cPacket::_detachEncapMsg()
 {
     if (encapsulatedPacket->shareCount > 0) {
         // "de-share" object - create our own copy
+        unsharingCopyCount++;
         encapsulatedPacket->shareCount--;
         if (encapsulatedPacket->owner == this)
             encapsulatedPacket->owner = nullptr;
@@ -259,6 +267,7 @@ cPacket *cPacket::decapsulate()
 
 #ifdef REFCOUNTING
     if (encapsulatedPacket->shareCount > 0) {
+        unsharingCopyCount++;
         encapsulatedPacket->shareCount--;
         if (encapsulatedPacket->owner == this)
             encapsulatedPacket->owner = nullptr;
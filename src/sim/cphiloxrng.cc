@@ -0,0 +1,210 @@
+//==========================================================================
+//  CPHILOXRNG.CC - part of
+//                 OMNeT++/OMNEST
+//              Discrete System Simulation in C++
+//
+// Contents:
+//   class cPhiloxRNG
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "omnetpp/cphiloxrng.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/cconfigoption.h"
+
+namespace omnetpp {
+
+Register_Class(cPhiloxRNG);
+
+Register_PerRunConfigOption(CFGID_SEED_N_PHILOX, "seed-%-philox", CFG_INT, nullptr, "When cPhiloxRNG is selected as random number generator: key for RNG number k. (Substitute k for '%' in the key.) The seed set and the RNG index are part of the counter, so different seed sets produce independent streams even with the same key.");
+
+#define PHILOX_M0    0xD2511F53U
+#define PHILOX_M1    0xCD9E8D57U
+#define PHILOX_W0    0x9E3779B9U
+#define PHILOX_W1    0xBB67AE85U
+#define PHILOX_ROUNDS    10
+
+#define KEYED_STREAM_FLAG    0x80000000U
+
+cPhiloxRNG::cPhiloxRNG()
+{
+    setUp(0, 0, 0);
+}
+
+void cPhiloxRNG::generateBlock(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t hi0 = (uint32_t)(p0 >> 32), lo0 = (uint32_t)p0;
+        uint32_t hi1 = (uint32_t)(p1 >> 32), lo1 = (uint32_t)p1;
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+}
+
+void cPhiloxRNG::setUp(uint64_t k, uint32_t streamId, uint32_t seedSet)
+{
+    key[0] = (uint32_t)k;
+    key[1] = (uint32_t)(k >> 32);
+    counter[0] = counter[1] = 0;
+    counter[2] = streamId;
+    counter[3] = seedSet;
+    outputIndex = 4;
+    numDrawn = 0;
+}
+
+void cPhiloxRNG::initialize(int seedSet, int rngId, int numRngs,
+        int parsimProcId, int parsimNumPartitions,
+        cConfiguration *cfg)
+{
+    char key[40];
+    sprintf(key, "seed-%d-philox", rngId);
+    const char *value = cfg->getConfigValue(key);
+    uint64_t k = value != nullptr ? (uint64_t)cConfiguration::parseLong(value, nullptr) : 0;
+
+    // with parallel simulation, every partition should get distinct streams
+    if (parsimNumPartitions > 1)
+        k ^= (uint64_t)(parsimProcId + 1) << 32;
+
+    setUp(k, rngId & ~KEYED_STREAM_FLAG, seedSet);
+}
+
+void cPhiloxRNG::initializeStream(int seedSet, uint64_t streamKey, int rngId, cConfiguration *cfg)
+{
+    // the flag separates keyed streams from the streams of global RNGs
+    setUp(streamKey, rngId | KEYED_STREAM_FLAG, seedSet);
+}
+
+void cPhiloxRNG::selfTest()
+{
+    // known-answer tests from the Random123 distribution (kat_vectors)
+    struct {
+        uint32_t counter[4], key[2], output[4];
+    } tests[] = {
+        {{0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+    };
+    for (auto& test : tests) {
+        uint32_t output[4];
+        generateBlock(test.counter, test.key, output);
+        for (int i = 0; i < 4; i++)
+            if (output[i] != test.output[i])
+                throw cRuntimeError("cPhiloxRNG: selfTest() failed, please report this problem!");
+    }
+
+    // skipping must be equivalent to drawing
+    cPhiloxRNG rng1, rng2;
+    rng1.setUp(12345, 1, 2);
+    rng2.setUp(12345, 1, 2);
+    for (int i = 0; i < 1001; i++)
+        rng1.intRand();
+    rng2.skip(1001);
+    if (rng1.intRand() != rng2.intRand() || rng1.getPosition() != rng2.getPosition())
+        throw cRuntimeError("cPhiloxRNG: selfTest() failed, please report this problem!");
+}
+
+unsigned long cPhiloxRNG::intRand()
+{
+    numDrawn++;
+    return next();
+}
+
+unsigned long cPhiloxRNG::intRandMax()
+{
+    return 0xffffffffUL;  // 2^32-1
+}
+
+unsigned long cPhiloxRNG::intRand(unsigned long n)
+{
+    if (n == 0 || n - 1 > 0xffffffffUL)
+        throw cRuntimeError("cPhiloxRNG: intRand(%lu): Argument out of range", n);
+
+    // find which bits are used in n-1, then draw until the result fits
+    // (the same method as in cMersenneTwister)
+    uint32_t max = n - 1;
+    uint32_t used = max;
+    used |= used >> 1;
+    used |= used >> 2;
+    used |= used >> 4;
+    used |= used >> 8;
+    used |= used >> 16;
+
+    numDrawn++;
+    uint32_t i;
+    do
+        i = next() & used;
+    while (i > max);
+    return i;
+}
+
+double cPhiloxRNG::doubleRand()
+{
+    numDrawn++;
+    return next() * (1.0 / 4294967296.0);
+}
+
+double cPhiloxRNG::doubleRandNonz()
+{
+    numDrawn++;
+    return (next() + 0.5) * (1.0 / 4294967296.0);
+}
+
+double cPhiloxRNG::doubleRandIncl1()
+{
+    numDrawn++;
+    return next() * (1.0 / 4294967295.0);
+}
+
+void cPhiloxRNG::fillDoubles(double *dest, int n)
+{
+    numDrawn += n;
+    for (int i = 0; i < n; i++)
+        dest[i] = next() * (1.0 / 4294967296.0);
+}
+
+uint64_t cPhiloxRNG::getPosition() const
+{
+    // counter[] points to the block after the one in output[]
+    uint64_t block = ((uint64_t)counter[1] << 32) | counter[0];
+    return block * 4 - (4 - outputIndex);
+}
+
+void cPhiloxRNG::seek(uint64_t position)
+{
+    uint64_t block = position / 4;
+    int index = position % 4;
+    counter[0] = (uint32_t)block;
+    counter[1] = (uint32_t)(block >> 32);
+    outputIndex = 4;
+    if (index != 0) {
+        next();  // generate the block, and advance the counter
+        outputIndex = index;
+    }
+}
+
+void cPhiloxRNG::skip(uint64_t n)
+{
+    seek(getPosition() + n);
+}
+
+}  // namespace omnetpp
@@ -0,0 +1,414 @@
+//=========================================================================
+//  CQUANTILESKETCH.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//   Member functions of
+//     cQuantileSketch: mergeable quantile sketch (DDSketch)
+//
+//=========================================================================
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstdio>
+#include <cmath>
+#include <cfloat>
+#include <limits>
+#include <algorithm>
+#include "omnetpp/globals.h"
+#include "omnetpp/cquantilesketch.h"
+#include "omnetpp/cexception.h"
+#include "common/stringutil.h"
+
+#ifdef WITH_PARSIM
+#include "omnetpp/ccommbuffer.h"
+#endif
+
+namespace omnetpp {
+
+using namespace omnetpp::common;
+
+Register_Class(cQuantileSketch);
+
+void cQuantileSketch::Store::add(int index, double weight, int maxBins)
+{
+    if (values.empty()) {
+        offset = index;
+        values.push_back(weight);
+        return;
+    }
+    if (index < offset) {
+        // indices below the range kept after collapsing go into its lowest bin
+        index = std::max(index, getMaxIndex() - maxBins + 1);
+        values.insert(values.begin(), offset - index, 0.0);
+        offset = index;
+    }
+    else if (index > getMaxIndex())
+        values.resize(index - offset + 1, 0.0);
+    values[index - offset] += weight;
+    collapse(maxBins);
+}
+
+void cQuantileSketch::Store::merge(const Store& other, int maxBins)
+{
+    for (int i = 0; i < (int)other.values.size(); i++)
+        if (other.values[i] != 0)
+            add(other.offset + i, other.values[i], maxBins);
+}
+
+void cQuantileSketch::Store::collapse(int maxBins)
+{
+    // fold the lowest bins into the lowest bin that is kept
+    int excess = (int)values.size() - maxBins;
+    if (excess <= 0)
+        return;
+    double sum = 0;
+    for (int i = 0; i <= excess; i++)
+        sum += values[i];
+    values.erase(values.begin(), values.begin() + excess);
+    values[0] = sum;
+    offset += excess;
+}
+
+cQuantileSketch::cQuantileSketch(const cQuantileSketch& r) : cAbstractHistogram(r)
+{
+    copy(r);
+}
+
+cQuantileSketch::cQuantileSketch(const char *name, double relativeAccuracy, int maxBins, bool weighted) :
+    cAbstractHistogram(name, weighted), relativeAccuracy(relativeAccuracy), maxBins(maxBins)
+{
+    if (!(relativeAccuracy > 0 && relativeAccuracy < 1))
+        throw cRuntimeError(this, "Relative accuracy must be in the (0,1) interval, %g given", relativeAccuracy);
+    if (maxBins < 1)
+        throw cRuntimeError(this, "Maximum number of bins must be positive, %d given", maxBins);
+    gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+    logGamma = std::log(gamma);
+    minIndexableValue = std::numeric_limits<double>::min() * gamma;
+}
+
+void cQuantileSketch::copy(const cQuantileSketch& other)
+{
+    relativeAccuracy = other.relativeAccuracy;
+    maxBins = other.maxBins;
+    gamma = other.gamma;
+    logGamma = other.logGamma;
+    minIndexableValue = other.minIndexableValue;
+    positiveBins = other.positiveBins;
+    negativeBins = other.negativeBins;
+    zeroBinValue = other.zeroBinValue;
+    numNegInfs = other.numNegInfs;
+    numPosInfs = other.numPosInfs;
+    negInfSumWeights = other.negInfSumWeights;
+    posInfSumWeights = other.posInfSumWeights;
+    binsValid = false;
+}
+
+cQuantileSketch& cQuantileSketch::operator=(const cQuantileSketch& res)
+{
+    if (this == &res)
+        return *this;
+    cAbstractHistogram::operator=(res);
+    copy(res);
+    return *this;
+}
+
+void cQuantileSketch::parsimPack(cCommBuffer *buffer) const
+{
+#ifndef WITH_PARSIM
+    throw cRuntimeError(this, E_NOPARSIM);
+#else
+    cAbstractHistogram::parsimPack(buffer);
+
+    buffer->pack(relativeAccuracy);
+    buffer->pack(maxBins);
+    buffer->pack(zeroBinValue);
+    buffer->pack(numNegInfs);
+    buffer->pack(numPosInfs);
+    buffer->pack(negInfSumWeights);
+    buffer->pack(posInfSumWeights);
+
+    for (const Store *store : {&positiveBins, &negativeBins}) {
+        buffer->pack(store->offset);
+        buffer->pack((int)store->values.size());
+        if (!store->values.empty())
+            buffer->pack(store->values.data(), store->values.size());
+    }
+#endif
+}
+
+void cQuantileSketch::parsimUnpack(cCommBuffer *buffer)
+{
+#ifndef WITH_PARSIM
+    throw cRuntimeError(this, E_NOPARSIM);
+#else
+    cAbstractHistogram::parsimUnpack(buffer);
+
+    buffer->unpack(relativeAccuracy);
+    buffer->unpack(maxBins);
+    buffer->unpack(zeroBinValue);
+    buffer->unpack(numNegInfs);
+    buffer->unpack(numPosInfs);
+    buffer->unpack(negInfSumWeights);
+    buffer->unpack(posInfSumWeights);
+
+    for (Store *store : {&positiveBins, &negativeBins}) {
+        int size;
+        buffer->unpack(store->offset);
+        buffer->unpack(size);
+        store->values.resize(size);
+        if (size != 0)
+            buffer->unpack(store->values.data(), size);
+    }
+
+    gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+    logGamma = std::log(gamma);
+    minIndexableValue = std::numeric_limits<double>::min() * gamma;
+    binsValid = false;
+#endif
+}
+
+int cQuantileSketch::getIndex(double absValue) const
+{
+    // bin k holds the interval [gamma^(k-1), gamma^k)
+    return (int)std::floor(std::log(absValue) / logGamma) + 1;
+}
+
+double cQuantileSketch::getLowerBound(int index) const
+{
+    return std::exp((index - 1) * logGamma);
+}
+
+double cQuantileSketch::getRepresentativeValue(int index) const
+{
+    // the value within the bin whose relative error to both bin edges is alpha
+    return 2 * std::exp(index * logGamma) / (gamma + 1);
+}
+
+void cQuantileSketch::getAttributesToRecord(opp_string_map& attributes)
+{
+    // needed by the analysis tools to merge sketches and compute quantiles;
+    // recorded with full precision, as the bin boundaries are derived from it
+    attributes["relativeAccuracy"] = opp_stringf("%.17g", relativeAccuracy);
+}
+
+void cQuantileSketch::collect(double value)
+{
+    cAbstractHistogram::collect(value);
+    collectIntoBins(value, 1.0);
+}
+
+void cQuantileSketch::collectWeighted(double value, double weight)
+{
+    cAbstractHistogram::collectWeighted(value, weight);
+    collectIntoBins(value, weight);
+}
+
+void cQuantileSketch::collectIntoBins(double value, double weight)
+{
+    binsValid = false;
+    if (std::isinf(value)) {
+        if (value < 0) {
+            numNegInfs++;
+            negInfSumWeights += weight;
+        }
+        else {
+            numPosInfs++;
+            posInfSumWeights += weight;
+        }
+    }
+    else if (std::abs(value) < minIndexableValue)
+        zeroBinValue += weight;
+    else if (value > 0)
+        positiveBins.add(getIndex(value), weight, maxBins);
+    else
+        negativeBins.add(getIndex(-value), weight, maxBins);
+}
+
+void cQuantileSketch::merge(const cStatistic *stat)
+{
+    const cQuantileSketch *other = dynamic_cast<const cQuantileSketch *>(stat);
+    if (other == nullptr)
+        throw cRuntimeError(this, "merge(): Cannot merge (%s)%s, only another cQuantileSketch", stat->getClassName(), stat->getFullPath().c_str());
+    if (other->relativeAccuracy != relativeAccuracy)
+        throw cRuntimeError(this, "merge(): Cannot merge (%s)%s: Relative accuracies differ (%g vs. %g)",
+                other->getClassName(), other->getFullPath().c_str(), relativeAccuracy, other->relativeAccuracy);
+
+    cAbstractHistogram::merge(other);
+
+    positiveBins.merge(other->positiveBins, maxBins);
+    negativeBins.merge(other->negativeBins, maxBins);
+    zeroBinValue += other->zeroBinValue;
+    numNegInfs += other->numNegInfs;
+    numPosInfs += other->numPosInfs;
+    negInfSumWeights += other->negInfSumWeights;
+    posInfSumWeights += other->posInfSumWeights;
+    binsValid = false;
+}
+
+void cQuantileSketch::clear()
+{
+    cAbstractHistogram::clear();
+
+    positiveBins = Store();
+    negativeBins = Store();
+    zeroBinValue = 0;
+    numNegInfs = numPosInfs = 0;
+    negInfSumWeights = posInfSumWeights = 0;
+    binsValid = false;
+}
+
+void cQuantileSketch::updateBins() const
+{
+    if (binsValid)
+        return;
+
+    binEdges.clear();
+    binValues.clear();
+
+    bool hasNegative = !negativeBins.isEmpty();
+    bool hasPositive = !positiveBins.isEmpty();
+    bool hasZero = zeroBinValue != 0 || (hasNegative && hasPositive);
+
+    // negative bins, in decreasing order of magnitude: [-gamma^k, -gamma^(k-1))
+    if (hasNegative) {
+        binEdges.push_back(-getLowerBound(negativeBins.getMaxIndex() + 1));
+        for (int k = negativeBins.getMaxIndex(); k >= negativeBins.getMinIndex(); k--) {
+            binEdges.push_back(-getLowerBound(k));
+            binValues.push_back(negativeBins.values[k - negativeBins.offset]);
+        }
+    }
+
+    // zero bin, stretched to make the bins contiguous
+    if (hasZero) {
+        if (binEdges.empty())
+            binEdges.push_back(-minIndexableValue);
+        binEdges.push_back(hasPositive ? getLowerBound(positiveBins.getMinIndex()) : minIndexableValue);
+        binValues.push_back(zeroBinValue);
+    }
+
+    // positive bins: [gamma^(k-1), gamma^k)
+    if (hasPositive) {
+        if (binEdges.empty())
+            binEdges.push_back(getLowerBound(positiveBins.getMinIndex()));
+        for (int k = positiveBins.getMinIndex(); k <= positiveBins.getMaxIndex(); k++) {
+            binEdges.push_back(getLowerBound(k + 1));
+            binValues.push_back(positiveBins.values[k - positiveBins.offset]);
+        }
+    }
+
+    binsValid = true;
+}
+
+int cQuantileSketch::getNumBins() const
+{
+    updateBins();
+    return binValues.size();
+}
+
+double cQuantileSketch::getBinEdge(int k) const
+{
+    updateBins();
+    if (k < 0 || k >= (int)binEdges.size())
+        throw cRuntimeError(this, "getBinEdge(): Bin index %d out of range", k);
+    return binEdges[k];
+}
+
+double cQuantileSketch::getBinValue(int k) const
+{
+    updateBins();
+    if (k < 0 || k >= (int)binValues.size())
+        throw cRuntimeError(this, "getBinValue(): Bin index %d out of range", k);
+    return binValues[k];
+}
+
+double cQuantileSketch::getQuantile(double q) const
+{
+    if (q < 0 || q > 1)
+        throw cRuntimeError(this, "getQuantile(): Argument must be in the [0,1] interval, %g given", q);
+    if (getCount() == 0)
+        return NAN;
+    if (q == 0)
+        return getMin();
+    if (q == 1)
+        return getMax();
+
+    // list the bins in increasing order of their values
+    updateBins();
+    double totalWeight = negInfSumWeights + posInfSumWeights;
+    for (double value : binValues)
+        totalWeight += value;
+
+    // find the first bin where the cumulative weight exceeds the rank
+    double rank = isWeighted() ? q * totalWeight : q * (totalWeight - 1);
+    double cumWeight = negInfSumWeights;
+    if (cumWeight > rank)
+        return -INFINITY;
+    int numNegativeBins = negativeBins.values.size();
+    bool hasZeroBin = (int)binValues.size() > numNegativeBins + (int)positiveBins.values.size();
+    for (int i = 0; i < (int)binValues.size(); i++) {
+        cumWeight += binValues[i];
+        if (cumWeight > rank) {
+            double result;
+            if (i < numNegativeBins)
+                result = -getRepresentativeValue(negativeBins.getMaxIndex() - i);
+            else if (hasZeroBin && i == numNegativeBins)
+                result = 0;
+            else
+                result = getRepresentativeValue(positiveBins.getMinIndex() + i - numNegativeBins - (hasZeroBin ? 1 : 0));
+
+            // the exact min and max are known, use them to improve the estimate
+            return std::min(std::max(result, getMin()), getMax());
+        }
+    }
+    return posInfSumWeights > 0 ? INFINITY : getMax();
+}
+
+void cQuantileSketch::saveToFile(FILE *f) const
+{
+    cAbstractHistogram::saveToFile(f);
+
+    fprintf(f, "%.17g\t #= relativeaccuracy\n", relativeAccuracy);
+    fprintf(f, "%d\t #= maxbins\n", maxBins);
+    fprintf(f, "%.17g\t #= zerobinvalue\n", zeroBinValue);
+    fprintf(f, "%" PRId64 " %.17g\t #= numneginfs, neginfsumweights\n", numNegInfs, negInfSumWeights);
+    fprintf(f, "%" PRId64 " %.17g\t #= numposinfs, posinfsumweights\n", numPosInfs, posInfSumWeights);
+
+    for (const Store *store : {&positiveBins, &negativeBins}) {
+        fprintf(f, "%d %d\t #= offset, numbins\n", store->offset, (int)store->values.size());
+        for (double value : store->values)
+            fprintf(f, " %.17g\n", value);
+    }
+}
+
+void cQuantileSketch::loadFromFile(FILE *f)
+{
+    cAbstractHistogram::loadFromFile(f);
+
+    freadvarsf(f, "%lg\t #= relativeaccuracy", &relativeAccuracy);
+    freadvarsf(f, "%d\t #= maxbins", &maxBins);
+    freadvarsf(f, "%lg\t #= zerobinvalue", &zeroBinValue);
+    freadvarsf(f, "%" SCNd64 " %lg\t #= numneginfs, neginfsumweights", &numNegInfs, &negInfSumWeights);
+    freadvarsf(f, "%" SCNd64 " %lg\t #= numposinfs, posinfsumweights", &numPosInfs, &posInfSumWeights);
+
+    for (Store *store : {&positiveBins, &negativeBins}) {
+        int size;
+        freadvarsf(f, "%d %d\t #= offset, numbins", &store->offset, &size);
+        store->values.resize(size);
+        for (int i = 0; i < size; i++)
+            freadvarsf(f, " %lg", &store->values[i]);
+    }
+
+    gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+    logGamma = std::log(gamma);
+    minIndexableValue = std::numeric_limits<double>::min() * gamma;
+    binsValid = false;
+}
+
+}  // namespace omnetpp
@@ -21,6 +21,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <algorithm>
 #include <sstream>
 #include "omnetpp/globals.h"
 #include "omnetpp/cqueue.h"
@@ -45,6 +46,35 @@ class FunctionBasedComparator : public cQueue::Comparator
    virtual bool less(cObject *a, cObject *b) override {return f(a,b) < 0;}
 };
 
+void cQueue::Iterator::init(const cQueue& q, bool reverse)
+{
+    this->q = &q;
+    q.mergeHeap();
+    setPosition(reverse ? q.len-1 : 0);
+}
+
+void cQueue::Iterator::setPosition(int pos)
+{
+    this->pos = pos;
+    current = (pos >= 0 && pos < q->len) ? q->elementAt(pos) : nullptr;
+    changeCount = q->changeCount;
+}
+
+void cQueue::Iterator::advance(int delta)
+{
+    if (changeCount != q->changeCount) {
+        // the queue has changed since: look up the current object again
+        q->mergeHeap();
+        int newPos = q->findPosition(current, pos);
+        if (newPos == -1) {
+            // the current object was removed; its successor is now at its former position
+            setPosition(delta > 0 ? pos : pos-1);
+            return;
+        }
+        pos = newPos;
+    }
+    setPosition(pos + delta);
+}
 
 cQueue::cQueue(const cQueue& queue) : cOwnedObject(queue)
 {
@@ -64,21 +94,23 @@ cQueue::~cQueue()
 {
     clear();
     delete comparator;
+    delete[] elems;
 }
 
 std::string cQueue::str() const
 {
-    if (len == 0)
+    if (getLength() == 0)
         return std::string("empty");
     std::stringstream out;
-    out << "length=" << len;
+    out << "length=" << getLength();
     return out.str();
 }
 
 void cQueue::forEachChild(cVisitor *v)
 {
-    for (QElem *p = frontp; p != nullptr; p = p->next)
-        v->visit(p->obj);
+    mergeHeap();
+    for (int i = 0; i < len; i++)
+        v->visit(elementAt(i));
 }
 
 void cQueue::parsimPack(cCommBuffer *buffer) const
@@ -91,7 +123,7 @@ void cQueue::parsimPack(cCommBuffer *buffer) const
     if (comparator)
         throw cRuntimeError(this, "parsimPack(): Cannot transmit comparison function");
 
-    buffer->pack(len);
+    buffer->pack(getLength());
 
     for (cQueue::Iterator it(*this); !it.end(); ++it) {
         cObject *obj = *it;
@@ -109,32 +141,34 @@ void cQueue::parsimUnpack(cCommBuffer *buffer)
 #else
     cOwnedObject::parsimUnpack(buffer);
 
-    buffer->unpack(len);
+    int n;
+    buffer->unpack(n);
 
     Comparator *oldCmp = comparator;
     comparator = nullptr;  // temporarily, so that insert() keeps the original order
-    for (int i = 0; i < len; i++) {
+    for (int i = 0; i < n; i++) {
         cObject *obj = buffer->unpackObject();
         insert(obj);
     }
     comparator = oldCmp;
+    sorted = len <= 1;
 #endif
 }
 
 void cQueue::clear()
 {
-    while (frontp) {
-        QElem *tmp = frontp->next;
-        cObject *obj = frontp->obj;
+    mergeHeap();
+    for (int i = 0; i < len; i++) {
+        cObject *obj = elementAt(i);
         if (!obj->isOwnedObject())
             delete obj;
         else if (obj->getOwner() == this)
             dropAndDelete(static_cast<cOwnedObject *>(obj));
-        delete frontp;
-        frontp = tmp;
     }
-    backp = nullptr;
+    head = 0;
     len = 0;
+    sorted = true;
+    changeCount++;
 }
 
 void cQueue::copy(const cQueue& queue)
@@ -159,6 +193,7 @@ void cQueue::copy(const cQueue& queue)
     takeOwnership = queue.takeOwnership;
     if (queue.comparator)
         comparator = queue.comparator->dup();
+    sorted = queue.sorted;
 }
 
 cQueue& cQueue::operator=(const cQueue& queue)
@@ -173,8 +208,10 @@ cQueue& cQueue::operator=(const cQueue& queue)
 
 void cQueue::setup(Comparator *cmp)
 {
+    mergeHeap();  // with the old comparator
     delete comparator;
     comparator = cmp;
+    sorted = len <= 1;  // existing contents is not re-sorted
 }
 
 void cQueue::setup(CompareFunc cmp)
@@ -182,61 +219,148 @@ void cQueue::setup(CompareFunc cmp)
     setup(cmp ? new FunctionBasedComparator(cmp) : nullptr);
 }
 
-cQueue::QElem *cQueue::find_qelem(cObject *obj) const
+int cQueue::findPosition(cObject *obj, int hint) const
 {
-    QElem *p = frontp;
-    while (p && p->obj != obj)
-        p = p->next;
-    return p;
+    // search outwards from the hint, as the object is usually near it
+    hint = std::min(hint, len-1);
+    for (int d = 0; hint - d >= 0 || hint + d < len; d++) {
+        if (hint - d >= 0 && hint - d < len && elementAt(hint - d) == obj)
+            return hint - d;
+        if (hint + d >= 0 && hint + d < len && elementAt(hint + d) == obj)
+            return hint + d;
+    }
+    return -1;
 }
 
-void cQueue::insbefore_qelem(QElem *p, cObject *obj)
+int cQueue::findInsertPosition(cObject *obj) const
 {
-    QElem *e = new QElem;
-    e->obj = obj;
+    // after the last element that is not greater than obj, so that equal elements stay in FIFO order
+    int pos = len;
+    while (pos > 0 && comparator->less(obj, elementAt(pos-1)))
+        pos--;
+    return pos;
+}
 
-    e->prev = p->prev;
-    e->next = p;
-    p->prev = e;
-    if (e->prev)
-        e->prev->next = e;
-    else
-        frontp = e;
-    len++;
+bool cQueue::heapLess(const HeapEntry& a, const HeapEntry& b) const
+{
+    if (comparator->less(a.obj, b.obj))
+        return true;
+    return !comparator->less(b.obj, a.obj) && a.insertCount < b.insertCount;
 }
 
-void cQueue::insafter_qelem(QElem *p, cObject *obj)
+bool cQueue::heapTopFirst() const
 {
-    QElem *e = new QElem;
-    e->obj = obj;
+    // objects in elems[] were inserted earlier than those in the heap, so they win ties
+    return !heap.empty() && (len == 0 || comparator->less(heap.front().obj, elementAt(0)));
+}
 
-    e->next = p->next;
-    e->prev = p;
-    p->next = e;
-    if (e->next)
-        e->next->prev = e;
-    else
-        backp = e;
-    len++;
+void cQueue::pushHeap(cObject *obj)
+{
+    heap.push_back(HeapEntry{obj, insertCount++});
+    std::push_heap(heap.begin(), heap.end(), [this](const HeapEntry& a, const HeapEntry& b) {return heapLess(b, a);});
+    changeCount++;
 }
 
-cObject *cQueue::remove_qelem(QElem *p)
+cObject *cQueue::popHeap()
 {
-    if (p->next)
-        p->next->prev = p->prev;
-    else
-        backp = p->prev;
-    if (p->prev)
-        p->prev->next = p->next;
-    else
-        frontp = p->next;
+    std::pop_heap(heap.begin(), heap.end(), [this](const HeapEntry& a, const HeapEntry& b) {return heapLess(b, a);});
+    cObject *obj = heap.back().obj;
+    heap.pop_back();
+    changeCount++;
+
+    if (obj->isOwnedObject() && obj->getOwner() == this)
+        drop(static_cast<cOwnedObject *>(obj));
+    return obj;
+}
 
-    cObject *retobj = p->obj;
-    delete p;
+void cQueue::mergeHeap() const
+{
+    if (heap.empty())
+        return;
+
+    // logically a const operation: it only changes the representation
+    cQueue *self = const_cast<cQueue *>(this);
+    std::vector<HeapEntry>& entries = self->heap;
+    std::sort_heap(entries.begin(), entries.end(), [this](const HeapEntry& a, const HeapEntry& b) {return heapLess(b, a);});  // descending order
+
+    int newLen = len + entries.size();
+    int newCapacity = capacity == 0 ? 8 : capacity;
+    while (newCapacity < newLen)
+        newCapacity *= 2;
+    cObject **newElems = new cObject *[newCapacity];
+    int i = 0, k = 0;
+    auto next = entries.rbegin();
+    while (i < len || next != entries.rend()) {
+        if (next != entries.rend() && (i == len || comparator->less(next->obj, elementAt(i))))
+            newElems[k++] = (next++)->obj;
+        else
+            newElems[k++] = elementAt(i++);
+    }
+    delete[] elems;
+    self->elems = newElems;
+    self->capacity = newCapacity;
+    self->head = 0;
+    self->len = newLen;
+    entries.clear();
+    self->changeCount++;
+}
+
+void cQueue::grow()
+{
+    int newCapacity = capacity == 0 ? 8 : 2 * capacity;
+    cObject **newElems = new cObject *[newCapacity];
+    for (int i = 0; i < len; i++)
+        newElems[i] = elementAt(i);
+    delete[] elems;
+    elems = newElems;
+    capacity = newCapacity;
+    head = 0;
+}
+
+void cQueue::insertAt(int pos, cObject *obj)
+{
+    if (len == capacity)
+        grow();
+
+    // make room by shifting the shorter side
+    int mask = capacity - 1;
+    if (pos < len - pos) {
+        head = (head - 1) & mask;
+        for (int i = 0; i < pos; i++)
+            elems[(head + i) & mask] = elems[(head + i + 1) & mask];
+    }
+    else {
+        for (int i = len; i > pos; i--)
+            elems[(head + i) & mask] = elems[(head + i - 1) & mask];
+    }
+    elems[(head + pos) & mask] = obj;
+    len++;
+    changeCount++;
+}
+
+cObject *cQueue::removeAt(int pos)
+{
+    cObject *obj = elementAt(pos);
+
+    // close the gap by shifting the shorter side
+    int mask = capacity - 1;
+    if (pos < len - 1 - pos) {
+        for (int i = pos; i > 0; i--)
+            elems[(head + i) & mask] = elems[(head + i - 1) & mask];
+        head = (head + 1) & mask;
+    }
+    else {
+        for (int i = pos; i < len - 1; i++)
+            elems[(head + i) & mask] = elems[(head + i + 1) & mask];
+    }
     len--;
-    if (retobj->isOwnedObject() && retobj->getOwner() == this)
-        drop(static_cast<cOwnedObject *>(retobj));
-    return retobj;
+    if (len <= 1 && heap.empty())
+        sorted = true;
+    changeCount++;
+
+    if (obj->isOwnedObject() && obj->getOwner() == this)
+        drop(static_cast<cOwnedObject *>(obj));
+    return obj;
 }
 
 void cQueue::insert(cObject *obj)
@@ -247,27 +371,14 @@ void cQueue::insert(cObject *obj)
     if (obj->isOwnedObject() && getTakeOwnership())
         take(static_cast<cOwnedObject *>(obj));
 
-    if (!backp) {
-        // insert as the only item
-        QElem *e = new QElem;
-        e->obj = obj;
-        e->next = e->prev = nullptr;
-        frontp = backp = e;
-        len = 1;
-    }
-    else if (comparator == nullptr) {
-        insafter_qelem(backp, obj);
-    }
-    else {
-        // priority queue: seek insertion place
-        QElem *p = backp;
-        while (p && comparator->less(obj, p->obj))
-            p = p->prev;
-        if (p)
-            insafter_qelem(p, obj);
-        else
-            insbefore_qelem(frontp, obj);
-    }
+    if (comparator == nullptr)
+        insertAt(len, obj);
+    else if (!sorted)
+        insertAt(findInsertPosition(obj), obj);  // priority queue with broken ordering: seek insertion place
+    else if (heap.empty() && (len == 0 || !comparator->less(obj, elementAt(len-1))))
+        insertAt(len, obj);  // belongs to the back
+    else
+        pushHeap(obj);
 }
 
 void cQueue::insertBefore(cObject *where, cObject *obj)
@@ -275,13 +386,15 @@ void cQueue::insertBefore(cObject *where, cObject *obj)
     if (!obj)
         throw cRuntimeError(this, "Cannot insert nullptr");
 
-    QElem *p = find_qelem(where);
-    if (!p)
+    mergeHeap();
+    int pos = findPosition(where);
+    if (pos == -1)
         throw cRuntimeError(this, "insertBefore(w,o): Object w='%s' not in the queue", where->getName());
 
     if (obj->isOwnedObject() && getTakeOwnership())
         take(static_cast<cOwnedObject *>(obj));
-    insbefore_qelem(p, obj);
+    insertAt(pos, obj);
+    sorted = false;
 }
 
 void cQueue::insertAfter(cObject *where, cObject *obj)
@@ -289,59 +402,72 @@ void cQueue::insertAfter(cObject *where, cObject *obj)
     if (!obj)
         throw cRuntimeError(this, "Cannot insert nullptr");
 
-    QElem *p = find_qelem(where);
-    if (!p)
+    mergeHeap();
+    int pos = findPosition(where);
+    if (pos == -1)
         throw cRuntimeError(this, "insertAfter(w,o): Object w='%s' not in the queue", where->getName());
 
     if (obj->isOwnedObject() && getTakeOwnership())
         take(static_cast<cOwnedObject *>(obj));
-    insafter_qelem(p, obj);
+    insertAt(pos+1, obj);
+    sorted = false;
 }
 
 cObject *cQueue::front() const
 {
-    return frontp ? frontp->obj : nullptr;
+    if (heapTopFirst())
+        return heap.front().obj;
+    return len > 0 ? elementAt(0) : nullptr;
 }
 
 cObject *cQueue::back() const
 {
-    return backp ? backp->obj : nullptr;
+    mergeHeap();
+    return len > 0 ? elementAt(len-1) : nullptr;
 }
 
 cObject *cQueue::remove(cObject *obj)
 {
     if (!obj)
         return nullptr;
-    QElem *p = find_qelem(obj);
-    if (!p)
+    mergeHeap();
+    int pos = findPosition(obj);
+    if (pos == -1)
         return nullptr;
-    return remove_qelem(p);
+    return removeAt(pos);
 }
 
 cObject *cQueue::pop()
 {
-    if (!frontp)
+    if (getLength() == 0)
         throw cRuntimeError(this, "pop(): Queue empty");
 
-    return remove_qelem(frontp);
+    if (heapTopFirst())
+        return popHeap();
+    return removeAt(0);
 }
 
 int cQueue::getLength() const
 {
-    return len;
+    return len + heap.size();
 }
 
 bool cQueue::contains(cObject *obj) const
 {
-    return find_qelem(obj) != nullptr;
+    for (const HeapEntry& entry : heap)
+        if (entry.obj == obj)
+            return true;
+    return findPosition(obj) != -1;
 }
 
 cObject *cQueue::get(int i) const
 {
-    QElem *p = frontp;
-    while (p != nullptr && i > 0)
-        p = p->next, i--;
-    return p ? p->obj : nullptr;
+    if (i < 0 || i >= getLength())
+        return nullptr;
+    if (i == 0)
+        return front();
+    mergeHeap();
+    return elementAt(i);
 }
 
 }  // namespace omnetpp
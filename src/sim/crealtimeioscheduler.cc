@@ -0,0 +1,411 @@
+//=========================================================================
+//  CREALTIMEIOSCHEDULER.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include "common/stringutil.h"
+#include "omnetpp/crealtimeioscheduler.h"
+#include "omnetpp/cevent.h"
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cfutureeventset.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/simutil.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace omnetpp {
+
+using namespace omnetpp::common;
+
+Register_PerRunConfigOption(CFGID_REALTIMESCHEDULER_RECORD_LATENESS, "realtimescheduler-record-lateness", CFG_BOOL, "false", "When cRealTimeIoScheduler is selected as scheduler class: whether to record the statistics of event lateness (the difference between the wall clock time an event was processed at and its target wall clock time) as scalars of the network module.");
+
+Register_Class(cRealTimeIoScheduler);
+
+#define IDLE_INTERVAL_NS    100000000  // call getEnvir()->idle() at least this often (100ms)
+
+enum { WAIT_EXPIRED, WAIT_SOURCES, WAIT_INTERRUPTED };
+
+cRealTimeIoScheduler::cRealTimeIoScheduler() : latenessStats("lateness")
+{
+}
+
+cRealTimeIoScheduler::~cRealTimeIoScheduler()
+{
+    endRun();
+}
+
+std::string cRealTimeIoScheduler::str() const
+{
+    std::string result = cRealTimeScheduler::str() + " with I/O sources";
+    if (latenessStats.getCount() > 0)
+        result += opp_stringf(", lateness: mean %.3gs, max %.3gs", latenessStats.getMean(), latenessStats.getMax());
+    return result;
+}
+
+void cRealTimeIoScheduler::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    cRealTimeScheduler::lifecycleEvent(eventType, details);
+    if (eventType == LF_PRE_NETWORK_FINISH && recordLateness)
+        recordLatenessScalars();
+}
+
+void cRealTimeIoScheduler::startRun()
+{
+#ifdef _WIN32
+    throw cRuntimeError("cRealTimeIoScheduler is not supported on Windows, use cRealTimeScheduler instead");
+#else
+    cRealTimeScheduler::startRun();
+    baseTimeNs = opp_get_monotonic_clock_nsecs();
+    recordLateness = getEnvir()->getConfig()->getAsBool(CFGID_REALTIMESCHEDULER_RECORD_LATENESS);
+    latenessStats.clear();
+
+#ifdef __linux__
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);  // same clock as opp_get_monotonic_clock_nsecs()
+    wakeupFd = wakeupWriteFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || timerFd == -1 || wakeupFd == -1)
+        throw cRuntimeError("cRealTimeIoScheduler: Cannot create epoll/timerfd/eventfd: %s", strerror(errno));
+    for (int fd : {timerFd, wakeupFd}) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    // file descriptors added before the run
+    for (const auto& entry : fileDescriptors) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = entry.first;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, entry.first, &ev) == -1)
+            throw cRuntimeError("cRealTimeIoScheduler: Cannot add file descriptor %d: %s", entry.first, strerror(errno));
+    }
+#else
+    int fds[2];
+    if (pipe(fds) == -1)
+        throw cRuntimeError("cRealTimeIoScheduler: Cannot create pipe: %s", strerror(errno));
+    wakeupFd = fds[0];
+    wakeupWriteFd = fds[1];
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+#endif
+}
+
+void cRealTimeIoScheduler::endRun()
+{
+#ifndef _WIN32
+#ifdef __linux__
+    if (epollFd != -1)
+        close(epollFd);
+    if (timerFd != -1)
+        close(timerFd);
+    epollFd = timerFd = -1;
+#endif
+    if (wakeupWriteFd != -1 && wakeupWriteFd != wakeupFd)
+        close(wakeupWriteFd);
+    if (wakeupFd != -1)
+        close(wakeupFd);
+    wakeupFd = wakeupWriteFd = -1;
+#endif
+    fileDescriptors.clear();
+    callbacks.clear();
+    std::lock_guard<std::mutex> lock(pendingCallbacksMutex);
+    pendingCallbacks.clear();
+}
+
+int64_t cRealTimeIoScheduler::toNsecs(simtime_t t) const
+{
+    return doScaling ? (int64_t)(1e9 * factor * t.dbl()) : t.inUnit(SIMTIME_NS);
+}
+
+void cRealTimeIoScheduler::executionResumed()
+{
+    cRealTimeScheduler::executionResumed();
+    baseTimeNs = opp_get_monotonic_clock_nsecs() - toNsecs(sim->getSimTime());
+}
+
+simtime_t cRealTimeIoScheduler::getCurrentRealTimeAsSimTime() const
+{
+    int64_t elapsedNs = opp_get_monotonic_clock_nsecs() - baseTimeNs;
+    simtime_t t = doScaling ? SimTime(elapsedNs / factor / 1e9) : SimTime(elapsedNs, SIMTIME_NS);
+    simtime_t now = sim->getSimTime();
+    return t < now ? now : t;
+}
+
+void cRealTimeIoScheduler::scheduleExternalEvent(cMessage *msg, cModule *targetModule)
+{
+    msg->setArrival(targetModule->getId(), -1, getCurrentRealTimeAsSimTime());
+    sim->getFES()->insert(msg);
+}
+
+void cRealTimeIoScheduler::addFileDescriptor(int fd, FileDescriptorHandler handler)
+{
+    if (fileDescriptors.find(fd) != fileDescriptors.end())
+        throw cRuntimeError("cRealTimeIoScheduler: File descriptor %d is already registered", fd);
+#ifdef __linux__
+    if (epollFd != -1) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == -1)
+            throw cRuntimeError("cRealTimeIoScheduler: Cannot add file descriptor %d: %s", fd, strerror(errno));
+    }
+#endif
+    fileDescriptors[fd] = handler;
+}
+
+void cRealTimeIoScheduler::removeFileDescriptor(int fd)
+{
+    if (fileDescriptors.erase(fd) == 0)
+        return;
+#ifdef __linux__
+    if (epollFd != -1)
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+}
+
+int cRealTimeIoScheduler::addCallback(Callback callback)
+{
+    int id = ++lastCallbackId;
+    callbacks[id] = callback;
+    return id;
+}
+
+void cRealTimeIoScheduler::removeCallback(int id)
+{
+    callbacks.erase(id);
+    std::lock_guard<std::mutex> lock(pendingCallbacksMutex);
+    pendingCallbacks.erase(id);
+}
+
+void cRealTimeIoScheduler::notify(int id)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingCallbacksMutex);
+        pendingCallbacks.insert(id);
+    }
+#ifndef _WIN32
+    if (wakeupWriteFd != -1) {
+        uint64_t one = 1;  // eventfd needs 8 bytes; a pipe accepts anything
+        ssize_t ret = write(wakeupWriteFd, &one, sizeof(one));
+        (void)ret;  // EAGAIN is fine: the scheduler will wake up anyway
+    }
+#endif
+}
+
+void cRealTimeIoScheduler::drainWakeupFd()
+{
+#ifndef _WIN32
+    char buf[64];
+    while (read(wakeupFd, buf, sizeof(buf)) > 0)
+        ;
+#endif
+}
+
+bool cRealTimeIoScheduler::runPendingCallbacks()
+{
+    std::set<int> ids;
+    {
+        std::lock_guard<std::mutex> lock(pendingCallbacksMutex);
+        ids.swap(pendingCallbacks);
+    }
+    bool called = false;
+    for (int id : ids) {
+        auto it = callbacks.find(id);
+        if (it != callbacks.end()) {
+            Callback callback = it->second;  // copy, as the callback may unregister itself
+            callback();
+            called = true;
+        }
+    }
+    return called;
+}
+
+bool cRealTimeIoScheduler::dispatchReadyFileDescriptor(int fd)
+{
+    auto it = fileDescriptors.find(fd);
+    if (it == fileDescriptors.end())
+        return false;  // removed by an earlier handler
+    FileDescriptorHandler handler = it->second;  // copy, as the handler may unregister itself
+    handler(fd);
+    return true;
+}
+
+bool cRealTimeIoScheduler::waitForSources(int64_t deadlineNs)
+{
+#if defined(__linux__)
+    // arm the timer with the absolute deadline; it is on the same clock as opp_get_monotonic_clock_nsecs()
+    int timeoutMs = 0;
+    if (deadlineNs > opp_get_monotonic_clock_nsecs()) {
+        itimerspec its = {};
+        its.it_value.tv_sec = deadlineNs / 1000000000;
+        its.it_value.tv_nsec = deadlineNs % 1000000000;
+        timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &its, nullptr);
+        timeoutMs = -1;
+    }
+
+    const int MAX_EVENTS = 16;
+    epoll_event events[MAX_EVENTS];
+    int n;
+    do {
+        n = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+    } while (n == -1 && errno == EINTR);
+    if (n == -1)
+        throw cRuntimeError("cRealTimeIoScheduler: epoll_wait() failed: %s", strerror(errno));
+
+    bool served = false;
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (fd == timerFd) {
+            uint64_t expirations;
+            ssize_t ret = read(timerFd, &expirations, sizeof(expirations));
+            (void)ret;
+        }
+        else if (fd == wakeupFd)
+            drainWakeupFd();
+        else if (dispatchReadyFileDescriptor(fd))
+            served = true;
+    }
+    if (runPendingCallbacks())
+        served = true;
+    return served;
+#elif !defined(_WIN32)
+    std::vector<pollfd> pollFds;
+    pollFds.push_back({wakeupFd, POLLIN, 0});
+    for (const auto& entry : fileDescriptors)
+        pollFds.push_back({entry.first, POLLIN, 0});
+
+    // poll() has millisecond resolution: sleep away the sub-millisecond remainder
+    int64_t remainingNs = deadlineNs - opp_get_monotonic_clock_nsecs();
+    int timeoutMs = remainingNs <= 0 ? 0 : (int)(remainingNs / 1000000);
+    int n;
+    do {
+        n = poll(pollFds.data(), pollFds.size(), timeoutMs);
+    } while (n == -1 && errno == EINTR);
+    if (n == -1)
+        throw cRuntimeError("cRealTimeIoScheduler: poll() failed: %s", strerror(errno));
+
+    bool served = false;
+    if (n == 0) {
+        remainingNs = deadlineNs - opp_get_monotonic_clock_nsecs();
+        if (remainingNs > 0) {
+            timespec ts = {(time_t)(remainingNs / 1000000000), (long)(remainingNs % 1000000000)};
+            nanosleep(&ts, nullptr);
+        }
+    }
+    else {
+        if (pollFds[0].revents != 0)
+            drainWakeupFd();
+        for (size_t i = 1; i < pollFds.size(); i++)
+            if (pollFds[i].revents != 0 && dispatchReadyFileDescriptor(pollFds[i].fd))
+                served = true;
+    }
+    if (runPendingCallbacks())
+        served = true;
+    return served;
+#else
+    return false;
+#endif
+}
+
+int cRealTimeIoScheduler::waitUntilNs(int64_t targetTimeNs)
+{
+    while (true) {
+        int64_t currentTime = opp_get_monotonic_clock_nsecs();
+        if (targetTimeNs <= currentTime)
+            return WAIT_EXPIRED;
+
+        // wake up at least every 100ms to keep the UI responsive
+        bool idleDue = targetTimeNs - currentTime > IDLE_INTERVAL_NS;
+        int64_t deadline = idleDue ? currentTime + IDLE_INTERVAL_NS : targetTimeNs;
+        if (waitForSources(deadline))
+            return WAIT_SOURCES;
+        if (idleDue && getEnvir()->idle())
+            return WAIT_INTERRUPTED;
+    }
+}
+
+cEvent *cRealTimeIoScheduler::takeNextEvent()
+{
+    while (true) {
+        cEvent *event = sim->getFES()->peekFirst();
+        if (event && event->isStale()) {
+            delete sim->getFES()->removeFirst();
+            continue;
+        }
+
+        int64_t targetTimeNs;
+        if (event)
+            targetTimeNs = baseTimeNs + toNsecs(event->getArrivalTime());
+        else if (!fileDescriptors.empty() || !callbacks.empty())
+            targetTimeNs = INT64_MAX;  // wait for an external event
+        else
+            throw cTerminationException(E_ENDEDOK);
+
+        // wait; event sources may insert events into the FES, so check it again afterwards
+        int status = waitUntilNs(targetTimeNs);
+        if (status == WAIT_INTERRUPTED)
+            return nullptr;
+        if (status == WAIT_SOURCES)
+            continue;
+
+        // serve sources that are already readable, so they cannot be starved by a lagging simulation
+        if (waitForSources(0))
+            continue;
+
+        latenessStats.collect((opp_get_monotonic_clock_nsecs() - targetTimeNs) / 1e9);
+
+        cEvent *tmp = sim->getFES()->removeFirst();
+        ASSERT(tmp == event);
+        return event;
+    }
+}
+
+void cRealTimeIoScheduler::recordLatenessScalars()
+{
+    cModule *network = sim->getSystemModule();
+    if (!network)
+        return;
+    network->recordScalar("realtime:numEvents", latenessStats.getCount());
+    if (latenessStats.getCount() > 0) {
+        network->recordScalar("realtime:lateness:mean", latenessStats.getMean(), "s");
+        network->recordScalar("realtime:lateness:stddev", latenessStats.getStddev(), "s");
+        network->recordScalar("realtime:lateness:max", latenessStats.getMax(), "s");
+    }
+}
+
+}  // namespace omnetpp
+
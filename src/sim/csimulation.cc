@@ -40,6 +40,7 @@
 #include "omnetpp/cexception.h"
 #include "omnetpp/cparimpl.h"
 #include "omnetpp/cfingerprint.h"
+#include "omnetpp/ceventprofiler.h"
 #include "omnetpp/cconfiguration.h"
 #include "omnetpp/ccoroutine.h"
 #include "omnetpp/clifecyclelistener.h"
@@ -108,6 +109,7 @@ cSimulation::cSimulation(const char *name, cEnvir *env) : cNamedObject(name, fal
 
     networkType = nullptr;
     fingerprint = nullptr;
+    profiler = nullptr;
 
     currentSimtime = SIMTIME_ZERO;
     currentEventNumber = 0;
@@ -132,6 +134,7 @@ cSimulation::~cSimulation()
 
     delete envir;
     delete fingerprint;
+    delete profiler;
     delete scheduler;
     dropAndDelete(fes);
 }
@@ -140,6 +143,7 @@ void cSimulation::setActiveSimulation(cSimulation *sim)
 {
     activeSimulation = sim;
     activeEnvir = sim == nullptr ? staticEnvir : sim->envir;
+    cLog::updateEnvirLogLevel();
 }
 
 void cSimulation::setStaticEnvir(cEnvir *env)
@@ -269,6 +273,13 @@ int cSimulation::loadNedSourceFolder(const char *folder, const char *exclusionPa
 #endif
 }
 
+void cSimulation::setNedAstCacheFolder(const char *folder)
+{
+#ifdef WITH_NETBUILDER
+    cNedLoader::getInstance()->setAstCacheFolder(folder);
+#endif
+}
+
 void cSimulation::loadNedFile(const char *nedFilename, const char *expectedPackage, bool isXML)
 {
 #ifdef WITH_NETBUILDER
@@ -416,6 +427,7 @@ void cSimulation::callInitialize()
     currentEventNumber = 0;  // initialize() has event number 0
     trapOnNextEvent = false;
     cMessage::resetMessageCounters();
+    cPacket::resetSharingCounters();
 
     simulationStage = CTX_INITIALIZE;
 
@@ -638,6 +650,9 @@ void cSimulation::executeEvent(cEvent *event)
     if (getFingerprintCalculator() && event->isMessage())
         getFingerprintCalculator()->addEvent(event);
 
+    if (profiler)
+        profiler->beginEvent(event);
+
     try {
         if (!event->isMessage())
             DEBUG_TRAP_IF_REQUESTED;  // ABOUT TO PROCESS THE EVENT YOU REQUESTED TO DEBUG -- SELECT "STEP INTO" IN YOUR DEBUGGER
@@ -650,6 +665,8 @@ void cSimulation::executeEvent(cEvent *event)
     catch (cException&) {
         // restore global context before throwing the exception further
         setGlobalContext();
+        if (profiler)
+            profiler->endEvent();
         throw;
     }
     catch (std::exception& e) {
@@ -657,10 +674,15 @@ void cSimulation::executeEvent(cEvent *event)
         // but wrap into a cRuntimeError which captures the module before that
         cRuntimeError e2("%s: %s", opp_typename(typeid(e)), e.what());
         setGlobalContext();
+        if (profiler)
+            profiler->endEvent();
         throw e2;
     }
     setGlobalContext();
 
+    if (profiler)
+        profiler->endEvent();
+
     // Note: simulation time (as read via simTime() from modules) will be updated
     // in takeNextEvent(), called right before the next executeEvent().
     // Simtime must NOT be updated here, because it would interfere with parallel
@@ -713,6 +735,21 @@ void cSimulation::setFingerprintCalculator(cFingerprintCalculator *f)
     fingerprint = f;
 }
 
+void cSimulation::setEventProfiler(cEventProfiler *p)
+{
+    if (systemModule)
+        throw cRuntimeError(this, "setEventProfiler(): Cannot switch profilers when a network is already set up");
+
+    if (profiler) {
+        getEnvir()->removeLifecycleListener(profiler);
+        delete profiler;
+    }
+
+    profiler = p;
+    if (profiler)
+        getEnvir()->addLifecycleListener(profiler);
+}
+
 void cSimulation::insertEvent(cEvent *event)
 {
     event->setPreviousEventNumber(currentEventNumber);
@@ -0,0 +1,336 @@
+//=========================================================================
+//  CTIMERWHEELEVENTHEAP.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//   Member functions of
+//    cTimerWheelEventHeap : future event set, implemented as a
+//                           hierarchical timer wheel in front of a heap
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstdint>
+#include <cstring>          // memset, memcpy
+#include <algorithm>
+#include "omnetpp/globals.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/cevent.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/ctimerwheeleventheap.h"
+
+namespace omnetpp {
+
+Register_Class(cTimerWheelEventHeap);
+
+// Events in the wheel are marked with heapIndex values below the range used
+// by cEventHeap for the circular buffer. The value encodes the bucket
+// (level*SLOTS_PER_LEVEL+slot, 10 bits) and the position within the bucket.
+#define WHEEL_BASE                 (-(1<<30))
+#define WHEELHEAPINDEX(b, pos)     (WHEEL_BASE - (((pos)<<10) | (b)))
+#define ISWHEELHEAPINDEX(i)        ((i) <= WHEEL_BASE)
+#define BUCKETID(i)                ((WHEEL_BASE-(i)) & 1023)
+#define BUCKETPOS(i)               ((WHEEL_BASE-(i)) >> 10)
+#define MAX_BUCKET_SIZE            (1<<19)
+
+static inline int lowestSetBit(uint64_t x)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(x);
+#else
+    int i = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+static int getDefaultTickShift()
+{
+    // largest power of two of the time resolution that is not longer than 1us
+    int64_t unitsPerMicrosecond = 1;
+    for (int exp = SimTime::getScaleExp(); exp < -6; exp++)
+        unitsPerMicrosecond *= 10;
+    int shift = 0;
+    while (((int64_t)2 << shift) <= unitsPerMicrosecond)
+        shift++;
+    return shift;
+}
+
+cTimerWheelEventHeap::cTimerWheelEventHeap(const char *name, int initialCapacity) : cEventHeap(name, initialCapacity)
+{
+    memset(nonempty, 0, sizeof(nonempty));
+}
+
+cTimerWheelEventHeap::cTimerWheelEventHeap(const cTimerWheelEventHeap& other) : cEventHeap(other)
+{
+    copy(other);
+}
+
+cTimerWheelEventHeap::~cTimerWheelEventHeap()
+{
+    clear();
+}
+
+void cTimerWheelEventHeap::copy(const cTimerWheelEventHeap& other)
+{
+    tickShift = other.tickShift;
+    cursor = other.cursor;
+    wheelLength = other.wheelLength;
+    memcpy(nonempty, other.nonempty, sizeof(nonempty));
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        for (int slot = 0; slot < SLOTS_PER_LEVEL; slot++) {
+            const Bucket& otherBucket = other.buckets[level][slot];
+            Bucket& bucket = buckets[level][slot];
+            bucket.resize(otherBucket.size());
+            for (int pos = 0; pos < (int)bucket.size(); pos++) {
+                take(bucket[pos] = otherBucket[pos]->dup());
+                bucket[pos]->heapIndex = WHEELHEAPINDEX(level*SLOTS_PER_LEVEL+slot, pos);
+            }
+        }
+    }
+}
+
+cTimerWheelEventHeap& cTimerWheelEventHeap::operator=(const cTimerWheelEventHeap& other)
+{
+    if (this == &other)
+        return *this;
+    cEventHeap::operator=(other);  // also clears the wheel
+    copy(other);
+    return *this;
+}
+
+void cTimerWheelEventHeap::setTickShift(int shift)
+{
+    if (!isEmpty())
+        throw cRuntimeError(this, "setTickShift(): Cannot change the tick length while the FES is not empty");
+    if (shift < 0 || shift > 62)
+        throw cRuntimeError(this, "setTickShift(): Invalid value %d", shift);
+    tickShift = shift;
+    cursor = 0;
+}
+
+void cTimerWheelEventHeap::clear()
+{
+    cEventHeap::clear();
+
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        for (int slot = 0; slot < SLOTS_PER_LEVEL; slot++) {
+            Bucket& bucket = buckets[level][slot];
+            for (cEvent *event : bucket)
+                dropAndDelete(event);
+            bucket.clear();
+        }
+    }
+    memset(nonempty, 0, sizeof(nonempty));
+    wheelLength = 0;
+}
+
+int cTimerWheelEventHeap::findNonemptyBucket(int level, int from) const
+{
+    const uint64_t *bitmap = nonempty[level];
+    int word = from >> 6;
+    uint64_t bits = bitmap[word] & (~(uint64_t)0 << (from & 63));
+    while (true) {
+        if (bits != 0)
+            return (word << 6) + lowestSetBit(bits);
+        if (++word == SLOTS_PER_LEVEL/64)
+            return -1;
+        bits = bitmap[word];
+    }
+}
+
+bool cTimerWheelEventHeap::wheelInsert(cEvent *event, int64_t tick)
+{
+    ASSERT(tick >= cursor);
+
+    // the level is determined by the highest tick digit that differs from the cursor
+    int64_t diff = tick ^ cursor;
+    if ((diff >> (NUM_LEVELS*LEVEL_BITS)) != 0)
+        return false;  // too far in the future
+    int level = 0;
+    while ((diff >> ((level+1)*LEVEL_BITS)) != 0)
+        level++;
+    int slot = (tick >> (level*LEVEL_BITS)) & (SLOTS_PER_LEVEL-1);
+
+    Bucket& bucket = buckets[level][slot];
+    if ((int)bucket.size() >= MAX_BUCKET_SIZE)
+        return false;
+    event->heapIndex = WHEELHEAPINDEX(level*SLOTS_PER_LEVEL+slot, (int)bucket.size());
+    bucket.push_back(event);
+    nonempty[level][slot >> 6] |= (uint64_t)1 << (slot & 63);
+    wheelLength++;
+    return true;
+}
+
+void cTimerWheelEventHeap::wheelRemove(cEvent *event)
+{
+    int bucketId = BUCKETID(event->heapIndex);
+    int pos = BUCKETPOS(event->heapIndex);
+    int level = bucketId / SLOTS_PER_LEVEL;
+    int slot = bucketId % SLOTS_PER_LEVEL;
+    Bucket& bucket = buckets[level][slot];
+    ASSERT(bucket[pos] == event);  // sanity check
+
+    // order within the bucket is irrelevant (the heap sorts by insertOrder), so fill the hole with the last one
+    cEvent *last = bucket.back();
+    bucket[pos] = last;
+    last->heapIndex = WHEELHEAPINDEX(bucketId, pos);
+    bucket.pop_back();
+    if (bucket.empty())
+        nonempty[level][slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+    wheelLength--;
+}
+
+void cTimerWheelEventHeap::cascade(int level, int slot)
+{
+    Bucket bucket;
+    bucket.swap(buckets[level][slot]);
+    nonempty[level][slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+    wheelLength -= bucket.size();
+
+    // level 0 buckets hold the events of a single tick: they go into the heap;
+    // others are redistributed to lower levels relative to the new cursor
+    for (cEvent *event : bucket)
+        if (level == 0 || !wheelInsert(event, getTick(event)))
+            heapInsert(event);
+}
+
+void cTimerWheelEventHeap::advance()
+{
+    // find the earliest tick that may contain events
+    int64_t next = INT64_MAX;
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        int shift = level * LEVEL_BITS;
+        int slot = findNonemptyBucket(level, (cursor >> shift) & (SLOTS_PER_LEVEL-1));
+        if (slot != -1) {
+            int64_t start = ((cursor >> (shift+LEVEL_BITS)) << (shift+LEVEL_BITS)) | ((int64_t)slot << shift);
+            next = std::min(next, std::max(start, cursor));
+        }
+    }
+    ASSERT(next != INT64_MAX);
+
+    // if the heap has an earlier event, it is enough to move the cursor past it
+    cEvent *first = cEventHeap::peekFirst();
+    if (first != nullptr) {
+        int64_t firstTick = getTick(first);
+        if (firstTick < next) {
+            cursor = firstTick + 1;
+            return;
+        }
+    }
+
+    // bring down the buckets that contain the tick, and move its events into the heap
+    cursor = next;
+    for (int level = NUM_LEVELS-1; level >= 0; level--) {
+        int slot = (next >> (level*LEVEL_BITS)) & (SLOTS_PER_LEVEL-1);
+        if (!buckets[level][slot].empty())
+            cascade(level, slot);
+    }
+    cursor = next + 1;
+}
+
+void cTimerWheelEventHeap::flushWheel()
+{
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        for (int slot = 0; slot < SLOTS_PER_LEVEL; slot++) {
+            Bucket& bucket = buckets[level][slot];
+            for (cEvent *event : bucket)
+                heapInsert(event);
+            bucket.clear();
+        }
+    }
+    memset(nonempty, 0, sizeof(nonempty));
+    wheelLength = 0;
+}
+
+void cTimerWheelEventHeap::insert(cEvent *event)
+{
+    if (tickShift == -1)
+        tickShift = getDefaultTickShift();
+
+    // events for the current tick, and those that precede the wheel's cursor go to the heap/circular buffer
+    int64_t tick = getTick(event);
+    int64_t nowTick = simTime().raw() >> tickShift;
+    if (tick <= nowTick || tick < cursor) {
+        cEventHeap::insert(event);
+        return;
+    }
+
+    take(event);
+    event->insertOrder = insertCount++;
+    if (!wheelInsert(event, tick))
+        heapInsert(event);
+}
+
+cEvent *cTimerWheelEventHeap::peekFirst() const
+{
+    // make sure the heap contains the first event; this does not change the contents of the FES, only its layout
+    cTimerWheelEventHeap *self = const_cast<cTimerWheelEventHeap *>(this);
+    while (wheelLength > 0) {
+        cEvent *first = cEventHeap::peekFirst();
+        if (first != nullptr && getTick(first) < cursor)
+            break;
+        self->advance();
+    }
+    return cEventHeap::peekFirst();
+}
+
+cEvent *cTimerWheelEventHeap::removeFirst()
+{
+    peekFirst();
+    return cEventHeap::removeFirst();
+}
+
+cEvent *cTimerWheelEventHeap::remove(cEvent *event)
+{
+    if (!ISWHEELHEAPINDEX(event->heapIndex))
+        return cEventHeap::remove(event);
+
+    wheelRemove(event);
+    drop(event);
+    event->heapIndex = -1;
+    return event;
+}
+
+cEvent *cTimerWheelEventHeap::get(int k)
+{
+    if (k < 0)
+        return nullptr;
+
+    // heap and circular buffer first, then the wheel bucket by bucket
+    int heapLength = cEventHeap::getLength();
+    if (k < heapLength)
+        return cEventHeap::get(k);
+    k -= heapLength;
+    if (k >= wheelLength)
+        return nullptr;
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        for (int slot = 0; slot < SLOTS_PER_LEVEL; slot++) {
+            const Bucket& bucket = buckets[level][slot];
+            if (k < (int)bucket.size())
+                return bucket[k];
+            k -= bucket.size();
+        }
+    }
+    return nullptr;
+}
+
+void cTimerWheelEventHeap::sort()
+{
+    flushWheel();
+    cEventHeap::sort();
+}
+
+}  // namespace omnetpp
+
@@ -26,6 +26,11 @@
 #include <list>
 #include <algorithm>
 #include <sstream>
+#include <type_traits>
+#ifdef THREADED
+#include <thread>
+#include <atomic>
+#endif
 #include "common/patternmatcher.h"
 #include "omnetpp/ctopology.h"
 #include "omnetpp/cpar.h"
@@ -63,6 +68,7 @@ cTopology::LinkOut *cTopology::Node::getLinkOut(int i)
 cTopology::cTopology(const char *name) : cOwnedObject(name)
 {
     target = nullptr;
+    structureVersion = 0;
 }
 
 cTopology::cTopology(const cTopology& topo) : cOwnedObject(topo)
@@ -105,6 +111,8 @@ void cTopology::clear()
         delete node;
     }
     nodes.clear();
+    structureVersion++;
+    allPairs = AllPairsShortestPaths();
 }
 
 //---
@@ -204,7 +212,7 @@ void cTopology::extractFromNetwork(bool (*predicate)(cModule *, void *), void *d
         // from or go to modules included in the topology.
         cModule *module = getSimulation()->getModule(node->moduleId);
 
-        for (cModule::GateIterator it(module); !it.end(); ++it) {
+        for (cModule::GateIterator it(module, false); !it.end(); ++it) {
             cGate *gate = *it;
 
             // follow path
@@ -232,10 +240,12 @@ void cTopology::extractFromNetwork(bool (*predicate)(cModule *, void *), void *d
             link->destNode->inLinks.push_back(link);
         }
     }
+    structureVersion++;
 }
 
 int cTopology::addNode(Node *node)
 {
+    structureVersion++;
     if (node->moduleId == -1) {
         // elements without module ID are stored at the end
         nodes.push_back(node);
@@ -271,6 +281,7 @@ void cTopology::deleteNode(Node *node)
     nodes.erase(it);
 
     delete node;
+    structureVersion++;
 }
 
 void cTopology::addLink(Link *link, Node *srcNode, Node *destNode)
@@ -290,6 +301,7 @@ void cTopology::addLink(Link *link, Node *srcNode, Node *destNode)
     link->destNode = destNode;
     srcNode->outLinks.push_back(link);
     destNode->inLinks.push_back(link);
+    structureVersion++;
 }
 
 void cTopology::addLink(Link *link, cGate *srcGate, cGate *destGate)
@@ -313,6 +325,7 @@ void cTopology::addLink(Link *link, cGate *srcGate, cGate *destGate)
     link->destGateId = destGate->getId();
     srcNode->outLinks.push_back(link);
     destNode->inLinks.push_back(link);
+    structureVersion++;
 }
 
 void cTopology::deleteLink(Link *link)
@@ -320,6 +333,7 @@ void cTopology::deleteLink(Link *link)
     unlinkFromSourceNode(link);
     unlinkFromDestNode(link);
     delete link;
+    structureVersion++;
 }
 
 void cTopology::unlinkFromSourceNode(Link *link)
@@ -451,5 +465,532 @@ void cTopology::calculateWeightedSingleShortestPathsTo(Node *_target)
     }
 }
 
+//---
+
+// next-hop table entry of nodes that have no next hop
+template<typename T> static inline T noNextHop() { return (T)~(T)0; }
+
+// memo of LazyDistances; entries are valid if their stamp equals the current one
+struct LazyDistanceMemo {
+    unsigned int stamp = 0;
+    std::vector<double> current;        // distance modified by the update
+    std::vector<unsigned int> currentStamp;
+    std::vector<double> original;       // distance the next-hop row was calculated with
+    std::vector<unsigned int> originalStamp;
+    std::vector<int> path;
+
+    void reset(size_t n) {
+        if (currentStamp.size() != n || ++stamp == 0) {
+            current.assign(n, 0);
+            currentStamp.assign(n, 0);
+            original.assign(n, 0);
+            originalStamp.assign(n, 0);
+            stamp = 1;
+        }
+    }
+};
+
+// distances towards one destination, for the all-pairs algorithms
+struct StoredDistances {
+    double *row;
+    double get(int v) const {return row[v];}
+    void set(int v, double d) {row[v] = d;}
+};
+
+// Distances towards one destination when they are not stored: a node's
+// distance is the one the next-hop row was calculated with until the update
+// sets it. Those original distances are calculated on first use by walking
+// the next hops (the ones not yet changed by the update) towards the
+// destination, adding up the old link costs, and are memoized. Nodes must be
+// set before their next hop is changed.
+template<typename T>
+struct LazyDistances {
+    int dest;
+    const T *nextHop;
+    const int *outStart;
+    const int *edgeDest;
+    const double *transitCost;
+    const double *oldEdgeCost;
+    LazyDistanceMemo& memo;
+
+    double get(int v) {
+        return memo.currentStamp[v] == memo.stamp ? memo.current[v] : getOriginal(v);
+    }
+
+    void set(int v, double d) {
+        if (memo.currentStamp[v] != memo.stamp) {
+            getOriginal(v);  // later walks may pass through v
+            memo.currentStamp[v] = memo.stamp;
+        }
+        memo.current[v] = d;
+    }
+
+    double getOriginal(int v) {
+        // nodes set by the update have their original distance memoized, so
+        // the walk does not go through next hops changed by the update
+        std::vector<int>& path = memo.path;
+        path.clear();
+        int u = v;
+        double d;
+        while (true) {
+            if (memo.originalStamp[u] == memo.stamp) {
+                d = memo.original[u];
+                break;
+            }
+            if (u == dest || nextHop[u] == noNextHop<T>()) {
+                d = u == dest ? 0 : INFINITY;
+                memo.original[u] = d;
+                memo.originalStamp[u] = memo.stamp;
+                break;
+            }
+            path.push_back(u);
+            u = edgeDest[outStart[u] + nextHop[u]];
+        }
+        // add up the costs from the destination backwards, the same way as relaxPathsTo()
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            int e = outStart[*it] + nextHop[*it];
+            int w = edgeDest[e];
+            d = d + (w != dest ? transitCost[w] : 0) + oldEdgeCost[e];
+            memo.original[*it] = d;
+            memo.originalStamp[*it] = memo.stamp;
+        }
+        return d;
+    }
+};
+
+// per-thread working storage of the all-pairs shortest path algorithms
+struct cTopology::AllPairsScratch {
+    std::vector<std::pair<double,int>> heap;  // min-heap of (distance, node index); may contain outdated entries
+    std::vector<char> affected;  // per node
+    std::vector<int> affectedNodes;
+    std::vector<double> distance;  // distances towards the current destination, if they are not stored
+    LazyDistanceMemo lazyDistances;
+};
+
+typedef std::greater<std::pair<double,int>> HeapOrder;
+
+double cTopology::getAllPairsLinkCost(Link *link) const
+{
+    if (!link->enabled)
+        return INFINITY;
+    if (!allPairs.weighted)
+        return 1;
+    if (link->weight < 0)
+        throw cRuntimeError(this, "All-pairs shortest paths: Negative link weight %g", link->weight);
+    return link->weight;
+}
+
+void cTopology::buildAllPairsSnapshot(bool weighted)
+{
+    AllPairsShortestPaths& ap = allPairs;
+    ap = AllPairsShortestPaths();
+    ap.weighted = weighted;
+    ap.structureVersion = structureVersion;
+
+    int n = nodes.size();
+    for (int i = 0; i < n; i++)
+        nodes[i]->index = i;
+
+    // nodes
+    ap.nodeWeight.resize(n);
+    ap.nodeEnabled.resize(n);
+    ap.transitCost.resize(n);
+    for (int i = 0; i < n; i++) {
+        Node *node = nodes[i];
+        if (weighted && node->weight < 0)
+            throw cRuntimeError(this, "All-pairs shortest paths: Negative node weight %g", node->weight);
+        ap.nodeWeight[i] = node->weight;
+        ap.nodeEnabled[i] = node->enabled;
+        ap.transitCost[i] = !node->enabled ? INFINITY : weighted ? node->weight : 0;
+    }
+
+    // out edges, in the order of outLinks[]
+    ap.outStart.resize(n + 1);
+    for (int i = 0; i < n; i++) {
+        ap.outStart[i] = ap.edgeLinks.size();
+        for (Link *link : nodes[i]->outLinks) {
+            ap.edgeLinks.push_back(link);
+            ap.edgeSrc.push_back(i);
+            ap.edgeDest.push_back(link->destNode->index);
+            ap.edgeCost.push_back(getAllPairsLinkCost(link));
+        }
+    }
+    int numEdges = ap.edgeLinks.size();
+    ap.outStart[n] = numEdges;
+
+    // in edges, grouped by destination node (counting sort)
+    ap.inStart.assign(n + 1, 0);
+    for (int e = 0; e < numEdges; e++)
+        ap.inStart[ap.edgeDest[e] + 1]++;
+    for (int i = 0; i < n; i++)
+        ap.inStart[i + 1] += ap.inStart[i];
+    ap.inEdges.resize(numEdges);
+    std::vector<int> fill(ap.inStart.begin(), ap.inStart.end() - 1);
+    for (int e = 0; e < numEdges; e++)
+        ap.inEdges[fill[ap.edgeDest[e]]++] = e;
+}
+
+// below this many link changes, updateAllPairsShortestPaths() runs on the calling thread
+static const size_t MIN_CHANGES_FOR_THREADS = 4;
+
+void cTopology::forEachDestination(const std::function<void(int,AllPairsScratch&)>& f, bool allowThreads)
+{
+    int n = nodes.size();
+#ifdef THREADED
+    int maxThreads = maxAllPairsThreads > 0 ? maxAllPairsThreads : (int)std::thread::hardware_concurrency();
+    int numThreads = std::min(maxThreads, n / 64);  // not worth it for small graphs
+    if (allowThreads && numThreads > 1) {
+        std::atomic<int> next(0);
+        auto worker = [&]() {
+            AllPairsScratch scratch;
+            for (int dest; (dest = next++) < n; )
+                f(dest, scratch);
+        };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++)
+            threads.push_back(std::thread(worker));
+        for (auto& thread : threads)
+            thread.join();
+        return;
+    }
+#endif
+    AllPairsScratch scratch;
+    for (int dest = 0; dest < n; dest++)
+        f(dest, scratch);
+}
+
+template<typename F>
+void cTopology::forEachDestinationRow(const F& f, bool allowThreads)
+{
+    // calls f(dest, nextHopRow, distanceRow, scratch) with the row of the next-hop
+    // table in use, and the stored distances or a per-thread distance row
+    AllPairsShortestPaths& ap = allPairs;
+    size_t n = nodes.size();
+    forEachDestination([&](int dest, AllPairsScratch& scratch) {
+        double *distance;
+        if (ap.distancesStored)
+            distance = &ap.distance[dest * n];
+        else {
+            scratch.distance.resize(n);
+            distance = scratch.distance.data();
+        }
+        if (!ap.nextHop8.empty())
+            f(dest, &ap.nextHop8[dest * n], distance, scratch);
+        else if (!ap.nextHop16.empty())
+            f(dest, &ap.nextHop16[dest * n], distance, scratch);
+        else
+            f(dest, &ap.nextHop32[dest * n], distance, scratch);
+    }, allowThreads);
+}
+
+template<typename T, typename D>
+void cTopology::relaxPathsTo(int dest, T *nextHop, D& distance, AllPairsScratch& scratch)
+{
+    // Dijkstra on the reversed graph, starting from the nodes in the heap;
+    // nodes whose distance decreases are (re)inserted into the heap
+    const AllPairsShortestPaths& ap = allPairs;
+    std::vector<std::pair<double,int>>& heap = scratch.heap;
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), HeapOrder());
+        double dist = heap.back().first;
+        int v = heap.back().second;
+        heap.pop_back();
+        if (dist > distance.get(v))
+            continue;  // outdated entry
+
+        // v is not the destination: add the price of routing through it
+        if (v != dest)
+            dist += ap.transitCost[v];
+        if (dist == INFINITY)
+            continue;
+
+        for (int k = ap.inStart[v]; k < ap.inStart[v + 1]; k++) {
+            int e = ap.inEdges[k];
+            int u = ap.edgeSrc[e];
+            if (!ap.nodeEnabled[u])
+                continue;
+            double newDist = dist + ap.edgeCost[e];
+            if (newDist < distance.get(u)) {
+                distance.set(u, newDist);
+                nextHop[u] = e - ap.outStart[u];
+                heap.push_back(std::make_pair(newDist, u));
+                std::push_heap(heap.begin(), heap.end(), HeapOrder());
+            }
+        }
+    }
+}
+
+template<typename T>
+void cTopology::calculatePathsTo(int dest, T *nextHop, double *distance, AllPairsScratch& scratch)
+{
+    size_t n = nodes.size();
+    std::fill(nextHop, nextHop + n, noNextHop<T>());
+    std::fill(distance, distance + n, INFINITY);
+    distance[dest] = 0;
+    scratch.heap.clear();
+    scratch.heap.push_back(std::make_pair(0.0, dest));
+    StoredDistances distances {distance};
+    relaxPathsTo(dest, nextHop, distances, scratch);
+}
+
+template<typename T>
+double cTopology::getPathDistance(int src, int dest, const T *nextHop) const
+{
+    // collect the edges of the path, then add up their costs from the
+    // destination backwards, in the same order as relaxPathsTo() does
+    const AllPairsShortestPaths& ap = allPairs;
+    std::vector<int> path;
+    for (int u = src; u != dest; ) {
+        if (nextHop[u] == noNextHop<T>())
+            return INFINITY;
+        int e = ap.outStart[u] + nextHop[u];
+        path.push_back(e);
+        u = ap.edgeDest[e];
+    }
+    double distance = 0;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        int v = ap.edgeDest[*it];
+        distance = distance + (v != dest ? ap.transitCost[v] : 0) + ap.edgeCost[*it];
+    }
+    return distance;
+}
+
+template<typename T, typename D>
+void cTopology::updatePathsTo(int dest, T *nextHop, D& distance, const std::vector<AllPairsChange>& changes, AllPairsScratch& scratch)
+{
+    // Incremental update of the shortest-path tree towards dest (edge costs
+    // in the snapshot already contain the new values). Nodes whose path uses
+    // a link whose cost increased lose their distance, and get re-attached to
+    // the rest of the tree; then the improvements due to decreased link costs
+    // are propagated. Parts of the tree not affected are left alone.
+    const AllPairsShortestPaths& ap = allPairs;
+    size_t n = nodes.size();
+    std::vector<char>& affected = scratch.affected;
+    std::vector<int>& affectedNodes = scratch.affectedNodes;
+    std::vector<std::pair<double,int>>& heap = scratch.heap;
+    affected.resize(n);
+    affectedNodes.clear();
+    heap.clear();
+
+    // collect the subtrees hanging on tree links whose cost increased
+    for (const AllPairsChange& change : changes) {
+        int u = ap.edgeSrc[change.edge];
+        if (!change.increased || affected[u] || nextHop[u] != (T)(change.edge - ap.outStart[u]))
+            continue;
+        size_t start = affectedNodes.size();
+        affected[u] = true;
+        affectedNodes.push_back(u);
+        for (size_t i = start; i < affectedNodes.size(); i++) {
+            int v = affectedNodes[i];
+            for (int k = ap.inStart[v]; k < ap.inStart[v + 1]; k++) {
+                int e = ap.inEdges[k];
+                int w = ap.edgeSrc[e];
+                if (!affected[w] && nextHop[w] == (T)(e - ap.outStart[w])) {
+                    affected[w] = true;
+                    affectedNodes.push_back(w);
+                }
+            }
+        }
+    }
+    for (int v : affectedNodes) {
+        distance.set(v, INFINITY);
+        nextHop[v] = noNextHop<T>();
+    }
+
+    // re-attach affected nodes via their links to unaffected nodes
+    for (int u : affectedNodes) {
+        for (int e = ap.outStart[u]; e < ap.outStart[u + 1]; e++) {
+            int v = ap.edgeDest[e];
+            double distV = affected[v] ? INFINITY : distance.get(v);
+            if (distV == INFINITY)
+                continue;
+            double newDist = distV + (v != dest ? ap.transitCost[v] : 0) + ap.edgeCost[e];
+            if (newDist < distance.get(u)) {
+                distance.set(u, newDist);
+                nextHop[u] = e - ap.outStart[u];
+            }
+        }
+        if (distance.get(u) != INFINITY)
+            heap.push_back(std::make_pair(distance.get(u), u));
+    }
+    for (int v : affectedNodes)
+        affected[v] = false;
+
+    // links whose cost decreased may offer shorter paths
+    for (const AllPairsChange& change : changes) {
+        if (change.increased)
+            continue;
+        int e = change.edge;
+        int u = ap.edgeSrc[e], v = ap.edgeDest[e];
+        double distV = ap.nodeEnabled[u] ? distance.get(v) : INFINITY;
+        if (distV == INFINITY)
+            continue;
+        double newDist = distV + (v != dest ? ap.transitCost[v] : 0) + ap.edgeCost[e];
+        if (newDist < distance.get(u)) {
+            distance.set(u, newDist);
+            nextHop[u] = e - ap.outStart[u];
+            heap.push_back(std::make_pair(newDist, u));
+        }
+    }
+
+    std::make_heap(heap.begin(), heap.end(), HeapOrder());
+    relaxPathsTo(dest, nextHop, distance, scratch);
+}
+
+void cTopology::calculateAllPairsShortestPaths(bool weighted)
+{
+    buildAllPairsSnapshot(weighted);
+    AllPairsShortestPaths& ap = allPairs;
+    size_t n = nodes.size();
+
+    // the narrowest next-hop table whose entries can hold any outLinks[] index and "none"
+    size_t maxOutDegree = 0;
+    for (Node *node : nodes)
+        maxOutDegree = std::max(maxOutDegree, node->outLinks.size());
+    if (maxOutDegree < noNextHop<uint8_t>())
+        ap.nextHop8.resize(n * n);
+    else if (maxOutDegree < noNextHop<uint16_t>())
+        ap.nextHop16.resize(n * n);
+    else
+        ap.nextHop32.resize(n * n);
+    ap.distancesStored = storeAllPairsDistances;
+    if (ap.distancesStored)
+        ap.distance.resize(n * n);
+
+    forEachDestinationRow([this](int dest, auto *nextHop, double *distance, AllPairsScratch& scratch) {
+        calculatePathsTo(dest, nextHop, distance, scratch);
+    });
+    ap.valid = true;
+}
+
+void cTopology::calculateUnweightedAllPairsShortestPaths()
+{
+    calculateAllPairsShortestPaths(false);
+}
+
+void cTopology::calculateWeightedAllPairsShortestPaths()
+{
+    calculateAllPairsShortestPaths(true);
+}
+
+void cTopology::updateAllPairsShortestPaths()
+{
+    AllPairsShortestPaths& ap = allPairs;
+    if (!ap.valid)
+        throw cRuntimeError(this, "updateAllPairsShortestPaths(): No all-pairs shortest paths calculated yet");
+
+    // structural or node changes require a full recalculation
+    bool recalculate = ap.structureVersion != structureVersion;
+    for (int i = 0; !recalculate && i < (int)nodes.size(); i++)
+        if (nodes[i]->enabled != (bool)ap.nodeEnabled[i] || (ap.weighted && nodes[i]->weight != ap.nodeWeight[i]))
+            recalculate = true;
+    if (recalculate) {
+        if (ap.weighted)
+            calculateWeightedAllPairsShortestPaths();
+        else
+            calculateUnweightedAllPairsShortestPaths();
+        return;
+    }
+
+    // collect changed links, and update their costs in the snapshot; without
+    // stored distances, the old costs are needed to calculate the distances
+    std::vector<double> oldEdgeCost;
+    if (!ap.distancesStored)
+        oldEdgeCost = ap.edgeCost;
+    std::vector<AllPairsChange> changes;
+    for (int e = 0; e < (int)ap.edgeLinks.size(); e++) {
+        double cost = getAllPairsLinkCost(ap.edgeLinks[e]);
+        if (cost != ap.edgeCost[e]) {
+            changes.push_back(AllPairsChange {e, cost > ap.edgeCost[e]});
+            ap.edgeCost[e] = cost;
+        }
+    }
+    if (changes.empty())
+        return;
+
+    // an update after a few changes only touches small parts of the trees,
+    // and takes less time than starting the threads
+    bool allowThreads = changes.size() >= MIN_CHANGES_FOR_THREADS;
+    forEachDestinationRow([this,&changes,&oldEdgeCost](int dest, auto *nextHop, double *distance, AllPairsScratch& scratch) {
+        const AllPairsShortestPaths& ap = allPairs;
+        if (ap.distancesStored) {
+            StoredDistances distances {distance};
+            updatePathsTo(dest, nextHop, distances, changes, scratch);
+        }
+        else {
+            LazyDistanceMemo& memo = scratch.lazyDistances;
+            memo.reset(nodes.size());
+            LazyDistances<std::remove_pointer_t<decltype(nextHop)>> distances {dest, nextHop, ap.outStart.data(), ap.edgeDest.data(), ap.transitCost.data(), oldEdgeCost.data(), memo};
+            updatePathsTo(dest, nextHop, distances, changes, scratch);
+        }
+    }, allowThreads);
+}
+
+void cTopology::setMaxAllPairsThreads(int n)
+{
+    if (n < 0)
+        throw cRuntimeError(this, "setMaxAllPairsThreads(): Negative number of threads");
+    maxAllPairsThreads = n;
+}
+
+bool cTopology::hasAllPairsShortestPaths() const
+{
+    return allPairs.valid && allPairs.structureVersion == structureVersion;
+}
+
+int cTopology::checkAllPairsNode(Node *node, const char *method) const
+{
+    if (!hasAllPairsShortestPaths())
+        throw cRuntimeError(this, "%s: No up-to-date all-pairs shortest paths, call calculate...AllPairsShortestPaths() first", method);
+    if (!node)
+        throw cRuntimeError(this, "%s: Node is nullptr", method);
+    if (node->index < 0 || node->index >= (int)nodes.size() || nodes[node->index] != node)
+        throw cRuntimeError(this, "%s: Node is not part of this graph", method);
+    return node->index;
+}
+
+int cTopology::getAllPairsNextHop(int src, int dest) const
+{
+    const AllPairsShortestPaths& ap = allPairs;
+    size_t k = (size_t)dest * nodes.size() + src;
+    if (!ap.nextHop8.empty())
+        return ap.nextHop8[k] == noNextHop<uint8_t>() ? -1 : ap.nextHop8[k];
+    else if (!ap.nextHop16.empty())
+        return ap.nextHop16[k] == noNextHop<uint16_t>() ? -1 : ap.nextHop16[k];
+    else
+        return ap.nextHop32[k] == noNextHop<uint32_t>() ? -1 : (int)ap.nextHop32[k];
+}
+
+double cTopology::getDistance(Node *srcNode, Node *destNode) const
+{
+    int src = checkAllPairsNode(srcNode, "getDistance()");
+    int dest = checkAllPairsNode(destNode, "getDistance()");
+    const AllPairsShortestPaths& ap = allPairs;
+    size_t row = (size_t)dest * nodes.size();
+    if (ap.distancesStored)
+        return ap.distance[row + src];
+
+    if (!ap.nextHop8.empty())
+        return getPathDistance(src, dest, &ap.nextHop8[row]);
+    else if (!ap.nextHop16.empty())
+        return getPathDistance(src, dest, &ap.nextHop16[row]);
+    else
+        return getPathDistance(src, dest, &ap.nextHop32[row]);
+}
+
+int cTopology::getNextHopIndex(Node *srcNode, Node *destNode) const
+{
+    int src = checkAllPairsNode(srcNode, "getNextHopIndex()");
+    int dest = checkAllPairsNode(destNode, "getNextHopIndex()");
+    return getAllPairsNextHop(src, dest);
+}
+
+cTopology::LinkOut *cTopology::getNextHop(Node *srcNode, Node *destNode) const
+{
+    int k = getNextHopIndex(srcNode, destNode);
+    return k == -1 ? nullptr : (LinkOut *)srcNode->outLinks[k];
+}
+
 }  // namespace omnetpp
 
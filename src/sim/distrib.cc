@@ -414,5 +414,43 @@ int poisson(cRNG *rng, double lambda)
     return X;
 }
 
+//----------------------------------------------------------------------------
+//
+//  B U L K
+//
+//----------------------------------------------------------------------------
+
+void uniform(cRNG *rng, double a, double b, double *dest, int n)
+{
+    rng->fillDoubles(dest, n);
+    for (int i = 0; i < n; i++)
+        dest[i] = a + dest[i] * (b-a);
+}
+
+void exponential(cRNG *rng, double p, double *dest, int n)
+{
+    rng->fillDoubles(dest, n);
+    for (int i = 0; i < n; i++)
+        dest[i] = -p *log(1.0 - dest[i]);
+}
+
+void normal(cRNG *rng, double m, double d, double *dest, int n)
+{
+    // every variate consumes two uniform numbers (U, V), in this order
+    const int CHUNK = 256;
+    double uv[2*CHUNK];
+    while (n > 0) {
+        int count = n < CHUNK ? n : CHUNK;
+        rng->fillDoubles(uv, 2*count);
+        for (int i = 0; i < count; i++) {
+            double U = 1.0 - uv[2*i];
+            double V = 1.0 - uv[2*i+1];
+            dest[i] = m + d * sqrt(-2.0*log(U)) * cos(M_PI*2*V);
+        }
+        dest += count;
+        n -= count;
+    }
+}
+
 }  // namespace omnetpp
 
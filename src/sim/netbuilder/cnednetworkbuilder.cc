@@ -1070,9 +1070,7 @@ void cNedNetworkBuilder::resolveInoutGate(cModule *compoundModule,
 
     outGate1 = outGate2 = nullptr;
     if (gateIndexExpr.empty() && !isPlusPlus) {
-        // optimization possibility: add gatePair() method to cModule to spare one lookup
-        outGate1 = module->gateHalf(gateName, cGate::INPUT);
-        outGate2 = module->gateHalf(gateName, cGate::OUTPUT);
+        module->gatePair(gateName, -1, outGate1, outGate2);
     }
     else if (isPlusPlus) {
         if (module == compoundModule) {
@@ -1086,10 +1084,8 @@ void cNedNetworkBuilder::resolveInoutGate(cModule *compoundModule,
         }
     }
     else {  // (gateIndexExpr)
-        // optimization possibility: add gatePair() method to cModule to spare one lookup
         int gateIndex = (int)evaluateAsLong(gateIndexExpr, compoundModule, false);
-        outGate1 = module->gateHalf(gateName, cGate::INPUT, gateIndex);
-        outGate2 = module->gateHalf(gateName, cGate::OUTPUT, gateIndex);
+        module->gatePair(gateName, gateIndex, outGate1, outGate2);
     }
 
     if (module == compoundModule) {
@@ -69,7 +69,7 @@ void cAdvancedLinkDelayLookahead::startRun()
     for (int modId = 0; modId <= sim->getLastComponentId(); modId++) {
         cPlaceholderModule *mod = dynamic_cast<cPlaceholderModule *>(sim->getModule(modId));
         if (mod) {
-            for (cModule::GateIterator i(mod); !i.end(); i++) {
+            for (cModule::GateIterator i(mod, false); !i.end(); i++) {
                 cGate *g = i();
                 cProxyGate *pg = dynamic_cast<cProxyGate *>(g);
                 if (pg && pg->getPreviousGate() && pg->getRemoteProcId() >= 0)
@@ -90,7 +90,7 @@ void cAdvancedLinkDelayLookahead::startRun()
     for (int modId = 0; modId <= sim->getLastComponentId(); modId++) {
         cPlaceholderModule *mod = dynamic_cast<cPlaceholderModule *>(sim->getModule(modId));
         if (mod) {
-            for (cModule::GateIterator i(mod); !i.end(); i++) {
+            for (cModule::GateIterator i(mod, false); !i.end(); i++) {
                 // if this is a properly connected proxygate, process it
                 // FIXME leave out gates from other cPlaceholderModules
                 cGate *g = i();
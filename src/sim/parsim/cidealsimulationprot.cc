@@ -84,6 +84,10 @@ void cIdealSimulationProtocol::processReceivedMessage(cMessage *msg, const SendO
 
 cEvent *cIdealSimulationProtocol::takeNextEvent()
 {
+    // there are no null messages to send batches with, and other partitions
+    // may need the messages of the previous event before we block
+    flushAllBatches();
+
     // if no more local events, wait for something to come from other partitions
     while (sim->getFES()->isEmpty())
         if (!receiveBlocking())
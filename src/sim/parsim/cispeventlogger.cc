@@ -74,6 +74,10 @@ void cISPEventLogger::processOutgoingMessage(cMessage *msg, const SendOptions& o
 
 cEvent *cISPEventLogger::takeNextEvent()
 {
+    // send out the messages of each event, like cIdealSimulationProtocol
+    // does when replaying the log
+    flushAllBatches();
+
     cEvent *event = cNullMessageProtocol::takeNextEvent();
 
     if (event->getSrcProcId() != -1) {  // received from another partition
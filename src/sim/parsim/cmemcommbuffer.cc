@@ -437,5 +437,20 @@ void cMemCommBuffer::unpack(SimTime *d, int size)
         unpack(d[i]);
 }
 
+// --------------------------------
+
+void cMemCommBuffer::packBytes(const void *d, int size)
+{
+    extendBufferFor(size);
+    memcpy(mBuffer+mMsgSize, d, size);
+    mMsgSize += size;
+}
+
+void cMemCommBuffer::unpackBytes(void *d, int size)
+{
+    memcpy(d, mBuffer+mPosition, size);
+    mPosition += size;
+}
+
 }  // namespace omnetpp
 
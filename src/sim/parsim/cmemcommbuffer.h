@@ -128,6 +128,12 @@ class SIM_API cMemCommBuffer : public cCommBufferBase
     virtual void unpack(opp_string *d, int size) override;
     virtual void unpack(SimTime *d, int size) override;
     //@}
+
+    /** @name Pack and unpack raw memory blocks */
+    //@{
+    virtual void packBytes(const void *d, int size) override;
+    virtual void unpackBytes(void *d, int size) override;
+    //@}
 };
 
 }  // namespace omnetpp
@@ -492,6 +492,21 @@ void cMPICommBuffer::unpack(SimTime *d, int size)
         unpack(d[i]);
 }
 
+//--------------------------------
+
+void cMPICommBuffer::packBytes(const void *d, int size)
+{
+    extendBufferFor(size);
+    if (MPI_Pack((void *)d, size, MPI_BYTE, mBuffer, mBufferSize, &mMsgSize, MPI_COMM_WORLD))
+        throw cRuntimeError("cMPICommBuffer::packBytes(): MPI_Pack() returned error");
+}
+
+void cMPICommBuffer::unpackBytes(void *d, int size)
+{
+    if (MPI_Unpack(mBuffer, mMsgSize, &mPosition, d, size, MPI_BYTE, MPI_COMM_WORLD))
+        throw cRuntimeError("cMPICommBuffer::unpackBytes(): MPI_Unpack() returned error");
+}
+
 }  // namespace omnetpp
 
 #endif  // WITH_MPI
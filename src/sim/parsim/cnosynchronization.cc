@@ -53,6 +53,10 @@ void cNoSynchronization::endRun()
 
 cEvent *cNoSynchronization::takeNextEvent()
 {
+    // without synchronization, nothing else would send out the batches
+    // until the partition blocks, so send the messages of each event
+    flushAllBatches();
+
     // if no more local events, wait for something to come from other partitions
     if (sim->getFES()->isEmpty()) {
         EV << "no local events, waiting for something to arrive from other partitions\n";
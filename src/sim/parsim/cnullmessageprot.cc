@@ -91,6 +91,7 @@ void cNullMessageProtocol::startRun()
         segInfo[i].eotEvent = nullptr;
         segInfo[i].eitEvent = nullptr;
         segInfo[i].lastEotSent = 0.0;
+        segInfo[i].eotPending = false;
     }
 
     // Note boot sequence: first we have to schedule all "resend-EOT" events,
@@ -142,6 +143,19 @@ void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, const SendOptio
     // send a null message only if EOT is better than last time
     bool sendNull = (eot > segInfo[destProcId].lastEotSent);
 
+    if (batching) {
+        // the message goes into the batch, and the EOT will be piggybacked on the batch when it is sent
+        if (sendNull) {
+            segInfo[destProcId].lastEotSent = eot;
+            segInfo[destProcId].eotPending = true;
+            simtime_t eotResendTime = sim->getSimTime() + lookahead*laziness;
+            rescheduleEvent(segInfo[destProcId].eotEvent, eotResendTime);
+        }
+        {if (debug) EV << "batching '" << msg->getName() << "' to " << destProcId << (sendNull ? ", EOT=" : "") << (sendNull ? eot.str() : "") << "\n";}
+        addToBatch(msg, options, destProcId, destModuleId, destGateId);
+        return;
+    }
+
     // send message
     cCommBuffer *buffer = comm->createCommBuffer();
     if (sendNull) {
@@ -207,6 +221,18 @@ void cNullMessageProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, i
             break;
         }
 
+        case TAG_CMESSAGE_BATCH: {
+            processReceivedBatch(buffer, sourceProcId);
+            break;
+        }
+
+        case TAG_CMESSAGE_BATCH_WITH_NULLMESSAGE: {
+            processReceivedBatch(buffer, sourceProcId);
+            buffer->unpack(eit);
+            processReceivedEIT(sourceProcId, eit);
+            break;
+        }
+
         default: {
             partition->processReceivedBuffer(buffer, tag, sourceProcId);
             break;
@@ -278,6 +304,9 @@ void cNullMessageProtocol::putBackEvent(cEvent *event)
 
 void cNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
 {
+    // messages sent earlier must arrive before the new EOT
+    flushBatch(procId);
+
     // calculate EOT and sending of next null message
     simtime_t lookahead = lookaheadcalc->getCurrentLookahead(procId);
     simtime_t eot = now + lookahead;
@@ -303,6 +332,19 @@ void cNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
     comm->recycleCommBuffer(buffer);
 }
 
+void cNullMessageProtocol::sendBatch(cCommBuffer *buffer, int destProcId)
+{
+    if (!segInfo[destProcId].eotPending) {
+        cParsimProtocolBase::sendBatch(buffer, destProcId);
+        return;
+    }
+
+    // the batch contains all messages sent since the EOT was promised, so it can carry the EOT
+    segInfo[destProcId].eotPending = false;
+    buffer->pack(segInfo[destProcId].lastEotSent);
+    comm->send(buffer, TAG_CMESSAGE_BATCH_WITH_NULLMESSAGE, destProcId);
+}
+
 void cNullMessageProtocol::rescheduleEvent(cMessage *msg, simtime_t t)
 {
     sim->getFES()->remove(msg);  // also works if the event is not currently scheduled
@@ -45,6 +45,7 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
         cMessage *eitEvent;  // EIT received from partition
         cMessage *eotEvent;  // events which marks that a null message should be sent out
         simtime_t lastEotSent; // last EOT value that was sent
+        bool eotPending;       // lastEotSent is to be piggybacked on the outgoing batch (with message batching)
     };
 
     // partition information
@@ -75,6 +76,9 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
     // resend null message to this partition
     virtual void sendNullMessage(int procId, simtime_t now);
 
+    // piggybacks the pending EOT on the batch
+    virtual void sendBatch(cCommBuffer *buffer, int destProcId) override;
+
     // reschedule event in FES, to the given time
     virtual void rescheduleEvent(cMessage *msg, simtime_t t);
 
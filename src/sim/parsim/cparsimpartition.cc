@@ -104,7 +104,7 @@ void cParsimPartition::connectRemoteGates()
     for (int modId = 0; modId <= sim->getLastComponentId(); modId++) {
         cModule *mod = sim->getModule(modId);
         if (mod && !mod->isPlaceholder()) {
-            for (cModule::GateIterator it(mod); !it.end(); ++it) {
+            for (cModule::GateIterator it(mod, false); !it.end(); ++it) {
                 cGate *g = *it;
                 if (g->getType() == cGate::INPUT) {
                     // if gate is connected to a placeholder module, in another partition that will
@@ -189,7 +189,7 @@ void cParsimPartition::connectRemoteGates()
     for (int modId = 0; modId <= sim->getLastComponentId(); modId++) {
         cModule *mod = sim->getModule(modId);
         if (mod && mod->isPlaceholder()) {
-            for (cModule::GateIterator it(mod); !it.end(); ++it) {
+            for (cModule::GateIterator it(mod, false); !it.end(); ++it) {
                 cProxyGate *pg = dynamic_cast<cProxyGate *>(*it);
                 if (pg && pg->getRemoteProcId() == -1 && !pg->getPathStartGate()->getOwnerModule()->isPlaceholder())
                     throw cRuntimeError("Parallel simulation error: Dangling proxy gate '%s' "
@@ -264,6 +264,8 @@ void cParsimPartition::broadcastTerminationException(cTerminationException& e)
     cCommBuffer *buffer = comm->createCommBuffer();
     buffer->pack(e.what());
     try {
+        // messages held back by the synchronizer must arrive before the termination
+        synch->flushOutgoingMessages();
         comm->broadcast(buffer, TAG_TERMINATIONEXCEPTION);
     }
     catch (std::exception&) {
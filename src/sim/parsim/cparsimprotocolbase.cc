@@ -22,21 +22,41 @@
 #include "omnetpp/cmodule.h"
 #include "omnetpp/cgate.h"
 #include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/regmacros.h"
 #include "omnetpp/cparsimcomm.h"
 #include "omnetpp/ccommbuffer.h"
 #include "omnetpp/csimplemodule.h" // SendOptions
 #include "cparsimpartition.h"
 #include "messagetags.h"
 #include "cparsimprotocolbase.h"
+#include "ccommbufferbase.h"
 
 namespace omnetpp {
 
+Register_GlobalConfigOption(CFGID_PARSIM_MESSAGE_BATCHING, "parsim-message-batching", CFG_BOOL, "false", "With `parallel-simulation=true`: whether to collect messages sent to other partitions into per-partition batches, instead of sending each message separately. A batch is sent when it reaches `parsim-message-batching-max-size`, before a null message is sent to the same partition, before the partition blocks waiting for messages from other partitions, and before the termination of the simulation is announced to other partitions. Synchronization protocols without null messages (`cNoSynchronization`, `cIdealSimulationProtocol`, `cISPEventLogger`) send the batches after each event.");
+Register_GlobalConfigOptionU(CFGID_PARSIM_MESSAGE_BATCHING_MAX_SIZE, "parsim-message-batching-max-size", "B", "64KiB", "When `parsim-message-batching=true`: the size at which a batch of messages is sent out.");
+
 cParsimProtocolBase::cParsimProtocolBase() : cParsimSynchronizer()
 {
+    batching = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_MESSAGE_BATCHING);
+    maxBatchBytes = (int)getEnvir()->getConfig()->getAsDouble(CFGID_PARSIM_MESSAGE_BATCHING_MAX_SIZE);
 }
 
 cParsimProtocolBase::~cParsimProtocolBase()
 {
+    for (OutgoingBatch& batch : outgoingBatches)
+        delete batch.buffer;
+}
+
+void cParsimProtocolBase::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    cParsimSynchronizer::lifecycleEvent(eventType, details);
+    if (eventType == LF_PRE_NETWORK_FINISH && batching)
+        recordBatchingScalars();
+    if (eventType == LF_ON_RUN_END)
+        finishBatching();
 }
 
 SendOptions cParsimProtocolBase::unpackOptions(cCommBuffer *buffer)
@@ -61,6 +81,11 @@ void cParsimProtocolBase::packOptions(cCommBuffer *buffer, const SendOptions& op
 
 void cParsimProtocolBase::processOutgoingMessage(cMessage *msg, const SendOptions& options, int destProcId, int destModuleId, int destGateId, void *)
 {
+    if (batching) {
+        addToBatch(msg, options, destProcId, destModuleId, destGateId);
+        return;
+    }
+
     cCommBuffer *buffer = comm->createCommBuffer();
 
     buffer->pack(destModuleId);
@@ -72,6 +97,110 @@ void cParsimProtocolBase::processOutgoingMessage(cMessage *msg, const SendOption
     comm->recycleCommBuffer(buffer);
 }
 
+void cParsimProtocolBase::addToBatch(cMessage *msg, const SendOptions& options, int destProcId, int destModuleId, int destGateId)
+{
+    if (outgoingBatches.empty())
+        outgoingBatches.resize(comm->getNumPartitions());
+    OutgoingBatch& batch = outgoingBatches[destProcId];
+    if (!batch.buffer)
+        batch.buffer = comm->createCommBuffer();
+
+    // every message is preceded by a "true" marker; the batch is terminated by "false"
+    cCommBuffer *buffer = batch.buffer;
+    buffer->pack(true);
+    buffer->pack(destModuleId);
+    buffer->pack(destGateId);
+    packOptions(buffer, options);
+    buffer->packObject(msg);
+    batch.numMessages++;
+
+    cCommBufferBase *bufferBase = dynamic_cast<cCommBufferBase *>(buffer);
+    if (!bufferBase || bufferBase->getMessageSize() >= maxBatchBytes)
+        flushBatch(destProcId);
+}
+
+void cParsimProtocolBase::flushBatch(int destProcId)
+{
+    if (outgoingBatches.empty())
+        return;
+    OutgoingBatch& batch = outgoingBatches[destProcId];
+    if (batch.numMessages == 0)
+        return;
+
+    batch.buffer->pack(false);
+    sendBatch(batch.buffer, destProcId);
+
+    numBatchesSent++;
+    numBatchedMessagesSent += batch.numMessages;
+    if (batch.numMessages > maxBatchLength)
+        maxBatchLength = batch.numMessages;
+
+    comm->recycleCommBuffer(batch.buffer);
+    batch.buffer = nullptr;
+    batch.numMessages = 0;
+}
+
+void cParsimProtocolBase::flushAllBatches()
+{
+    for (int i = 0; i < (int)outgoingBatches.size(); i++)
+        flushBatch(i);
+}
+
+void cParsimProtocolBase::flushOutgoingMessages()
+{
+    flushAllBatches();
+}
+
+void cParsimProtocolBase::sendBatch(cCommBuffer *buffer, int destProcId)
+{
+    comm->send(buffer, TAG_CMESSAGE_BATCH, destProcId);
+}
+
+void cParsimProtocolBase::processReceivedBatch(cCommBuffer *buffer, int sourceProcId)
+{
+    bool more;
+    buffer->unpack(more);
+    while (more) {
+        int destModuleId;
+        int destGateId;
+        buffer->unpack(destModuleId);
+        buffer->unpack(destGateId);
+        SendOptions options = unpackOptions(buffer);
+        cMessage *msg = (cMessage *)buffer->unpackObject();
+        processReceivedMessage(msg, options, destModuleId, destGateId, sourceProcId);
+        buffer->unpack(more);
+    }
+}
+
+void cParsimProtocolBase::finishBatching()
+{
+    // batches are flushed before the termination is broadcast (see flushOutgoingMessages()),
+    // so messages can only remain here if the simulation stopped with an error
+    int64_t numDiscarded = 0;
+    for (OutgoingBatch& batch : outgoingBatches) {
+        if (batch.buffer)
+            comm->recycleCommBuffer(batch.buffer);
+        numDiscarded += batch.numMessages;
+        batch.buffer = nullptr;
+        batch.numMessages = 0;
+    }
+    if (numDiscarded > 0)
+        EV_WARN << "Message batching: " << numDiscarded << " message(s) to other partitions were not sent before the end of the run, discarded\n";
+}
+
+void cParsimProtocolBase::recordBatchingScalars()
+{
+    cModule *network = sim->getSystemModule();
+    if (!network)
+        return;
+    network->recordScalar("parsim:batching:numMessages", numBatchedMessagesSent);
+    network->recordScalar("parsim:batching:numBatches", numBatchesSent);
+    if (numBatchesSent > 0) {
+        network->recordScalar("parsim:batching:meanBatchLength", (double)numBatchedMessagesSent / numBatchesSent);
+        network->recordScalar("parsim:batching:maxBatchLength", maxBatchLength);
+    }
+}
+
 void cParsimProtocolBase::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
 {
     switch (tag) {
@@ -86,6 +215,11 @@ void cParsimProtocolBase::processReceivedBuffer(cCommBuffer *buffer, int tag, in
             break;
         }
 
+        case TAG_CMESSAGE_BATCH: {
+            processReceivedBatch(buffer, sourceProcId);
+            break;
+        }
+
         default: {
             partition->processReceivedBuffer(buffer, tag, sourceProcId);
             break;
@@ -110,6 +244,9 @@ void cParsimProtocolBase::receiveNonblocking()
 
 bool cParsimProtocolBase::receiveBlocking()
 {
+    // other partitions may be waiting for our messages
+    flushAllBatches();
+
     cCommBuffer *buffer = comm->createCommBuffer();
 
     int tag, sourceProcId;
@@ -21,6 +21,7 @@
 #ifndef __OMNETPP_CPARSIMPROTOCOLBASE_H
 #define __OMNETPP_CPARSIMPROTOCOLBASE_H
 
+#include <vector>
 #include "cparsimsynchr.h"
 
 namespace omnetpp {
@@ -36,6 +37,47 @@ class cCommBuffer;
 class SIM_API cParsimProtocolBase : public cParsimSynchronizer
 {
   protected:
+    // messages collected for one destination partition (used if batching is enabled)
+    struct OutgoingBatch
+    {
+        cCommBuffer *buffer = nullptr;
+        int numMessages = 0;
+    };
+
+    // message batching: configuration
+    bool batching;           // whether to collect messages into batches
+    int maxBatchBytes;       // send the batch when it reaches this size
+
+    // message batching: state and statistics
+    std::vector<OutgoingBatch> outgoingBatches;  // indexed by procId
+    int64_t numBatchesSent = 0;
+    int64_t numBatchedMessagesSent = 0;
+    int maxBatchLength = 0;
+
+  protected:
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+
+    // adds a cMessage to the outgoing batch of the given partition; may send the batch if it is full
+    virtual void addToBatch(cMessage *msg, const SendOptions& options, int destProcId, int destModuleId, int destGateId);
+
+    // sends the outgoing batch of the given partition, if it is not empty
+    virtual void flushBatch(int destProcId);
+
+    // sends all outgoing batches; called before blocking on a receive
+    virtual void flushAllBatches();
+
+    // sends a completed batch; may be redefined to append protocol-specific data (e.g. EOT)
+    virtual void sendBatch(cCommBuffer *buffer, int destProcId);
+
+    // unpacks and processes the messages of a batch, i.e. the contents of a TAG_CMESSAGE_BATCH buffer
+    virtual void processReceivedBatch(cCommBuffer *buffer, int sourceProcId);
+
+    // deletes unsent batches, and reports them if there are any
+    virtual void finishBatching();
+
+    // records batching statistics as scalars of the network module
+    virtual void recordBatchingScalars();
+
     // process whatever comes from other partitions -- nonblocking
     virtual void receiveNonblocking();
 
@@ -65,9 +107,15 @@ class SIM_API cParsimProtocolBase : public cParsimSynchronizer
     virtual ~cParsimProtocolBase();
 
     /**
-     * Performs no optimization, just sends out the cMessage to the given partition.
+     * Sends out the cMessage to the given partition, or adds it to the
+     * partition's outgoing batch if message batching is enabled.
      */
     virtual void processOutgoingMessage(cMessage *msg, const SendOptions& options, int procId, int moduleId, int gateId, void *data) override;
+
+    /**
+     * Sends out all outgoing batches.
+     */
+    virtual void flushOutgoingMessages() override;
 };
 
 }  // namespace omnetpp
@@ -106,6 +106,14 @@ class SIM_API cParsimSynchronizer : public cScheduler
      * (see null message algorithm) on outgoing messages.
      */
     virtual void processOutgoingMessage(cMessage *msg, const SendOptions& options, int procId, int moduleId, int gateId, void *data) = 0;
+
+    /**
+     * Called before the partition notifies the other partitions that the
+     * simulation has terminated. Synchronizers that hold back outgoing
+     * messages (e.g. in batches) should send them out here. This default
+     * implementation does nothing.
+     */
+    virtual void flushOutgoingMessages() {}
 };
 
 }  // namespace omnetpp
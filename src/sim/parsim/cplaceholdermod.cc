@@ -24,6 +24,7 @@
 #include <cstdio>
 #include "cfilecomm.h"
 #include "cnamedpipecomm.h"
+#include "csocketcomm.h"
 #include "cmpicomm.h"
 #include "cnosynchronization.h"
 #include "cnullmessageprot.h"
@@ -72,6 +73,10 @@ void parsim_dummy()
 {
     cFileCommunications fc;
     cNamedPipeCommunications npc;
+#ifndef _WIN32
+    cSocketCommunications sc;
+    (void)sc;
+#endif
 #ifdef WITH_MPI
     cMPICommunications mc;
 #endif
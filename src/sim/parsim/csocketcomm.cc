@@ -0,0 +1,545 @@
+//=========================================================================
+//  CSOCKETCOMM.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "csocketcomm.h"
+
+#ifndef _WIN32
+
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#include "omnetpp/cexception.h"
+#include "omnetpp/clog.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cconfiguration.h"
+#include "cmemcommbuffer.h"
+#include "parsimutil.h"
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS  MSG_NOSIGNAL
+#else
+#define SEND_FLAGS  0
+#endif
+
+namespace omnetpp {
+
+Register_Class(cSocketCommunications);
+
+Register_GlobalConfigOption(CFGID_PARSIM_SOCKETCOMM_COORDINATOR, "parsim-socketcommunications-coordinator", CFG_STRING, "localhost:10000", "When `cSocketCommunications` is selected as parsim communications class: the address (host:port) where partition 0 accepts the connections of the other partitions at startup, and distributes the address table to them.");
+
+#define CONNECT_RETRY_MILLIS   100
+#define CONNECT_MAX_RETRIES    300   // 30s, to allow for partitions started at slightly different times
+#define READ_CHUNK_SIZE        65536
+
+struct SocketHeader
+{
+    int tag;
+    int contentLength;
+};
+
+static void writeBytes(int fd, const void *buf, size_t len, const char *what)
+{
+    size_t tot = 0;
+    while (tot < len) {
+        ssize_t n = ::send(fd, (const char *)buf+tot, len-tot, SEND_FLAGS);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            throw cRuntimeError("cSocketCommunications: Cannot send %s: %s", what, strerror(errno));
+        }
+        tot += n;
+    }
+}
+
+static void readBytes(int fd, void *buf, size_t len, const char *what)
+{
+    size_t tot = 0;
+    while (tot < len) {
+        ssize_t n = ::recv(fd, (char *)buf+tot, len-tot, 0);
+        if (n == 0)
+            throw cRuntimeError("cSocketCommunications: Cannot receive %s: Connection closed by peer", what);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            throw cRuntimeError("cSocketCommunications: Cannot receive %s: %s", what, strerror(errno));
+        }
+        tot += n;
+    }
+}
+
+static int createListenSocket(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1)
+        throw cRuntimeError("cSocketCommunications: Cannot create socket: %s", strerror(errno));
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) == -1)
+        throw cRuntimeError("cSocketCommunications: Cannot bind socket to port %d: %s", port, strerror(errno));
+    if (listen(fd, SOMAXCONN) == -1)
+        throw cRuntimeError("cSocketCommunications: Cannot listen on port %d: %s", port, strerror(errno));
+    return fd;
+}
+
+static int connectWithRetry(const sockaddr_in& addr)
+{
+    for (int k = 0; ; k++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd == -1)
+            throw cRuntimeError("cSocketCommunications: Cannot create socket: %s", strerror(errno));
+        if (connect(fd, (const sockaddr *)&addr, sizeof(addr)) == 0)
+            return fd;
+        int err = errno;
+        close(fd);
+        if ((err != ECONNREFUSED && err != EINTR) || k == CONNECT_MAX_RETRIES)
+            throw cRuntimeError("cSocketCommunications: Cannot connect to %s:%d: %s", inet_ntoa(addr.sin_addr), ntohs(addr.sin_port), strerror(err));
+        usleep(CONNECT_RETRY_MILLIS*1000);
+    }
+}
+
+cSocketCommunications::cSocketCommunications()
+{
+    std::string coordinator = getEnvir()->getConfig()->getAsString(CFGID_PARSIM_SOCKETCOMM_COORDINATOR);
+    size_t colon = coordinator.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon == coordinator.size()-1)
+        throw cRuntimeError("cSocketCommunications: Invalid coordinator address '%s', host:port expected", coordinator.c_str());
+    coordinatorHost = coordinator.substr(0, colon).c_str();
+    coordinatorPort = atoi(coordinator.c_str() + colon + 1);
+    if (coordinatorPort <= 0 || coordinatorPort > 65535)
+        throw cRuntimeError("cSocketCommunications: Invalid port in coordinator address '%s'", coordinator.c_str());
+
+    numPartitions = 0;
+    myProcId = -1;
+    numOpenPeers = 0;
+    pollFd = -1;
+}
+
+cSocketCommunications::~cSocketCommunications()
+{
+    for (auto& entry : receivedBuffers)
+        for (ReceivedBuffer& item : entry.second)
+            delete item.buffer;
+}
+
+void cSocketCommunications::init(int np)
+{
+    // store parameter
+    numPartitions = np;
+
+    // get myProcId from "-p" command-line option
+    myProcId = getProcIdFromCommandLineArgs(numPartitions, "cSocketCommunications");
+
+    EV << "cSocketCommunications: started as process " << myProcId << " out of " << numPartitions << ".\n";
+
+#ifdef __linux__
+    pollFd = epoll_create1(0);
+    if (pollFd == -1)
+        throw cRuntimeError("cSocketCommunications: Cannot create epoll instance: %s", strerror(errno));
+#endif
+
+    peers.resize(numPartitions);
+    if (myProcId == 0)
+        connectAsCoordinator();
+    else
+        connectAsPartition();
+
+    // from now on, send() must not block (see waitUntilWritable())
+    for (Peer& peer : peers) {
+        if (peer.fd != -1 && fcntl(peer.fd, F_SETFL, fcntl(peer.fd, F_GETFL) | O_NONBLOCK) == -1)
+            throw cRuntimeError("cSocketCommunications: Cannot make socket non-blocking: %s", strerror(errno));
+    }
+
+    EV << "cSocketCommunications: connected to all " << numPartitions-1 << " other partitions.\n";
+}
+
+void cSocketCommunications::connectAsCoordinator()
+{
+    EV << "cSocketCommunications: waiting for the other partitions on port " << coordinatorPort << "...\n";
+    int listenFd = createListenSocket(coordinatorPort);
+
+    // collect registrations: {numPartitions, procId, listen port} from each partition
+    std::vector<uint32_t> addressTable(2*numPartitions, 0);  // {IPv4 address, port} pairs in network byte order
+    for (int k = 1; k < numPartitions; k++) {
+        sockaddr_in peerAddr;
+        socklen_t addrLen = sizeof(peerAddr);
+        int fd = accept(listenFd, (sockaddr *)&peerAddr, &addrLen);
+        if (fd == -1)
+            throw cRuntimeError("cSocketCommunications: Cannot accept connection: %s", strerror(errno));
+
+        uint32_t registration[3];
+        readBytes(fd, registration, sizeof(registration), "registration");
+        int peerNumPartitions = ntohl(registration[0]);
+        int procId = ntohl(registration[1]);
+        if (peerNumPartitions != numPartitions)
+            throw cRuntimeError("cSocketCommunications: Partition at %s was started with a different number of partitions (%d instead of %d)",
+                    inet_ntoa(peerAddr.sin_addr), peerNumPartitions, numPartitions);
+        if (procId <= 0 || procId >= numPartitions || peers[procId].fd != -1)
+            throw cRuntimeError("cSocketCommunications: Invalid or duplicate procId=%d registered from %s", procId, inet_ntoa(peerAddr.sin_addr));
+
+        addressTable[2*procId] = peerAddr.sin_addr.s_addr;
+        addressTable[2*procId+1] = registration[2];
+        setupPeer(procId, fd);
+    }
+    close(listenFd);
+
+    // distribute the address table
+    for (int i = 1; i < numPartitions; i++)
+        writeBytes(peers[i].fd, addressTable.data(), addressTable.size()*sizeof(uint32_t), "address table");
+}
+
+void cSocketCommunications::connectAsPartition()
+{
+    // open the socket where higher procIds will connect
+    int listenFd = createListenSocket(0);
+    sockaddr_in listenAddr;
+    socklen_t addrLen = sizeof(listenAddr);
+    if (getsockname(listenFd, (sockaddr *)&listenAddr, &addrLen) == -1)
+        throw cRuntimeError("cSocketCommunications: getsockname() failed: %s", strerror(errno));
+
+    // connect to the coordinator, and register
+    addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    int err = getaddrinfo(coordinatorHost.c_str(), nullptr, &hints, &result);
+    if (err != 0)
+        throw cRuntimeError("cSocketCommunications: Cannot resolve coordinator host '%s': %s", coordinatorHost.c_str(), gai_strerror(err));
+    sockaddr_in coordinatorAddr = *(sockaddr_in *)result->ai_addr;
+    coordinatorAddr.sin_port = htons(coordinatorPort);
+    freeaddrinfo(result);
+
+    EV << "cSocketCommunications: connecting to coordinator " << coordinatorHost.c_str() << ":" << coordinatorPort << "...\n";
+    int coordinatorFd = connectWithRetry(coordinatorAddr);
+    uint32_t registration[3] = { htonl(numPartitions), htonl(myProcId), listenAddr.sin_port };
+    writeBytes(coordinatorFd, registration, sizeof(registration), "registration");
+
+    std::vector<uint32_t> addressTable(2*numPartitions);
+    readBytes(coordinatorFd, addressTable.data(), addressTable.size()*sizeof(uint32_t), "address table");
+    setupPeer(0, coordinatorFd);
+
+    // connect to lower procIds (except the coordinator), and introduce ourselves
+    for (int i = 1; i < myProcId; i++) {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = addressTable[2*i];
+        addr.sin_port = addressTable[2*i+1];
+        int fd = connectWithRetry(addr);
+        uint32_t hello = htonl(myProcId);
+        writeBytes(fd, &hello, sizeof(hello), "handshake");
+        setupPeer(i, fd);
+    }
+
+    // accept connections from higher procIds
+    for (int k = myProcId+1; k < numPartitions; k++) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd == -1)
+            throw cRuntimeError("cSocketCommunications: Cannot accept connection: %s", strerror(errno));
+        uint32_t hello;
+        readBytes(fd, &hello, sizeof(hello), "handshake");
+        int procId = ntohl(hello);
+        if (procId <= myProcId || procId >= numPartitions || peers[procId].fd != -1)
+            throw cRuntimeError("cSocketCommunications: Invalid or duplicate procId=%d in handshake", procId);
+        setupPeer(procId, fd);
+    }
+    close(listenFd);
+}
+
+void cSocketCommunications::setupPeer(int procId, int fd)
+{
+    int on = 1;
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) == -1)
+        throw cRuntimeError("cSocketCommunications: Cannot set TCP_NODELAY: %s", strerror(errno));
+#ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+#ifdef __linux__
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = procId;
+    if (epoll_ctl(pollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+        throw cRuntimeError("cSocketCommunications: epoll_ctl() failed: %s", strerror(errno));
+#endif
+
+    peers[procId].fd = fd;
+    numOpenPeers++;
+}
+
+void cSocketCommunications::shutdown()
+{
+    for (Peer& peer : peers) {
+        if (peer.fd != -1)
+            close(peer.fd);
+        peer.fd = -1;
+    }
+    numOpenPeers = 0;
+    if (pollFd != -1)
+        close(pollFd);
+    pollFd = -1;
+}
+
+int cSocketCommunications::getNumPartitions() const
+{
+    return numPartitions;
+}
+
+int cSocketCommunications::getProcId() const
+{
+    return myProcId;
+}
+
+cCommBuffer *cSocketCommunications::createCommBuffer()
+{
+    return new cMemCommBuffer();
+}
+
+void cSocketCommunications::recycleCommBuffer(cCommBuffer *buffer)
+{
+    delete buffer;
+}
+
+void cSocketCommunications::send(cCommBuffer *buffer, int tag, int destination)
+{
+    cMemCommBuffer *b = (cMemCommBuffer *)buffer;
+    if (peers[destination].fd == -1)
+        throw cRuntimeError("cSocketCommunications: Cannot send to procId=%d: Connection closed", destination);
+
+    // header and payload go out in one system call, which (with TCP_NODELAY) usually means one segment
+    SocketHeader sh;
+    sh.tag = tag;
+    sh.contentLength = b->getMessageSize();
+    iovec iov[2];
+    iov[0].iov_base = &sh;
+    iov[0].iov_len = sizeof(sh);
+    iov[1].iov_base = b->getBuffer();
+    iov[1].iov_len = sh.contentLength;
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    while (msg.msg_iovlen > 0) {
+        int fd = peers[destination].fd;
+        if (fd == -1)
+            throw cRuntimeError("cSocketCommunications: Cannot send to procId=%d: Connection closed", destination);
+        ssize_t n = sendmsg(fd, &msg, SEND_FLAGS);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                waitUntilWritable(destination);
+                continue;
+            }
+            throw cRuntimeError("cSocketCommunications: Cannot send to procId=%d: %s", destination, strerror(errno));
+        }
+        // partial write: skip what has been sent
+        while (msg.msg_iovlen > 0 && (size_t)n >= msg.msg_iov[0].iov_len) {
+            n -= msg.msg_iov[0].iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov[0].iov_base = (char *)msg.msg_iov[0].iov_base + n;
+            msg.msg_iov[0].iov_len -= n;
+        }
+    }
+}
+
+void cSocketCommunications::readFromPeer(int procId)
+{
+    Peer& peer = peers[procId];
+
+    // read everything available
+    while (true) {
+        if (peer.readBuffer.size() < peer.readLength + READ_CHUNK_SIZE)
+            peer.readBuffer.resize(peer.readLength + READ_CHUNK_SIZE);
+        ssize_t n = ::recv(peer.fd, peer.readBuffer.data() + peer.readLength, peer.readBuffer.size() - peer.readLength, MSG_DONTWAIT);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            throw cRuntimeError("cSocketCommunications: Cannot receive from procId=%d: %s", procId, strerror(errno));
+        }
+        if (n == 0) {
+            EV << "cSocketCommunications: procId=" << procId << " closed the connection.\n";
+            close(peer.fd);  // also removes it from the epoll set
+            peer.fd = -1;
+            numOpenPeers--;
+            break;
+        }
+        peer.readLength += n;
+        if ((size_t)n < READ_CHUNK_SIZE)
+            break;
+    }
+
+    // cut out complete messages, and append them to the received ones
+    size_t pos = 0;
+    while (peer.readLength - pos >= sizeof(SocketHeader)) {
+        SocketHeader sh;
+        memcpy(&sh, peer.readBuffer.data() + pos, sizeof(sh));
+        if (peer.readLength - pos - sizeof(sh) < (size_t)sh.contentLength)
+            break;
+        cMemCommBuffer *b = new cMemCommBuffer();
+        b->allocateAtLeast(sh.contentLength);
+        b->setMessageSize(sh.contentLength);
+        memcpy(b->getBuffer(), peer.readBuffer.data() + pos + sizeof(sh), sh.contentLength);
+        receivedBuffers[sh.tag].push_back({numReceivedBuffers++, procId, b});
+        pos += sizeof(sh) + sh.contentLength;
+    }
+    if (pos > 0) {
+        memmove(peer.readBuffer.data(), peer.readBuffer.data() + pos, peer.readLength - pos);
+        peer.readLength -= pos;
+    }
+}
+
+void cSocketCommunications::waitUntilWritable(int procId)
+{
+    // The destination may be blocked in send() to us as well, so read what
+    // the others send meanwhile; otherwise both sides would wait forever.
+    std::vector<pollfd> fds;
+    std::vector<int> procIds;
+    for (int i = 0; i < numPartitions; i++) {
+        if (peers[i].fd != -1) {
+            fds.push_back({peers[i].fd, (short)(i == procId ? POLLIN|POLLOUT : POLLIN), 0});
+            procIds.push_back(i);
+        }
+    }
+    int n = poll(fds.data(), fds.size(), -1);
+    if (n == -1 && errno != EINTR)
+        throw cRuntimeError("cSocketCommunications: poll() failed: %s", strerror(errno));
+    for (int k = 0; n > 0 && k < (int)fds.size(); k++)
+        if (fds[k].revents & (POLLIN|POLLHUP|POLLERR))
+            readFromPeer(procIds[k]);
+}
+
+void cSocketCommunications::pollPeers(int timeoutMillis)
+{
+#ifdef __linux__
+    epoll_event events[64];
+    int n = epoll_wait(pollFd, events, 64, timeoutMillis);
+    if (n == -1 && errno != EINTR)
+        throw cRuntimeError("cSocketCommunications: epoll_wait() failed: %s", strerror(errno));
+    for (int k = 0; k < n; k++)
+        readFromPeer(events[k].data.u32);
+#else
+    std::vector<pollfd> fds;
+    std::vector<int> procIds;
+    for (int i = 0; i < numPartitions; i++) {
+        if (peers[i].fd != -1) {
+            fds.push_back({peers[i].fd, POLLIN, 0});
+            procIds.push_back(i);
+        }
+    }
+    int n = poll(fds.data(), fds.size(), timeoutMillis);
+    if (n == -1 && errno != EINTR)
+        throw cRuntimeError("cSocketCommunications: poll() failed: %s", strerror(errno));
+    for (int k = 0; n > 0 && k < (int)fds.size(); k++)
+        if (fds[k].revents != 0)
+            readFromPeer(procIds[k]);
+#endif
+}
+
+bool cSocketCommunications::takeReceivedBuffer(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // find the queue of the tag, or with PARSIM_ANY_TAG the one that holds the earliest received buffer
+    std::deque<ReceivedBuffer> *queue = nullptr;
+    if (filtTag == PARSIM_ANY_TAG) {
+        for (auto& entry : receivedBuffers) {
+            if (!entry.second.empty() && (!queue || entry.second.front().seq < queue->front().seq)) {
+                queue = &entry.second;
+                receivedTag = entry.first;
+            }
+        }
+    }
+    else {
+        auto it = receivedBuffers.find(filtTag);
+        if (it != receivedBuffers.end() && !it->second.empty()) {
+            queue = &it->second;
+            receivedTag = filtTag;
+        }
+    }
+    if (!queue)
+        return false;
+
+    ReceivedBuffer& item = queue->front();
+    sourceProcId = item.sourceProcId;
+    ((cMemCommBuffer*)buffer)->swap(item.buffer);
+    delete item.buffer;
+    queue->pop_front();
+    return true;
+}
+
+bool cSocketCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking)
+{
+    // return one from the previously received ones, if exist
+    if (takeReceivedBuffer(filtTag, buffer, receivedTag, sourceProcId))
+        return true;
+
+    if (blocking && numOpenPeers == 0 && numPartitions > 1)
+        throw cRuntimeError("cSocketCommunications: All other partitions have closed the connection");
+
+    // receive from the sockets, and try again
+    pollPeers(blocking ? 100 : 0);  // if blocking, wait 0.1 sec
+    return takeReceivedBuffer(filtTag, buffer, receivedTag, sourceProcId);
+}
+
+bool cSocketCommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // epoll_wait()/poll() call inside receive() will block for max 0.1s, yielding CPU
+    // to other processes in the meantime
+    while (!receive(filtTag, buffer, receivedTag, sourceProcId, true)) {
+        if (getEnvir()->idle())
+            return false;
+    }
+    return true;
+}
+
+bool cSocketCommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    return receive(filtTag, buffer, receivedTag, sourceProcId, false);
+}
+
+}  // namespace omnetpp
+
+#endif /* !_WIN32 */
+
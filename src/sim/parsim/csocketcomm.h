@@ -0,0 +1,163 @@
+//=========================================================================
+//  CSOCKETCOMM.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+
+#ifndef __OMNETPP_CSOCKETCOMM_H
+#define __OMNETPP_CSOCKETCOMM_H
+
+
+#include <deque>
+#include <map>
+#include <vector>
+#include "omnetpp/simutil.h"
+#include "omnetpp/opp_string.h"
+#include "omnetpp/cparsimcomm.h"
+
+namespace omnetpp {
+
+class cMemCommBuffer;
+
+/**
+ * @brief Implementation of the communications layer which uses TCP
+ * connections. Partitions may run on the same host, or on different hosts.
+ *
+ * At initialization time, partition 0 acts as coordinator: it listens on
+ * the address given in the <tt>parsim-socketcommunications-coordinator</tt>
+ * configuration option, and the other partitions connect to it and register
+ * the port they listen on. When all partitions have registered, the
+ * coordinator sends the address table to everyone, and the partitions set
+ * up a full mesh of connections (partitions connect to the ones with lower
+ * procIds). The connections to the coordinator are kept as the connections
+ * to partition 0.
+ *
+ * Connections use TCP_NODELAY, messages are sent with a single vectored
+ * write for header and payload, and incoming data is collected from all
+ * connections with epoll (poll() on non-Linux systems). After the rendezvous,
+ * the sockets are non-blocking: when a connection cannot take more data,
+ * send() waits until it can, and meanwhile reads and queues the data arriving
+ * from all connections. This way, partitions sending large amounts of data
+ * to each other at the same time do not deadlock. Not available on Windows.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cSocketCommunications : public cParsimCommunications
+{
+  protected:
+    int numPartitions;
+    int myProcId;
+
+    // coordinator address
+    opp_string coordinatorHost;
+    int coordinatorPort;
+
+    // connections to other partitions, indexed by procId
+    struct Peer {
+        int fd = -1;
+        std::vector<char> readBuffer;  // data received but not yet assembled into messages
+        size_t readLength = 0;
+    };
+    std::vector<Peer> peers;
+    int numOpenPeers;
+    int pollFd;  // epoll fd on Linux
+
+    // received messages, per tag; doubles as reordering buffer needed because of tag filtering support (filtTag).
+    // Sequence numbers preserve the order of arrival across tags, for receiving with PARSIM_ANY_TAG.
+    struct ReceivedBuffer {uint64_t seq; int sourceProcId; cMemCommBuffer *buffer;};
+    std::map<int, std::deque<ReceivedBuffer>> receivedBuffers;
+    uint64_t numReceivedBuffers = 0;
+
+  protected:
+    // rendezvous
+    virtual void connectAsCoordinator();
+    virtual void connectAsPartition();
+    virtual void setupPeer(int procId, int fd);
+
+    // common impl. for receiveBlocking() and receiveNonblocking()
+    bool receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking);
+    bool takeReceivedBuffer(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+    void pollPeers(int timeoutMillis);
+    void readFromPeer(int procId);
+    void waitUntilWritable(int procId);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cSocketCommunications();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cSocketCommunications();
+
+    /** @name Redefined methods from cParsimCommunications */
+    //@{
+    /**
+     * Init the library. Here we perform the rendezvous and open the
+     * connections to the other partitions.
+     */
+    virtual void init(int numPartitions) override;
+
+    /**
+     * Shutdown the communications library. Closes the connections.
+     */
+    virtual void shutdown() override;
+
+    /**
+     * Returns total number of partitions.
+     */
+    virtual int getNumPartitions() const override;
+
+    /**
+     * Returns the id of this partition.
+     */
+    virtual int getProcId() const override;
+
+    /**
+     * Creates an empty buffer of type cMemCommBuffer.
+     */
+    virtual cCommBuffer *createCommBuffer() override;
+
+    /**
+     * Recycle communication buffer after use.
+     */
+    virtual void recycleCommBuffer(cCommBuffer *buffer) override;
+
+    /**
+     * Sends packed data with given tag to destination.
+     */
+    virtual void send(cCommBuffer *buffer, int tag, int destination) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Normally returns true; false is returned if blocking was interrupted by the user.
+     */
+    virtual bool receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Call is non-blocking -- it returns true if something has been
+     * received, false otherwise.
+     */
+    virtual bool receiveNonblocking(int filtTag, cCommBuffer *buffer,  int& receivedTag, int& sourceProcId) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
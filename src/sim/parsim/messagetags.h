@@ -31,7 +31,9 @@ enum {
      TAG_NULLMESSAGE,
      TAG_CMESSAGE_WITH_NULLMESSAGE,
      TAG_TERMINATIONEXCEPTION,
-     TAG_EXCEPTION
+     TAG_EXCEPTION,
+     TAG_CMESSAGE_BATCH,
+     TAG_CMESSAGE_BATCH_WITH_NULLMESSAGE
 };
 
 #endif
@@ -39,7 +39,7 @@
  *    of a program that executes in parallel, and hides details of
  *    the communications library (MPI, PVM, ...). Subclasses implemented
  *    here are cMPICommunications, cNamedPipeCommunications,
- *    cFileCommunications.
+ *    cSocketCommunications, cFileCommunications.
  *    -# Partition layer, represented by cParsimPartition. This encapsulates
  *    the task of distributing the simulation model over several
  *    partitions, and handles messaging between these partitions.
@@ -22,6 +22,7 @@
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cpsquare.h"
 #include "omnetpp/cksplit.h"
+#include "omnetpp/cquantilesketch.h"
 #include "omnetpp/resultrecorders.h"
 #include "common/stringutil.h"
 
@@ -121,6 +122,14 @@ Register_ResultRecorder2("ksplit", KSplitRecorder,
         SIGNALTYPE_TO_NUMERIC_CONVERSIONS
         OPTIONALLY_TIMEWEIGHTED
 );
+Register_ResultRecorder2("quantiles", QuantilesRecorder,
+        "Records the distribution of the input values as a mergeable quantile sketch with "
+        "bounded relative error (cQuantileSketch class), in the form of a histogram. The relative "
+        "accuracy and the maximum number of bins can be specified with the 'relativeAccuracy' "
+        "(default: 0.01) and 'maxBins' (default: 2048) attributes in the @statistic property. "
+        SIGNALTYPE_TO_NUMERIC_CONVERSIONS
+        OPTIONALLY_TIMEWEIGHTED
+);
 
 VectorRecorder::~VectorRecorder()
 {
@@ -442,6 +451,7 @@ void StatisticsRecorder::finish(cResultFilter *prev)
         statistic->collectWeighted(lastValue, simTime() - lastTime);
 
     opp_string_map attributes = getStatisticAttributes();
+    statistic->getAttributesToRecord(attributes);
     getEnvir()->recordStatistic(getComponent(), getResultName().c_str(), statistic, &attributes);
 }
 
@@ -464,6 +474,12 @@ inline int getIntAttr(const opp_string_map& attrs, const char *name, int default
     return it == attrs.end() ? defaultValue : opp_atol(it->second.c_str());
 }
 
+inline double getDoubleAttr(const opp_string_map& attrs, const char *name, double defaultValue)
+{
+    auto it = attrs.find(name);
+    return it == attrs.end() ? defaultValue : opp_atof(it->second.c_str());
+}
+
 void StatsRecorder::init(cComponent *component, const char *statsName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs)
 {
     StatisticsRecorder::init(component, statsName, recordingMode, attrsProperty, manualAttrs);
@@ -518,5 +534,14 @@ void KSplitRecorder::init(cComponent *component, const char *statsName, const ch
     setStatistic(new cKSplit("ksplit"));
 }
 
+void QuantilesRecorder::init(cComponent *component, const char *statsName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs)
+{
+    StatisticsRecorder::init(component, statsName, recordingMode, attrsProperty, manualAttrs);
+    bool weighted = getBoolAttr(getStatisticAttributes(), "timeWeighted", false);
+    double relativeAccuracy = getDoubleAttr(getStatisticAttributes(), "relativeAccuracy", 0.01);
+    int maxBins = getIntAttr(getStatisticAttributes(), "maxBins", 2048);
+    setStatistic(new cQuantileSketch("quantiles", relativeAccuracy, maxBins, weighted));
+}
+
 }  // namespace omnetpp
 
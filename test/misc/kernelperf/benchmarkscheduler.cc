@@ -0,0 +1,79 @@
+//
+// A sequential scheduler that also measures the simulation: wall-clock time
+// of network setup, initialization and the event loop, the number of events,
+// and the peak resident set size of the process. The results are printed
+// as a CSV line prefixed with "kernelperf: " when the event loop ends.
+//
+// Select it with scheduler-class = BenchmarkScheduler.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <omnetpp.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace omnetpp;
+
+class BenchmarkScheduler : public cSequentialScheduler
+{
+  protected:
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point setupStart, setupEnd, initStart, initEnd, runStart;
+    eventnumber_t startEventNumber = 0;
+
+  protected:
+    static double seconds(Clock::time_point from, Clock::time_point to) {return std::chrono::duration<double>(to - from).count();}
+    static long getPeakRSS();
+    void report();
+
+  public:
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+};
+
+Register_Class(BenchmarkScheduler);
+
+void BenchmarkScheduler::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    cSequentialScheduler::lifecycleEvent(eventType, details);
+
+    switch (eventType) {
+        case LF_PRE_NETWORK_SETUP: setupStart = Clock::now(); break;
+        case LF_POST_NETWORK_SETUP: setupEnd = Clock::now(); break;
+        case LF_PRE_NETWORK_INITIALIZE: initStart = Clock::now(); break;
+        case LF_POST_NETWORK_INITIALIZE: initEnd = Clock::now(); break;
+        case LF_ON_SIMULATION_START:
+            runStart = Clock::now();
+            startEventNumber = sim->getEventNumber();
+            break;
+        case LF_PRE_NETWORK_FINISH: report(); break;
+        default: break;
+    }
+}
+
+long BenchmarkScheduler::getPeakRSS()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;  // in kilobytes on Linux
+#endif
+    return -1;
+}
+
+void BenchmarkScheduler::report()
+{
+    double runTime = seconds(runStart, Clock::now());
+    eventnumber_t numEvents = sim->getEventNumber() - startEventNumber;
+    const char *configName = getEnvir()->getConfigEx()->getActiveConfigName();
+
+    printf("kernelperf: %s,%" PRId64 ",%.6f,%.6f,%.6f,%.0f,%.1f,%ld\n",
+            configName, (int64_t)numEvents,
+            seconds(setupStart, setupEnd), seconds(initStart, initEnd), runTime,
+            runTime > 0 ? numEvents / runTime : 0.0,
+            numEvents > 0 ? runTime * 1e9 / numEvents : 0.0,
+            getPeakRSS());
+    fflush(stdout);
+}
@@ -0,0 +1,312 @@
+//
+// Simple modules of the kernel performance benchmark models.
+//
+
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+class HoldModel : public cSimpleModule
+{
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+Define_Module(HoldModel);
+
+void HoldModel::initialize()
+{
+    int numTimers = par("numTimers");
+    for (int i = 0; i < numTimers; i++)
+        scheduleAt(par("holdTime"), new cMessage("timer"));
+}
+
+void HoldModel::handleMessage(cMessage *msg)
+{
+    scheduleAt(simTime() + par("holdTime"), msg);
+}
+
+//----
+
+class Emitter : public cSimpleModule
+{
+  protected:
+    simsignal_t valueSignal;
+    simsignal_t countSignal;
+    int numEmits;
+    intval_t count = 0;
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+Define_Module(Emitter);
+
+void Emitter::initialize()
+{
+    valueSignal = registerSignal("value");
+    countSignal = registerSignal("count");
+    numEmits = par("numEmits");
+    scheduleAt(par("interval"), new cMessage("timer"));
+}
+
+void Emitter::handleMessage(cMessage *msg)
+{
+    for (int i = 0; i < numEmits; i++) {
+        emit(valueSignal, i * 0.5);
+        emit(countSignal, ++count);
+    }
+    scheduleAt(simTime() + par("interval"), msg);
+}
+
+class SignalSink : public cSimpleModule, public cListener
+{
+  protected:
+    long numSignals = 0;
+    double sum = 0;
+
+  protected:
+    virtual void initialize() override;
+    virtual void finish() override;
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, double d, cObject *details) override;
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, intval_t i, cObject *details) override;
+};
+
+Define_Module(SignalSink);
+
+void SignalSink::initialize()
+{
+    getParentModule()->subscribe("value", this);
+    getParentModule()->subscribe("count", this);
+}
+
+void SignalSink::finish()
+{
+    EV << "signals received: " << numSignals << endl;
+}
+
+void SignalSink::receiveSignal(cComponent *source, simsignal_t signalID, double d, cObject *details)
+{
+    numSignals++;
+    sum += d;
+}
+
+void SignalSink::receiveSignal(cComponent *source, simsignal_t signalID, intval_t i, cObject *details)
+{
+    numSignals++;
+    sum += i;
+}
+
+//----
+
+class Relay : public cSimpleModule
+{
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+Define_Module(Relay);
+
+void Relay::initialize()
+{
+    int numTokens = par("numTokens");
+    for (int i = 0; i < numTokens; i++)
+        send(new cMessage("token"), "out");
+}
+
+void Relay::handleMessage(cMessage *msg)
+{
+    send(msg, "out");
+}
+
+//----
+
+class App : public cSimpleModule
+{
+  protected:
+    int payloadLength;
+    long numReceived = 0;
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+};
+
+Define_Module(App);
+
+void App::initialize()
+{
+    payloadLength = par("payloadLength");
+    int numFlows = par("numFlows");
+    for (int i = 0; i < numFlows; i++)
+        scheduleAt(par("interval"), new cMessage("timer"));
+}
+
+void App::handleMessage(cMessage *msg)
+{
+    if (msg->isSelfMessage()) {
+        cPacket *pk = new cPacket("data");
+        pk->setByteLength(payloadLength);
+        send(pk, "out");
+        scheduleAt(simTime() + par("interval"), msg);
+    }
+    else {
+        numReceived++;
+        delete msg;
+    }
+}
+
+void App::finish()
+{
+    EV << "packets received: " << numReceived << endl;
+}
+
+class Layer : public cSimpleModule
+{
+  protected:
+    int headerLength;
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+Define_Module(Layer);
+
+void Layer::initialize()
+{
+    headerLength = par("headerLength");
+}
+
+void Layer::handleMessage(cMessage *msg)
+{
+    cPacket *pk = check_and_cast<cPacket *>(msg);
+    if (pk->arrivedOn("upperIn")) {
+        cPacket *frame = new cPacket("pdu");
+        frame->setByteLength(headerLength);
+        frame->encapsulate(pk);
+        send(frame, "lowerOut");
+    }
+    else {
+        cPacket *payload = pk->decapsulate();
+        delete pk;
+        send(payload, "upperOut");
+    }
+}
+
+class Loopback : public cSimpleModule
+{
+  protected:
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+Define_Module(Loopback);
+
+void Loopback::handleMessage(cMessage *msg)
+{
+    send(msg->dup(), "out");
+    delete msg;
+}
+
+//----
+
+class VectorWriter : public cSimpleModule
+{
+  protected:
+    std::vector<cOutVector *> vectors;
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+
+  public:
+    virtual ~VectorWriter();
+};
+
+Define_Module(VectorWriter);
+
+VectorWriter::~VectorWriter()
+{
+    for (cOutVector *vector : vectors)
+        delete vector;
+}
+
+void VectorWriter::initialize()
+{
+    int numVectors = par("numVectors");
+    for (int i = 0; i < numVectors; i++) {
+        std::string name = "vector-" + std::to_string(i);
+        vectors.push_back(new cOutVector(name.c_str()));
+    }
+    scheduleAt(par("interval"), new cMessage("timer"));
+}
+
+void VectorWriter::handleMessage(cMessage *msg)
+{
+    double value = dblrand();
+    for (cOutVector *vector : vectors)
+        vector->record(value);
+    scheduleAt(simTime() + par("interval"), msg);
+}
+
+//----
+
+class Logger : public cSimpleModule
+{
+  protected:
+    int numLogs;
+    long count = 0;
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+Define_Module(Logger);
+
+void Logger::initialize()
+{
+    numLogs = par("numLogs");
+    scheduleAt(par("interval"), new cMessage("timer"));
+}
+
+void Logger::handleMessage(cMessage *msg)
+{
+    for (int i = 0; i < numLogs; i++) {
+        EV_DETAIL << "Processing item " << i << " of " << msg->getName() << ", count=" << ++count << endl;
+        EV_DEBUG << "Item " << i << " done at t=" << simTime() << endl;
+    }
+    scheduleAt(simTime() + par("interval"), msg);
+}
+
+//----
+
+class ParamHolder : public cSimpleModule
+{
+  protected:
+    double checksum = 0;
+
+  protected:
+    virtual void initialize() override;
+};
+
+Define_Module(ParamHolder);
+
+void ParamHolder::initialize()
+{
+    for (int i = 0; i < getNumParams(); i++) {
+        cPar& p = par(i);
+        switch (p.getType()) {
+            case cPar::BOOL: checksum += p.boolValue(); break;
+            case cPar::INT: checksum += p.intValue(); break;
+            case cPar::DOUBLE: checksum += p.doubleValue(); break;
+            case cPar::STRING: checksum += p.stdstringValue().size(); break;
+            case cPar::XML: checksum += p.xmlValue()->getChildren().size(); break;
+            default: break;
+        }
+    }
+}
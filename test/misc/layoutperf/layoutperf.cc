@@ -0,0 +1,142 @@
+//=========================================================================
+//  LAYOUTPERF.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+//
+// Measures the performance of ForceDirectedGraphLayouter on random sparse
+// graphs of a few thousand nodes, with pairwise electric repulsion and with
+// the Barnes-Hut approximation.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <utility>
+#include "layout/forcedirectedgraphlayouter.h"
+
+using namespace omnetpp::layout;
+
+static double now()
+{
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+// stops the layouter after a fixed number of cycles, so that timings are comparable
+class CycleLimitedEnvironment : public BasicGraphLayouterEnvironment
+{
+  public:
+    int maxCycles;
+    int cycles = 0;
+
+    CycleLimitedEnvironment(int maxCycles) : maxCycles(maxCycles) {}
+    virtual bool okToProceed() override { return cycles++ < maxCycles; }
+};
+
+struct Graph {
+    int numNodes;
+    std::vector<std::pair<int,int>> edges;
+};
+
+// a random spanning tree plus numNodes/2 random extra edges
+static Graph generateGraph(int numNodes, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    Graph graph;
+    graph.numNodes = numNodes;
+    for (int i = 1; i < numNodes; i++)
+        graph.edges.push_back(std::make_pair(std::uniform_int_distribution<int>(0, i-1)(rng), i));
+    for (int i = 0; i < numNodes / 2; i++) {
+        int a = std::uniform_int_distribution<int>(0, numNodes-1)(rng);
+        int b = std::uniform_int_distribution<int>(0, numNodes-1)(rng);
+        if (a != b)
+            graph.edges.push_back(std::make_pair(a, b));
+    }
+    return graph;
+}
+
+struct Result {
+    double seconds;
+    int cycles;
+    double meanEdgeLength;
+    double meanNearestDistance;
+};
+
+static Result layout(const Graph& graph, bool barnesHut, int maxCycles)
+{
+    ForceDirectedGraphLayouter layouter;
+    layouter.setSeed(1);
+    layouter.setSize(0, 0, 30);
+
+    CycleLimitedEnvironment environment(maxCycles);
+    environment.addParameter("bhn", barnesHut ? 0 : 1e9);
+    environment.addParameter("pe", 0);     // no pre-embedding
+    environment.addParameter("3df", 0);    // no 3D
+    environment.addParameter("mct", 1e9);  // no time limit, only the cycle limit
+    layouter.setEnvironment(&environment);
+
+    for (int i = 0; i < graph.numNodes; i++)
+        layouter.addMovableNode(i, 40, 40);
+    for (auto& edge : graph.edges)
+        layouter.addEdge(edge.first, edge.second);
+
+    double start = now();
+    layouter.execute();
+    double seconds = now() - start;
+
+    std::vector<double> x(graph.numNodes), y(graph.numNodes);
+    for (int i = 0; i < graph.numNodes; i++)
+        layouter.getNodePosition(i, x[i], y[i]);
+
+    Result result;
+    result.seconds = seconds;
+    result.cycles = environment.cycles - 1;
+    result.meanEdgeLength = 0;
+    for (auto& edge : graph.edges)
+        result.meanEdgeLength += std::hypot(x[edge.first] - x[edge.second], y[edge.first] - y[edge.second]);
+    result.meanEdgeLength /= graph.edges.size();
+    result.meanNearestDistance = 0;
+    for (int i = 0; i < graph.numNodes; i++) {
+        double nearest = INFINITY;
+        for (int j = 0; j < graph.numNodes; j++)
+            if (i != j)
+                nearest = std::min(nearest, std::hypot(x[i] - x[j], y[i] - y[j]));
+        result.meanNearestDistance += nearest;
+    }
+    result.meanNearestDistance /= graph.numNodes;
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int maxNodes = argc > 1 ? atoi(argv[1]) : 4000;
+    int maxExactNodes = argc > 2 ? atoi(argv[2]) : 2000;
+    int maxCycles = argc > 3 ? atoi(argv[3]) : 20;
+
+    printf("%-8s %-10s %8s %10s %12s %10s %10s\n", "nodes", "repulsion", "cycles", "total[s]", "percycle[ms]", "edgelen", "nearest");
+    for (int numNodes = 250; numNodes <= maxNodes; numNodes *= 2) {
+        Graph graph = generateGraph(numNodes, numNodes);
+        for (bool barnesHut : {false, true}) {
+            if (!barnesHut && numNodes > maxExactNodes)
+                continue;
+            Result r = layout(graph, barnesHut, maxCycles);
+            printf("%-8d %-10s %8d %10.3f %12.2f %10.1f %10.1f\n", numNodes, barnesHut ? "barneshut" : "pairwise",
+                    r.cycles, r.seconds, r.cycles ? 1000 * r.seconds / r.cycles : 0.0, r.meanEdgeLength, r.meanNearestDistance);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <omnetpp.h>
+#include "packperf_m.h"
+
+using namespace omnetpp;
+
+/**
+ * Measures parsimPack()/parsimUnpack() round-trip time for generated
+ * message classes, with and without the compact layout.
+ */
+class PackPerf : public cSimpleModule
+{
+  protected:
+    template<typename T> void fill(T *pk);
+    template<typename T> double measure(const char *label);
+    virtual void initialize() override;
+};
+
+Define_Module(PackPerf);
+
+template<typename T>
+void PackPerf::fill(T *pk)
+{
+    pk->setI0(intrand(1000));
+    pk->setI15(intrand(1000));
+    pk->setD0(dblrand());
+    pk->setD15(dblrand());
+    pk->setB7(true);
+    for (int k = 0; k < 256; k++)
+        pk->setPayload(k, k);
+    for (int k = 0; k < 64; k++)
+        pk->setSamples(k, k * 0.5);
+}
+
+template<typename T>
+double PackPerf::measure(const char *label)
+{
+    int numPackets = par("numPackets");
+    int batchSize = par("batchSize");
+
+    T pk;
+    fill(&pk);
+    std::vector<T> received(batchSize);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int done = 0; done < numPackets; done += batchSize) {
+        cCommBuffer *buffer = check_and_cast<cCommBuffer *>(createOne("omnetpp::cMemCommBuffer"));
+        for (int i = 0; i < batchSize; i++)
+            pk.parsimPack(buffer);
+        for (int i = 0; i < batchSize; i++)
+            received[i].parsimUnpack(buffer);
+        buffer->assertBufferEmpty();
+        delete buffer;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const T& last = received.back();
+    if (last.getI0() != pk.getI0() || last.getD15() != pk.getD15() || last.getPayload(255) != pk.getPayload(255) || last.getSamples(63) != pk.getSamples(63))
+        throw cRuntimeError("%s: Round-trip mismatch", label);
+
+    EV_INFO << label << ": " << numPackets << " round-trips in " << seconds << "s, " << (1e9 * seconds / numPackets) << "ns/packet\n";
+    return seconds;
+}
+
+void PackPerf::initialize()
+{
+    double fieldwise = measure<FieldwisePacket>("field-by-field");
+    double compact = measure<CompactPacket>("compact");
+    EV_INFO << "speedup: " << fieldwise / compact << "x\n";
+}
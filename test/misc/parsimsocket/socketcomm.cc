@@ -0,0 +1,92 @@
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+/**
+ * Exchanges messages between all pairs of partitions over
+ * cSocketCommunications, and checks that every message arrives exactly
+ * once, in the order it was sent, and with its content intact, also when
+ * messages are received with a tag filter. Every process runs one
+ * partition; the partition is selected with the -p<procId> switch.
+ */
+class SocketCommTest : public cSimpleModule
+{
+  protected:
+    enum {TAG_EVEN = 100, TAG_ODD = 101};
+    cParsimCommunications *comm = nullptr;
+    std::vector<int> expected;  // per source: sequence number of the next message
+  protected:
+    static int getPayloadSize(int seq) {return (seq * 37) % 5000;}
+    void receive(int filterTag, int count);
+    virtual void initialize() override;
+};
+
+Define_Module(SocketCommTest);
+
+void SocketCommTest::receive(int filterTag, int count)
+{
+    cCommBuffer *buffer = comm->createCommBuffer();
+    std::vector<char> payload;
+    for (int received = 0; received < count; ) {
+        int tag, source;
+        if (!comm->receiveBlocking(filterTag, buffer, tag, source))
+            continue;
+        int seq, size;
+        buffer->unpack(seq);
+        buffer->unpack(size);
+        if (seq != expected[source] || tag != (seq % 2 ? TAG_ODD : TAG_EVEN) || size != getPayloadSize(seq))
+            throw cRuntimeError("Wrong message from partition %d: seq=%d tag=%d size=%d, expected seq=%d", source, seq, tag, size, expected[source]);
+        payload.resize(size);
+        buffer->unpack(payload.data(), size);
+        buffer->assertBufferEmpty();
+        for (int i = 0; i < size; i++)
+            if (payload[i] != (char)(seq + i))
+                throw cRuntimeError("Corrupt payload in message %d from partition %d", seq, source);
+        expected[source] += 2;
+        received++;
+    }
+    comm->recycleCommBuffer(buffer);
+}
+
+void SocketCommTest::initialize()
+{
+    int numPartitions = par("numPartitions");
+    int numMessages = par("numMessages");
+
+    comm = check_and_cast<cParsimCommunications *>(createOne("omnetpp::cSocketCommunications"));
+    comm->init(numPartitions);
+    int myProcId = comm->getProcId();
+
+    // send messages of varying size to every other partition, with alternating tags
+    std::vector<char> payload;
+    for (int seq = 0; seq < numMessages; seq++) {
+        int size = getPayloadSize(seq);
+        payload.resize(size);
+        for (int i = 0; i < size; i++)
+            payload[i] = (char)(seq + i);
+        for (int dest = 0; dest < numPartitions; dest++) {
+            if (dest == myProcId)
+                continue;
+            cCommBuffer *buffer = comm->createCommBuffer();
+            buffer->pack(seq);
+            buffer->pack(size);
+            buffer->pack(payload.data(), size);
+            comm->send(buffer, seq % 2 ? TAG_ODD : TAG_EVEN, dest);
+            comm->recycleCommBuffer(buffer);
+        }
+    }
+
+    // receive the even-numbered messages with a tag filter first (the odd
+    // ones are queued meanwhile), then the rest without a filter
+    int numEven = (numMessages + 1) / 2;
+    expected.assign(numPartitions, 0);
+    receive(TAG_EVEN, numEven * (numPartitions - 1));
+    expected.assign(numPartitions, 1);
+    receive(PARSIM_ANY_TAG, (numMessages - numEven) * (numPartitions - 1));
+
+    EV_INFO << "partition " << myProcId << ": OK, received " << numMessages * (numPartitions - 1) << " messages\n";
+
+    comm->shutdown();
+    delete comm;
+    comm = nullptr;
+}
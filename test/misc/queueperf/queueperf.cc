@@ -0,0 +1,120 @@
+//
+// Micro-benchmark for cQueue and cPacketQueue. The queue is filled up to
+// queueLength packets, then numOps operations are performed, each removing
+// a packet and inserting a new one, so that the queue length stays constant.
+// The mode parameter selects the workload:
+//
+//   fifo         cQueue without comparator: insert() at the back, pop()
+//   priority     cQueue with a comparator on the packets' priority, with
+//                numPriorities distinct priorities: insert(), pop()
+//   packetqueue  cPacketQueue with the same comparator, also exercising the
+//                bit length bookkeeping
+//   remove       cQueue without comparator: insert(), then remove() of a
+//                random packet
+//
+// The result is printed as a CSV line prefixed with "queueperf: ".
+//
+
+#include <chrono>
+#include <vector>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+class QueuePerf : public cSimpleModule
+{
+  protected:
+    typedef std::chrono::steady_clock Clock;
+    int numPriorities;
+
+  protected:
+    virtual void initialize() override;
+    cPacket *createPacket();
+    double runFifo(cQueue& queue, int queueLength, long numOps);
+    double runRemove(cQueue& queue, int queueLength, long numOps);
+};
+
+Define_Module(QueuePerf);
+
+static int compareByPriority(cObject *a, cObject *b)
+{
+    return static_cast<cPacket *>(a)->getSchedulingPriority() - static_cast<cPacket *>(b)->getSchedulingPriority();
+}
+
+cPacket *QueuePerf::createPacket()
+{
+    cPacket *pkt = new cPacket("pkt", 0, 8 * intuniform(64, 1500));
+    pkt->setSchedulingPriority(intrand(numPriorities));
+    return pkt;
+}
+
+double QueuePerf::runFifo(cQueue& queue, int queueLength, long numOps)
+{
+    for (int i = 0; i < queueLength; i++)
+        queue.insert(createPacket());
+
+    // pre-create packets, so that we only measure the queue operations
+    std::vector<cPacket *> packets(numOps);
+    for (long i = 0; i < numOps; i++)
+        packets[i] = createPacket();
+
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < numOps; i++) {
+        delete queue.pop();
+        queue.insert(packets[i]);
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double QueuePerf::runRemove(cQueue& queue, int queueLength, long numOps)
+{
+    std::vector<cPacket *> contents;
+    for (int i = 0; i < queueLength; i++) {
+        contents.push_back(createPacket());
+        queue.insert(contents.back());
+    }
+    std::vector<int> indices(numOps);
+    for (long i = 0; i < numOps; i++)
+        indices[i] = intrand(queueLength);
+
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < numOps; i++) {
+        cPacket *pkt = contents[indices[i]];
+        queue.remove(pkt);
+        queue.insert(pkt);
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void QueuePerf::initialize()
+{
+    std::string mode = par("mode").stdstringValue();
+    int queueLength = par("queueLength");
+    long numOps = par("numOps").intValue();
+    numPriorities = par("numPriorities");
+
+    double elapsed;
+    if (mode == "fifo") {
+        cQueue queue("queue");
+        elapsed = runFifo(queue, queueLength, numOps);
+    }
+    else if (mode == "priority") {
+        cQueue queue("queue", compareByPriority);
+        elapsed = runFifo(queue, queueLength, numOps);
+    }
+    else if (mode == "packetqueue") {
+        cPacketQueue queue("queue", compareByPriority);
+        elapsed = runFifo(queue, queueLength, numOps);
+        if (queue.getLength() != queueLength)
+            throw cRuntimeError("Wrong queue length");
+    }
+    else if (mode == "remove") {
+        cQueue queue("queue");
+        elapsed = runRemove(queue, queueLength, numOps);
+    }
+    else
+        throw cRuntimeError("Unknown mode '%s'", mode.c_str());
+
+    printf("queueperf: %s,%d,%ld,%.3f,%.1f\n", mode.c_str(), queueLength, numOps, elapsed, elapsed / numOps * 1e9);
+    fflush(stdout);
+}
@@ -0,0 +1,135 @@
+//=========================================================================
+//  FILTERPERF.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+//
+// Measures the performance of ResultFileManager::filterIDList() with filter
+// expressions on a synthetic result set, and checks the result against
+// item-by-item evaluation of the same expression via MatchExpression.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include "common/matchexpression.h"
+#include "scave/resultfilemanager.h"
+
+using namespace omnetpp::common;
+using namespace omnetpp::scave;
+
+static double now()
+{
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+// generates numRuns * numHosts * numApps * numNames scalars
+static void generateScalarFile(const char *fileName, int numRuns, int numHosts, int numApps, int numNames)
+{
+    FILE *f = fopen(fileName, "w");
+    if (!f) {
+        perror(fileName);
+        exit(1);
+    }
+    fprintf(f, "version 3\n");
+    for (int r = 0; r < numRuns; r++) {
+        fprintf(f, "run General-%d-20200101-00:00:00-%d\n", r, r);
+        fprintf(f, "attr configname General\n");
+        fprintf(f, "attr network Net\n");
+        fprintf(f, "attr repetition %d\n", r);
+        fprintf(f, "itervar numHosts %d\n", numHosts);
+        fprintf(f, "\n");
+        for (int h = 0; h < numHosts; h++)
+            for (int a = 0; a < numApps; a++)
+                for (int n = 0; n < numNames; n++)
+                    fprintf(f, "scalar Net.host[%d].app[%d] %s:%s %d\n", h, a, (n%2 ? "rtt" : "delay"), (n<2 ? "mean" : n<4 ? "max" : "count"), h+a+n);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+}
+
+// reference implementation: evaluates the expression item by item
+class MatchableResultItem : public MatchExpression::Matchable
+{
+    private:
+        const ResultFileManager *manager;
+        ID id;
+    public:
+        MatchableResultItem(const ResultFileManager *manager, ID id) : manager(manager), id(id) {}
+        virtual const char *getAsString() const override { return manager->getItemProperty(id, "name"); }
+        virtual const char *getAsString(const char *attribute) const override { return manager->getItemProperty(id, attribute); }
+};
+
+static IDList filterItemByItem(const ResultFileManager& manager, const IDList& idlist, const char *pattern)
+{
+    MatchExpression matchExpr(pattern, false, true, true);
+    std::vector<ID> out;
+    for (ID id : idlist) {
+        MatchableResultItem matchable(&manager, id);
+        if (matchExpr.matches(&matchable))
+            out.push_back(id);
+    }
+    return IDList(std::move(out));
+}
+
+int main(int argc, char **argv)
+{
+    int numRuns = argc > 1 ? atoi(argv[1]) : 10;
+    int numHosts = argc > 2 ? atoi(argv[2]) : 2000;
+    const char *fileName = "filterperf.sca";
+
+    const char *patterns[] = {
+        "module =~ **.host[*].app[*] AND name =~ rtt:*",
+        "module =~ **.host[1..99].app[0] AND name =~ *:mean",
+        "name =~ delay:* OR name =~ rtt:max",
+        "runattr:repetition =~ 3 AND NOT name =~ *:count",
+        "itervar:numHosts =~ {1000..} AND module =~ Net.host[5*].**",
+        nullptr
+    };
+
+    double t0 = now();
+    generateScalarFile(fileName, numRuns, numHosts, 5, 10);
+    double t1 = now();
+
+    ResultFileManager manager;
+    manager.loadFile(fileName, fileName, ResultFileManager::LOADFLAGS_DEFAULTS, nullptr);
+    IDList scalars = manager.getAllScalars();
+    double t2 = now();
+    printf("generated %d scalars in %.3fs, loaded in %.3fs\n\n", scalars.size(), t1-t0, t2-t1);
+
+    bool ok = true;
+    printf("%-60s %10s %12s %12s %8s\n", "filter", "matches", "per-item[s]", "compiled[s]", "speedup");
+    for (int i = 0; patterns[i]; i++) {
+        const char *pattern = patterns[i];
+
+        double ta = now();
+        IDList expected = filterItemByItem(manager, scalars, pattern);
+        double tb = now();
+        IDList actual = manager.filterIDList(scalars, pattern);
+        double tc = now();
+
+        bool same = expected.size() == actual.size();
+        for (int k = 0; same && k < actual.size(); k++)
+            same = expected.get(k) == actual.get(k);
+        if (!same)
+            ok = false;
+
+        printf("%-60s %10d %12.3f %12.3f %7.1fx%s\n", pattern, actual.size(), tb-ta, tc-tb, (tb-ta)/(tc-tb), same ? "" : "  MISMATCH");
+    }
+
+    remove(fileName);
+    printf("\n%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}